@@ -0,0 +1,181 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "nvCVBinaryLog.h"
+
+#ifdef _MSC_VER
+#define strcasecmp _stricmp
+#endif /* _MSC_VER */
+
+bool FLAG_utc = false;
+bool FLAG_threads = true;
+unsigned FLAG_logLevel = 3;
+std::vector<const char*> FLAG_files;
+
+static void Usage() {
+  printf(
+      "BinaryLogDecoderApp [<args> ...] <file> ...\n"
+      "renders logs written by BinaryMultifileLogger back into text, on stdout.\n"
+      "Rotated files should be listed oldest first.\n"
+      "where <args> are\n"
+      " --utc[=(true|false)]          print times in UTC rather than local time\n"
+      " --threads[=(true|false)]      print the id of the thread that logged each message (default true)\n"
+      " --log_level=<N>               the most verbose level to print: {0, 1, 2, 3} = {FATAL, ERROR, WARNING, INFO}, "
+      "respectively (default 3); messages without a level are always printed\n"
+      " --help                        print out this message\n");
+}
+
+static bool GetFlagArgVal(const char* flag, const char* arg, const char** val) {
+  if (*arg != '-') {
+    return false;
+  }
+  while (*++arg == '-') {
+    continue;
+  }
+  const char* s = strchr(arg, '=');
+  if (s == NULL) {
+    if (strcmp(flag, arg) != 0) {
+      return false;
+    }
+    *val = NULL;
+    return true;
+  }
+  unsigned n = (unsigned)(s - arg);
+  if ((strlen(flag) != n) || (strncmp(flag, arg, n) != 0)) {
+    return false;
+  }
+  *val = s + 1;
+  return true;
+}
+
+static bool GetFlagArgVal(const char* flag, const char* arg, bool* val) {
+  const char* val_str;
+  bool success = GetFlagArgVal(flag, arg, &val_str);
+  if (success) {
+    *val = (val_str == NULL || strcasecmp(val_str, "true") == 0 || strcasecmp(val_str, "on") == 0 ||
+            strcasecmp(val_str, "yes") == 0 || strcasecmp(val_str, "1") == 0);
+  }
+  return success;
+}
+
+static bool GetFlagArgVal(const char* flag, const char* arg, unsigned* val) {
+  const char* val_str;
+  bool success = GetFlagArgVal(flag, arg, &val_str);
+  if (success) {
+    *val = val_str ? (unsigned)strtoul(val_str, NULL, 0) : 0;
+  }
+  return success;
+}
+
+static int ParseMyArgs(int argc, char** argv) {
+  int errs = 0;
+  for (--argc, ++argv; argc--; ++argv) {
+    bool help;
+    const char* arg = *argv;
+    if (arg[0] != '-') {
+      FLAG_files.push_back(arg);
+    } else if ((arg[1] == '-') &&                                //
+               (GetFlagArgVal("utc", arg, &FLAG_utc) ||          //
+                GetFlagArgVal("threads", arg, &FLAG_threads) ||  //
+                GetFlagArgVal("log_level", arg, &FLAG_logLevel))) {
+      continue;
+    } else if (GetFlagArgVal("help", arg, &help)) {
+      Usage();
+      exit(0);
+    } else {
+      fprintf(stderr, "Unknown argument: \"%s\"\n", arg);
+      Usage();
+      errs++;
+    }
+  }
+  return errs;
+}
+
+/// Print the time stamp, to the microsecond.
+/// @param[in]  timestamp   the time, in nanoseconds since 1970.
+static void PrintTime(uint64_t timestamp) {
+  time_t secs = (time_t)(timestamp / 1000000000u);
+  unsigned usecs = (unsigned)(timestamp % 1000000000u / 1000u);
+  struct tm tm;
+  char buf[32];
+#ifndef _MSC_VER
+  if (FLAG_utc) gmtime_r(&secs, &tm);
+  else localtime_r(&secs, &tm);
+#else   // _MSC_VER
+  if (FLAG_utc) gmtime_s(&tm, &secs);
+  else localtime_s(&tm, &secs);
+#endif  // _MSC_VER
+  strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+  printf("%s.%06u", buf, usecs);
+}
+
+static int DecodeFile(const char* file) {
+  static const char* levelNames[] = {"FATAL", "ERROR", "WARNING", "INFO"};
+  BinaryLogReader reader;
+  BinaryLogReader::Event ev;
+  NvCV_Status err = reader.open(file);
+  if (NVCV_ERR_FILE == err) {
+    fprintf(stderr, "Cannot read \"%s\"\n", file);
+    return 1;
+  } else if (NVCV_SUCCESS != err) {
+    fprintf(stderr, "\"%s\" is not a binary log that can be decoded here\n", file);
+    return 1;
+  }
+  while (reader.next(&ev)) {
+    if (ev.level != BinaryLog::kLevelNone && ev.level > FLAG_logLevel) continue;
+    PrintTime(ev.timestamp);
+    if (FLAG_threads) printf(" T%u", ev.threadId);
+    if (ev.level < sizeof(levelNames) / sizeof(levelNames[0])) printf(" %-7s ", levelNames[ev.level]);
+    else if (ev.level != BinaryLog::kLevelNone) printf(" LEVEL%-2u ", ev.level);
+    else printf(" ");
+    fwrite(ev.text.data(), 1, ev.text.size(), stdout);
+    if (ev.text.empty() || '\n' != ev.text.back()) putchar('\n');  // SDK messages already end with a newline
+  }
+  if (NVCV_SUCCESS != reader.status()) {
+    fprintf(stderr, "\"%s\" is corrupt or truncated at offset %zu\n", file, reader.offset());
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  int errs = ParseMyArgs(argc, argv);
+  if (errs) {
+    fprintf(stderr, "ERROR: bad command line parameters\n");
+    return 1;
+  }
+  if (FLAG_files.empty()) {
+    Usage();
+    return 1;
+  }
+  for (const char* file : FLAG_files) errs += DecodeFile(file);
+  return errs ? 1 : 0;
+}
@@ -24,97 +24,290 @@
 #include <assert.h>
 #include "socket_client.h"
 
+#ifndef _MSC_VER
+  #include <arpa/inet.h>
+  #include <errno.h>
+  #include <fcntl.h>
+  #include <netinet/in.h>
+  #include <netinet/tcp.h>
+  #include <poll.h>
+  #include <sys/socket.h>
+  #include <sys/time.h>
+  #include <unistd.h>
+#endif // _MSC_VER
+
+#if !defined(_MSC_VER) && defined(MSG_NOSIGNAL)
+  #define CLIENT_SEND_FLAGS MSG_NOSIGNAL  // Report a dropped connection as an error rather than with SIGPIPE
+#else
+  #define CLIENT_SEND_FLAGS 0
+#endif
+
 namespace socket_communication {
+
+// Little-endian serialization for the frame header
+static char* PutU16(char* p, uint16_t v) {
+  for (int i = 0; i < 2; ++i) *p++ = static_cast<char>(v >> (8 * i));
+  return p;
+}
+static char* PutU32(char* p, uint32_t v) {
+  for (int i = 0; i < 4; ++i) *p++ = static_cast<char>(v >> (8 * i));
+  return p;
+}
+static char* PutU64(char* p, uint64_t v) {
+  for (int i = 0; i < 8; ++i) *p++ = static_cast<char>(v >> (8 * i));
+  return p;
+}
+
 Client::Client() {}
 Client::Client(const std::string ip, unsigned short port) { Init(ip, port); }
-Client::~Client() { closesocket(client_); WSACleanup(); }
+Client::~Client() {
+  Disconnect();
+#ifdef _MSC_VER
+  if (wsa_started_) WSACleanup();
+#endif // _MSC_VER
+}
 
-void Client::Init(const std::string ip, unsigned short port) {
-  client_ = socket(AF_INET, SOCK_STREAM, 0);
-  if (client_ < 0) {
-    std::cout << "[Client]: ERROR establishing socket\n" << std::endl;
-    exit(1);
+bool Client::Init(const std::string ip, unsigned short port) {
+#ifdef _MSC_VER
+  if (!wsa_started_) {
+    WSADATA wsa_data;
+    wsa_started_ = (WSAStartup(MAKEWORD(2, 2), &wsa_data) == 0);
+  }
+#endif // _MSC_VER
+  Disconnect();
+  ip_ = ip;
+  port_ = port;
+  attempted_ = false;
+  if (Connect()) {
+    std::cout << "[Client]: Cpp socket client connected." << std::endl;
+  } else {
+    std::cout << "[Client]: ERROR connecting to " << ip_ << ":" << port_ << "; will keep trying" << std::endl;
+  }
+  return IsConnected();
+}
+
+bool Client::Connect() {
+  if (IsConnected()) return true;
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  if (attempted_ && now - last_attempt_ < reconnect_interval_) return false;
+  attempted_ = true;
+  last_attempt_ = now;
+
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port_);
+  if (inet_pton(AF_INET, ip_.c_str(), &addr.sin_addr) != 1) {
+    std::cout << "[Client]: ERROR invalid server address " << ip_ << std::endl;
+    return false;
+  }
+  client_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (client_ == kInvalidSocket) {
+    std::cout << "[Client]: ERROR establishing socket" << std::endl;
+    return false;
   }
 
+  // Connect without blocking, so that an unreachable server cannot stall the caller for longer than the timeout
   bool connected = false;
-  int connection_attempts = 5;
+#ifdef _MSC_VER
+  u_long non_blocking = 1;
+  ioctlsocket(client_, FIONBIO, &non_blocking);
+  if (connect(client_, reinterpret_cast<SOCKADDR*>(&addr), sizeof(addr)) == 0) {
+    connected = true;
+  } else if (WSAGetLastError() == WSAEWOULDBLOCK) {
+    fd_set write_set, error_set;
+    FD_ZERO(&write_set);
+    FD_ZERO(&error_set);
+    FD_SET(client_, &write_set);
+    FD_SET(client_, &error_set);
+    timeval timeout = {static_cast<long>(connect_timeout_.count() / 1000),
+                       static_cast<long>(connect_timeout_.count() % 1000 * 1000)};
+    connected = (select(0, NULL, &write_set, &error_set, &timeout) > 0) && FD_ISSET(client_, &write_set);
+  }
+  non_blocking = 0;
+  ioctlsocket(client_, FIONBIO, &non_blocking);
+  DWORD send_timeout = static_cast<DWORD>(send_timeout_.count());
+  setsockopt(client_, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&send_timeout), sizeof(send_timeout));
+#else // !_MSC_VER
+  int flags = fcntl(client_, F_GETFL, 0);
+  fcntl(client_, F_SETFL, flags | O_NONBLOCK);
+  if (connect(client_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+    connected = true;
+  } else if (errno == EINPROGRESS) {
+    pollfd pfd = {client_, POLLOUT, 0};
+    int err = 0;
+    socklen_t len = sizeof(err);
+    connected = (poll(&pfd, 1, static_cast<int>(connect_timeout_.count())) > 0) &&
+                (getsockopt(client_, SOL_SOCKET, SO_ERROR, &err, &len) == 0) && (err == 0);
+  }
+  fcntl(client_, F_SETFL, flags);
+  timeval send_timeout = {static_cast<time_t>(send_timeout_.count() / 1000),
+                          static_cast<suseconds_t>(send_timeout_.count() % 1000 * 1000)};
+  setsockopt(client_, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+#ifdef SO_NOSIGPIPE
+  int no_sigpipe = 1;  // Where there is no MSG_NOSIGNAL
+  setsockopt(client_, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif // SO_NOSIGPIPE
+#endif // _MSC_VER
+  if (!connected) {
+    Disconnect();
+    return false;
+  }
+  int no_delay = 1;  // Send each frame as soon as it is complete
+  setsockopt(client_, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&no_delay), sizeof(no_delay));
+  return true;
+}
 
-  while ((!connected) && (connection_attempts > 0)) {
-    WSAStartup(MAKEWORD(2, 0), &wsa_data);
-    client_ = socket(AF_INET, SOCK_STREAM, 0);
-    InetPton(AF_INET, "127.0.0.1", &addr.sin_addr.s_addr);
+void Client::Disconnect() {
+  if (client_ == kInvalidSocket) return;
+#ifdef _MSC_VER
+  closesocket(client_);
+#else // !_MSC_VER
+  close(client_);
+#endif // _MSC_VER
+  client_ = kInvalidSocket;
+}
 
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(static_cast<u_short>(port));
+Client::IoVec Client::MakeIoVec(const void* data, size_t size) {
+  IoVec iov;
+#ifdef _MSC_VER
+  iov.buf = static_cast<CHAR*>(const_cast<void*>(data));
+  iov.len = static_cast<ULONG>(size);
+#else // !_MSC_VER
+  iov.iov_base = const_cast<void*>(data);
+  iov.iov_len = size;
+#endif // _MSC_VER
+  return iov;
+}
 
-    // TODO: verify connection
-    connect(client_ , reinterpret_cast<SOCKADDR*>(&addr), sizeof(addr));
-    connected = true;
-    std::cout << "[Client]: Cpp socket client connected." << std::endl;      
+bool Client::SendAll(IoVec* iov, int iovcnt) {
+  if (!Connect()) return false;
+  while (iovcnt > 0) {
+#ifdef _MSC_VER
+    DWORD sent = 0;
+    if (WSASend(client_, iov, static_cast<DWORD>(iovcnt), &sent, 0, NULL, NULL) != 0) {
+      Disconnect();
+      return false;
+    }
+    size_t n = sent;
+    while (iovcnt > 0 && n >= iov->len) {  // Skip the buffers that were sent completely, ...
+      n -= iov->len;
+      ++iov;
+      --iovcnt;
+    }
+    if (iovcnt > 0) {  // ... and resume from the middle of the one that was not
+      iov->buf += n;
+      iov->len -= static_cast<ULONG>(n);
+    }
+#else // !_MSC_VER
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = iovcnt;
+    ssize_t sent = sendmsg(client_, &msg, CLIENT_SEND_FLAGS);  // writev(), with flags
+    if (sent < 0) {
+      if (errno == EINTR) continue;
+      Disconnect();  // Includes timeouts: the frame is half sent, so the stream can only be resumed afresh
+      return false;
+    }
+    size_t n = static_cast<size_t>(sent);
+    while (iovcnt > 0 && n >= iov->iov_len) {  // Skip the buffers that were sent completely, ...
+      n -= iov->iov_len;
+      ++iov;
+      --iovcnt;
+    }
+    if (iovcnt > 0) {  // ... and resume from the middle of the one that was not
+      iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+      iov->iov_len -= n;
+    }
+#endif // _MSC_VER
   }
+  return true;
 }
 
-void Client::Send(std::string message) {
-  // Send length of the message
-  size_t length = message.length();
-  std::string length_str = std::to_string(length);
-  std::string message_length =
-      std::string(size_message_length_ - length_str.length(), '0') + length_str;
-  send(client_, message_length.c_str(), size_message_length_, 0);
+bool Client::ReceiveAll(char* buf, size_t size) {
+  if (!IsConnected()) return false;
+  while (size > 0) {
+    int n = recv(client_, buf, static_cast<int>(size), 0);
+    if (n <= 0) {
+#ifndef _MSC_VER
+      if (n < 0 && errno == EINTR) continue;
+#endif // _MSC_VER
+      Disconnect();
+      return false;
+    }
+    buf += n;
+    size -= static_cast<size_t>(n);
+  }
+  return true;
+}
 
-  // Send message
-  send(client_, message.c_str(), static_cast<int>(length), 0);
+bool Client::Send(const std::string& message) {
+  // Send the length of the message, as zero-padded decimal, then the message, in one gather
+  char message_length[16 + 1];
+  snprintf(message_length, sizeof(message_length), "%0*zu", size_message_length_, message.length());
+  IoVec iov[2] = {MakeIoVec(message_length, size_message_length_), MakeIoVec(message.data(), message.length())};
+  return SendAll(iov, 2);
 }
 
 std::string Client::Receive() {
-  // TODO: try catch, if connection dropped print notification and try
-  // to reconnect
-
   // Receive length of the message
-  char message_length[16] = {0};
-  int n = recv(client_, message_length, size_message_length_, 0);
-  std::string message_length_string(message_length);
-  int length = std::stoi(message_length_string);
-  // if (length == 0) return "";
+  char message_length[16 + 1] = {0};
+  if (!ReceiveAll(message_length, size_message_length_)) return "";
+  size_t length = strtoul(message_length, NULL, 10);
 
   // receive message
-  char message[16] = {0};
-  n = recv(client_, message, length, 0);
+  std::string message(length, '\0');
+  if (length && !ReceiveAll(&message[0], length)) return "";
   return message;
 }
 
 void Client::ReceivePing() {
   char message_length[16] = {0};
-  recv(client_, message_length, size_message_length_, 0);
+  ReceiveAll(message_length, size_message_length_);
 }
 
-void Client::SendFloatArr(float *floatvec, size_t arr_size) {
-  size_t buf_size = arr_size*sizeof(float);
-
-  size_t length = buf_size;
-  std::string length_str = std::to_string(length);
-  std::string message_length =
-      std::string(size_message_length_ - length_str.length(), '0') + length_str;
-
-  send(client_, (char*)floatvec, static_cast<int>(length), 0);
+bool Client::SendFloatArr(const float *floatvec, size_t arr_size) {
+  IoVec iov = MakeIoVec(floatvec, arr_size * sizeof(float));
+  return SendAll(&iov, 1);
 }
 
-void Client::SendKeyPoints(NvAR_Point3f* keypoints, int numKeyPoints) {
-  size_t buf_size = numKeyPoints * 3 * sizeof(float);
-  send(client_, (char*)keypoints, static_cast<int>(buf_size), 0);
+bool Client::SendKeyPoints(const NvAR_Point3f* keypoints, int numKeyPoints) {
+  return SendKeyPointsFrame(keypoints, NULL, 1, static_cast<unsigned>(numKeyPoints));
 }
 
-void Client::SendIntVec(std::vector<int> intvec) {
-  size_t buf_size = intvec.size()*sizeof(int);
-  unsigned char buf[10]; 
-  std::memcpy(buf, intvec.data(), buf_size);
+bool Client::SendKeyPointsFrame(const NvAR_Point3f* keypoints, const float* confidences, unsigned numPeople,
+                                unsigned numKeyPoints) {
+  size_t num_points = static_cast<size_t>(numPeople) * numKeyPoints;
+  size_t keypoints_size = num_points * sizeof(NvAR_Point3f);
+  size_t confidences_size = confidences ? num_points * sizeof(float) : 0;
+  uint64_t timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::system_clock::now().time_since_epoch()).count());
+
+  // The floats are sent as they are in memory, which is little-endian on all supported platforms
+  static_assert(sizeof(NvAR_Point3f) == 3 * sizeof(float), "NvAR_Point3f is expected to be 3 packed floats");
+  char header[kFrameHeaderSize];
+  char* p = header;
+  p = PutU32(p, kFrameMagic);
+  p = PutU16(p, kFrameVersion);
+  p = PutU16(p, kFrameHeaderSize);
+  p = PutU32(p, frame_index_);
+  p = PutU64(p, timestamp);
+  p = PutU32(p, numPeople);
+  p = PutU32(p, numKeyPoints);
+  p = PutU32(p, confidences ? kFrameHasConfidences : 0);
+  p = PutU32(p, static_cast<uint32_t>(keypoints_size + confidences_size));
+  assert(p == header + kFrameHeaderSize);
 
-  size_t length = buf_size;
-  std::string length_str = std::to_string(length);
-  std::string message_length =
-      std::string(size_message_length_ - length_str.length(), '0') + length_str;
+  IoVec iov[3] = {MakeIoVec(header, sizeof(header)), MakeIoVec(keypoints, keypoints_size),
+                  MakeIoVec(confidences, confidences_size)};
+  ++frame_index_;  // Count dropped frames too, so that the receiver can tell
+  return SendAll(iov, confidences ? 3 : 2);
+}
 
-  send(client_, (char*)buf, static_cast<int>(length), 0);
+bool Client::SendIntVec(const std::vector<int>& intvec) {
+  IoVec iov = MakeIoVec(intvec.data(), intvec.size() * sizeof(int));
+  return SendAll(&iov, 1);
 }
 
 }
@@ -23,6 +23,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <chrono>
 #include <cstring>
 #include <iostream>
@@ -31,35 +33,91 @@
 #ifdef _MSC_VER
   #include <WinSock2.h>
   #include <ws2tcpip.h>
+  #pragma comment(lib, "ws2_32.lib")
+#else // !_MSC_VER
+  #include <sys/uio.h>
 #endif // _MSC_VER
 #include "nvAR_defs.h"
 
-#pragma comment(lib, "ws2_32.lib")
-
 namespace socket_communication {
+
+// The key point frame sent by SendKeyPointsFrame(). All fields are little-endian.
+//   uint32 magic         kFrameMagic
+//   uint16 version       kFrameVersion
+//   uint16 header_size   kFrameHeaderSize; receivers should skip any fields added after those below
+//   uint32 frame_index   increasing by one per frame sent, so that dropped frames can be detected
+//   uint64 timestamp     microseconds since 1970
+//   uint32 num_people
+//   uint32 num_keypoints per person
+//   uint32 flags         kFrameHasConfidences
+//   uint32 payload_size  the number of bytes that follow the header
+// followed by num_people * num_keypoints (x, y, z) floats, then as many confidence floats if flagged.
+// A receiver can resynchronize after connecting by searching for the magic number.
+const uint32_t kFrameMagic = 0x4B42564E;  // "NVBK"
+const uint16_t kFrameVersion = 1;
+const uint16_t kFrameHeaderSize = 36;
+const uint32_t kFrameHasConfidences = 1;
+
 class Client {
  public:
   Client();
   Client(const std::string ip, unsigned short port);
   ~Client();
 
-  void Init(const std::string ip = "127.0.0.1", unsigned short port = 5001);
+  // Remember the server, and try to connect to it. If this fails, or the connection drops later, each Send
+  // reconnects, at most once every reconnect_interval_.
+  // Returns true if connected.
+  bool Init(const std::string ip = "127.0.0.1", unsigned short port = 5001);
+
+  // Each Send returns true if the data was sent; false if it was dropped because there is no connection.
+  bool Send(const std::string& message);
+
+  bool SendIntVec(const std::vector<int>& intvec);
+  bool SendFloatArr(const float *floatvec, size_t arr_size);
 
-  void Send(std::string message);
+  // Send one person's key points, in a frame without confidences.
+  bool SendKeyPoints(const NvAR_Point3f* keypoints, int numKeyPoints);
 
-  void SendIntVec(std::vector<int> intvec);
-  void SendFloatArr(float *floatvec, size_t arr_size);
-  void SendKeyPoints(NvAR_Point3f* keypoints, int numKeyPoints);
+  // Send a key point frame, as described above, stamped with the current time.
+  // keypoints holds numKeyPoints points for each person, and confidences, which may be NULL, as many floats.
+  bool SendKeyPointsFrame(const NvAR_Point3f* keypoints, const float* confidences, unsigned numPeople,
+                          unsigned numKeyPoints);
 
   std::string Receive();
   void ReceivePing();
 
+  bool IsConnected() const { return client_ != kInvalidSocket; }
+
  private:
+#ifdef _MSC_VER
+  typedef SOCKET SocketHandle;
+  typedef WSABUF IoVec;
+  static const SOCKET kInvalidSocket = INVALID_SOCKET;
+#else // !_MSC_VER
+  typedef int SocketHandle;
+  typedef struct iovec IoVec;
+  static const int kInvalidSocket = -1;
+#endif // _MSC_VER
+
+  static IoVec MakeIoVec(const void* data, size_t size);
+
+  bool Connect();           // Connect now, unless a reconnection was attempted too recently
+  void Disconnect();
+  bool SendAll(IoVec* iov, int iovcnt);  // Send everything, through partial writes, or disconnect
+  bool ReceiveAll(char* buf, size_t size);
+
   const int size_message_length_ = 16;  // Buffer size for the length
+  const std::chrono::milliseconds connect_timeout_{500};
+  const std::chrono::milliseconds reconnect_interval_{1000};
+  const std::chrono::milliseconds send_timeout_{1000};
+  std::string ip_;
+  unsigned short port_ = 0;
+  SocketHandle client_ = kInvalidSocket;
+  std::chrono::steady_clock::time_point last_attempt_;
+  bool attempted_ = false;
+  uint32_t frame_index_ = 0;
 #ifdef _MSC_VER
-  SOCKET client_;
-  WSADATA wsa_data;
-  SOCKADDR_IN addr;
+  bool wsa_started_ = false;
 #endif // _MSC_VER
 };
 
@@ -29,12 +29,16 @@
 #include <string>
 #include <vector>
 
+#include "deformKernel.h"
+#include "faceIO.h"
 #include "meshRenderer.h"
 #include "nvAR.h"
 #include "nvARFaceExpressions.h"
 #include "nvAR_defs.h"
 #include "nvCVOpenCV.h"
+#include "openGLMeshRenderer.h"
 #include "opencv2/opencv.hpp"
+#include "simpleFaceModel.h"
 
 #ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
@@ -105,7 +109,9 @@
 
 #define DEFAULT_CODEC "avc1"
 #define DEFAULT_RENDER_MODEL "face_model3.nvf"
+#define DEFAULT_EOS_CACHE "eos_cache"
 #define NUM_CAMERA_INTRINSIC_PARAMS 3
+#define DEFORM_STATS_INTERVAL 300  // Frames between reports of the deformation statistics, with --debug
 
 /********************************************************************************
  * Command-line arguments
@@ -113,6 +119,7 @@
 
 // clang-format off
 bool
+    FLAG_asyncRender        = false,
     FLAG_debug              = false,
     FLAG_loop               = false,
     FLAG_show               = false,
@@ -121,11 +128,14 @@ bool
 std::string
     FLAG_camRes,
     FLAG_codec              = DEFAULT_CODEC,
+    FLAG_eosCache           = DEFAULT_EOS_CACHE,
+    FLAG_eosModel,
     FLAG_inFile,
     FLAG_modelDir,
     FLAG_outDir,
     FLAG_outFile,
     FLAG_renderModel        = DEFAULT_RENDER_MODEL,
+    FLAG_renderer,
     FLAG_log                = "stderr";
 int
     FLAG_filter             = NVAR_TEMPORAL_FILTER_FACE_BOX
@@ -149,6 +159,8 @@ static void Usage() {
   printf(
       "ExpressionApp [<args> ...]\n"
       "where <args> is\n"
+      " --async_render[=(true|false)] overlap mesh rendering with tracking, delaying the mesh by a frame\n"
+      "                             (default false)\n"
       " --cam_res=[WWWx]HHH         specify resolution as height or width x height\n"
       " --codec=<fourcc>            FOURCC code for the desired codec (default avc1)\n"
       " --debug[=(true|false)]      report debugging info (default false)\n"
@@ -160,6 +172,9 @@ static void Usage() {
       "                             (default 55: face box, landmarks, pose, expressions, gaze; no closure)\n"
       " --fov=<degrees>             field of view, in degrees; 0 implies orthographic (default 0)\n"
       " --help                      print this message\n"
+      " --eos_cache=<path>          specify the directory of compiled EOS models (default " DEFAULT_EOS_CACHE ")\n"
+      " --eos_model=<shape.bin>,<blendshapes.bin>,<contours.json>,<topology.json>\n"
+      "                             render an EOS face model instead of --render_model, compiled through the cache\n"
       " --in=<file>                 specify the input file (default webcam 0)\n"
       " --log=<file>                log SDK errors to a file, \"stderr\" or \"\" (default stderr)\n"
       " --log_level=<N>             the desired log level: {0, 1, 2, 3} = {FATAL, ERROR, WARNING, INFO}, respectively "
@@ -170,6 +185,8 @@ static void Usage() {
       " --out=<file>                specify the output file\n"
       " --render_model=<file>       specify the face model to be used for rendering (default " DEFAULT_RENDER_MODEL
       ")\n"
+      " --renderer=<name>           specify the mesh renderer, e.g. OpenGL, OpenGLHeadless or Software "
+      "(default the first listed)\n"
       " --show[=(true|false)]       show the results (default false, unless --out is empty)\n"
       " --show_ui[=(true|false)]    show the expression calibration UI (default false)\n"
       " --temporal=<bitfield>       apply temporal filter: see --filter\n"
@@ -276,9 +293,12 @@ static int ParseMyArgs(int argc, char** argv) {
     if (arg[0] != '-') {
       continue;
     } else if ((arg[1] == '-') &&                                         //
-               (GetFlagArgVal("cam_res", arg, &FLAG_camRes) ||            //
+               (GetFlagArgVal("async_render", arg, &FLAG_asyncRender) ||  //
+                GetFlagArgVal("cam_res", arg, &FLAG_camRes) ||            //
                 GetFlagArgVal("codec", arg, &FLAG_codec) ||               //
                 GetFlagArgVal("debug", arg, &FLAG_debug) ||               //
+                GetFlagArgVal("eos_cache", arg, &FLAG_eosCache) ||        //
+                GetFlagArgVal("eos_model", arg, &FLAG_eosModel) ||        //
                 GetFlagArgVal("pose_mode", arg, &FLAG_poseMode) ||        //
                 GetFlagArgVal("cheekpuff", arg, &FLAG_cheekPuff) ||       //
                 GetFlagArgVal("filter", arg, &FLAG_filter) ||             //
@@ -293,6 +313,7 @@ static int ParseMyArgs(int argc, char** argv) {
                 GetFlagArgVal("out", arg, &FLAG_outFile) ||               //
                 GetFlagArgVal("out_file", arg, &FLAG_outFile) ||          //
                 GetFlagArgVal("render_model", arg, &FLAG_renderModel) ||  //
+                GetFlagArgVal("renderer", arg, &FLAG_renderer) ||         //
                 GetFlagArgVal("show", arg, &FLAG_show) ||                 //
                 GetFlagArgVal("show_ui", arg, &FLAG_showUI) ||            //
                 GetFlagArgVal("temporal", arg, &FLAG_filter) ||           //
@@ -391,6 +412,10 @@ class App {
   NvCV_Status toggleGazeFiltering();
   NvCV_Status togglePoseMode();
   NvCV_Status overlayLandmarks(const float landmarks[126 * 2], unsigned screenHeight, NvCVImage* im);
+  NvCV_Status renderMesh(const float* trans, bool* haveImage);
+  void discardPendingRenders();
+  void printDeformStats();
+  NvCV_Status compileEOSModel(std::string& nvfFile);
   void getFPS();
   void drawFPS(cv::Mat& img);
   void barPlotExprs();
@@ -431,6 +456,7 @@ class App {
   bool _enableCheekPuff;
   MeshRendererBroker _broker;
   MeshRenderer* _renderer = nullptr;
+  unsigned _rendersPending = 0;  // The number of frames submitted to the renderer but not yet collected
   static const char _windowTitle[], *_exprAbbr[][4];
   MyTimer _timer;
   bool _showFPS;
@@ -596,8 +622,10 @@ NvCV_Status App::stop() {
   if (_vidOut.isOpened()) _vidOut.release();
   if (_vidIn.isOpened()) _vidIn.release();
   if (_featureHan) NvAR_Destroy(_featureHan);
+  if (FLAG_debug) printDeformStats();
   if (_renderer) _renderer->destroy();
   _renderer = nullptr;
+  _rendersPending = 0;
   _featureHan = nullptr;
   _inFile.clear();
   _outFile.clear();
@@ -761,6 +789,7 @@ NvCV_Status App::init() {
   NvCV_Status err;
   std::string path;
   std::vector<std::string> rendererList;
+  MyTimer loadTimer;
 
   _renderHeight = 480;
   _renderWidth = 480;
@@ -803,22 +832,32 @@ NvCV_Status App::init() {
     printf("No renderers available to the broker\n");
     return NVCV_ERR_FEATURENOTFOUND;
   }
-  err = _broker.create(rendererList[0].c_str(), &_renderer);
+  if (FLAG_renderer.empty())
+    FLAG_renderer = rendererList[0];
+  err = _broker.create(FLAG_renderer.c_str(), &_renderer);
   if (NVCV_SUCCESS != err) {
-    printf("Cannot create the %s renderer\n", rendererList[0].c_str());
+    printf("Cannot create the %s renderer\n", FLAG_renderer.c_str());
     return NVCV_ERR_FEATURENOTFOUND;
   }
 
-  if (!SetPathIfFileExists("", FLAG_renderModel, path) && !SetPathIfFileExists(FLAG_modelDir, FLAG_renderModel, path)) {
+  if (!FLAG_eosModel.empty()) {
+    err = compileEOSModel(path);
+    if (NVCV_SUCCESS != err)
+      return err;
+  } else if (!SetPathIfFileExists("", FLAG_renderModel, path) &&
+             !SetPathIfFileExists(FLAG_modelDir, FLAG_renderModel, path)) {
     err = NVCV_ERR_FILE;
     printf("Cannot find %s: %s\n", FLAG_renderModel.c_str(), NvCV_GetErrorStringFromCode(err));
     return err;
   }
+  loadTimer.start();
   err = _renderer->read(path.c_str());
+  loadTimer.stop();
   if (NVCV_SUCCESS != err) {
-    printf("{\"%s\",\"%s\"}: %s\n", FLAG_modelDir.c_str(), FLAG_renderModel.c_str(), NvCV_GetErrorStringFromCode(err));
+    printf("{\"%s\",\"%s\"}: %s\n", FLAG_modelDir.c_str(), path.c_str(), NvCV_GetErrorStringFromCode(err));
     return err;
   }
+  if (FLAG_debug) printf("Render model \"%s\" read in %.1f ms\n", path.c_str(), loadTimer.elapsedTimeFloat() * 1.e3);
   err = _renderer->init(_renderWidth, _renderHeight, _windowTitle, false);
   if (NVCV_SUCCESS != err) {
     printf("renderer init: %s\n", NvCV_GetErrorStringFromCode(err));
@@ -868,6 +907,83 @@ NvCV_Status App::overlayLandmarks(const float landmarks[126 * 2], unsigned scree
   return NVCV_SUCCESS;
 }
 
+NvCV_Status App::renderMesh(const float* trans, bool* haveImage) {
+  NvCV_Status err;
+  *haveImage = false;
+  if (FLAG_asyncRender) {
+    // Submit this frame, then collect the previous one, whose readback has overlapped the tracking of this frame.
+    err = _renderer->submit(_expressions.data(), &_pose.rotation.x, trans);
+    if (NVCV_SUCCESS == err) {
+      if (++_rendersPending < 2) return NVCV_SUCCESS;  // Nothing to show until the second frame
+      err = _renderer->collect(&_renderImg);
+      --_rendersPending;
+      *haveImage = (NVCV_SUCCESS == err);
+      return err;
+    }
+    if (NVCV_ERR_UNIMPLEMENTED != err) return err;
+    printf("The %s renderer cannot render asynchronously\n", FLAG_renderer.c_str());
+    FLAG_asyncRender = false;
+  }
+  err = _renderer->render(_expressions.data(), &_pose.rotation.x, trans, &_renderImg);  // GL _renderImg is upside down
+  *haveImage = (NVCV_SUCCESS == err);
+  return err;
+}
+
+void App::discardPendingRenders() {
+  for (; _rendersPending; --_rendersPending) (void)_renderer->collect(&_renderImg);
+}
+
+void App::printDeformStats() {
+  const char* name = nullptr;
+  OpenGLMeshRendererDeformStats stats;
+  if (!_renderer || NVCV_SUCCESS != _renderer->name(&name) || strncmp(name, "OpenGL", 6))
+    return;  // Only the OpenGL renderers keep deformation statistics
+  if (NVCV_SUCCESS != OpenGLMeshRenderer_GetDeformStats(_renderer, &stats) || !stats.frames)
+    return;
+  printf("Deformation: %llu frames, %u shapes on the last, %.1f shapes per frame, %llu skipped, %llu full rebuilds\n",
+         stats.frames, stats.lastShapesTouched, double(stats.shapesTouched) / double(stats.frames), stats.skippedFrames,
+         stats.fullRebuilds);
+}
+
+NvCV_Status App::compileEOSModel(std::string& nvfFile) {
+  std::string files[4];
+  size_t b = 0, e = 0;
+  for (std::string& file : files) {
+    if (e == std::string::npos) break;
+    e = FLAG_eosModel.find(',', b);
+    file = FLAG_eosModel.substr(b, e - b);
+    if (!SetPathIfFileExists("", file, file) && !SetPathIfFileExists(FLAG_modelDir, file, file)) {
+      printf("Cannot find EOS file \"%s\"\n", file.c_str());
+      return NVCV_ERR_FILE;
+    }
+    b = e + 1;
+  }
+  if (e != std::string::npos || files[3].empty()) {
+    printf("--eos_model needs <shape.bin>,<blendshapes.bin>,<contours.json>,<topology.json>\n");
+    return NVCV_ERR_PARAMETER;
+  }
+
+  SimpleFaceModelAdapter sfma;
+  FaceIOCacheStats stats = {};
+  char cacheFile[1024];
+  FaceIOErr ioErr = ReadEOSFaceModelCached(files[0].c_str(), 0, files[1].c_str(), files[2].c_str(), files[3].c_str(),
+                                           FLAG_eosCache.c_str(), &sfma, &stats, cacheFile, sizeof(cacheFile));
+  if (kIOErrNone != ioErr) {
+    printf("Cannot read EOS model \"%s\": %s\n", FLAG_eosModel.c_str(), FaceIOErrorStringFromCode(ioErr));
+    return NVCV_ERR_READ;
+  }
+  if (FLAG_debug)
+    printf("EOS model loaded in %.1f ms: cache hits %llu (%.1f ms), misses %llu (%.1f ms), stores %llu\n",
+           stats.lastSeconds * 1.e3, stats.hits, stats.hitSeconds * 1.e3, stats.misses, stats.missSeconds * 1.e3,
+           stats.stores);
+  if (!cacheFile[0]) {
+    printf("Cannot compile EOS model \"%s\" into \"%s\"\n", FLAG_eosModel.c_str(), FLAG_eosCache.c_str());
+    return NVCV_ERR_FILE;
+  }
+  nvfFile = cacheFile;
+  return NVCV_SUCCESS;
+}
+
 NvCV_Status App::run() {
   NvCV_Status err = NVCV_SUCCESS;
   NvCVImage tmpImg, view;
@@ -956,16 +1072,21 @@ NvCV_Status App::run() {
     if (_viewMode & VIEW_MESH) {
       if (isFaceDetected) {
         float* head_translation = _poseMode != 0 ? &_pose.translation.vec[0] : nullptr;
-        BAIL_IF_ERR(err = _renderer->render(_expressions.data(), &_pose.rotation.x, head_translation,
-                                            &_renderImg));  // GL _renderImg is upside down
-        NvCVImage_InitView(&view, &_compImg, _renderX, _renderY, _renderWidth, _renderHeight);
-        NvCVImage_FlipY(&view, &view);  // Since OpenGL renderImg is upside-down, we copy it to a flipped dst
-        NvCVImage_Transfer(&_renderImg, &view, 1.0f, _stream, nullptr);  // VFlip RGBA --> BGR
+        bool haveImage;
+        BAIL_IF_ERR(err = renderMesh(head_translation, &haveImage));
+        if (haveImage) {
+          NvCVImage_InitView(&view, &_compImg, _renderX, _renderY, _renderWidth, _renderHeight);
+          NvCVImage_FlipY(&view, &view);  // Since OpenGL renderImg is upside-down, we copy it to a flipped dst
+          NvCVImage_Transfer(&_renderImg, &view, 1.0f, _stream, nullptr);  // VFlip RGBA --> BGR
+        }
       } else {
+        discardPendingRenders();  // Stale frames of a face that has been lost
         cv::Mat compImgCVMat;
         CVWrapperForNvCVImage(&_compImg, &compImgCVMat);
         cv::rectangle(compImgCVMat, cv::Rect(_renderX, _renderY, _renderWidth, _renderHeight), cv::Scalar(0, 0, 0), -1);
       }
+    } else {
+      discardPendingRenders();
     }
     if (_vidOut.isOpened()) _vidOut.write(_ocvDstImg);
     drawFPS(_ocvDstImg);
@@ -973,6 +1094,8 @@ NvCV_Status App::run() {
       cv::imshow(_windowTitle, _ocvDstImg);
     }
 
+    if (FLAG_debug && frameCount && !(frameCount % DEFORM_STATS_INTERVAL)) printDeformStats();
+
     int key = cv::waitKey(1);
     if (key >= 0 && FLAG_debug) printf("Key press '%c' (%02x)\n", ((0x20 <= key && key <= 0x7f) ? key : '#'), key);
 #ifdef _ENABLE_UI
@@ -1219,6 +1342,8 @@ int main(int argc, char** argv) {
   err = NvAR_ConfigureLogger(FLAG_logLevel, FLAG_log.c_str(), nullptr, nullptr);
   if (NVCV_SUCCESS != err)
     printf("%s: while configuring logger to \"%s\"\n", NvCV_GetErrorStringFromCode(err), FLAG_log.c_str());
+  if (FLAG_debug && !DeformSelfTest(FLAG_verbose))  // Validate the vectorized blendshape kernels on this CPU
+    printf("WARNING: falling back to %s blendshape kernels\n", DeformISAName(DeformSetISA(kDeformISAScalar)));
 
   if (FLAG_renderModel.empty()) FLAG_renderModel = DEFAULT_RENDER_MODEL;
   if (FLAG_modelDir.empty()) {
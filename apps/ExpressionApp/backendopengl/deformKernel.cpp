@@ -0,0 +1,387 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "deformKernel.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define DEFORM_X86_SIMD 1
+  #include <immintrin.h>
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #endif /* _MSC_VER */
+  #if defined(__GNUC__) || defined(__clang__)
+    #define DEFORM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+  #else  /* !__GNUC__ */
+    #define DEFORM_TARGET_AVX2  /* MSVC allows AVX2 intrinsics without compiler flags */
+  #endif /* !__GNUC__ */
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+  #define DEFORM_NEON_SIMD 1
+  #include <arm_neon.h>
+#endif
+
+
+namespace { // anonymous
+
+enum {
+  kDeformTileSize = 3 * 680   // Floats per tile: 8 KB of whole vertices, which stay in L1 while all terms are added
+};
+
+typedef void (*AddFloatProc)(float *dst, size_t n, const float *src, float a);
+typedef void (*AddQuantizedProc)(float *dst, size_t n, const int16_t *src, float a, float b);
+
+struct DeformKernels {
+  DeformISA         isa;
+  AddFloatProc      addFloat;
+  AddQuantizedProc  addQuantized;
+};
+
+
+/********************************************************************************
+ * Scalar
+ ********************************************************************************/
+
+void AddFloatScalar(float *dst, size_t n, const float *src, float a) {
+  for (float *dstEnd = dst + n; dst != dstEnd;)
+    *dst++ += a * *src++;
+}
+
+void AddQuantizedScalar(float *dst, size_t n, const int16_t *src, float a, float b) {
+  for (float *dstEnd = dst + n; dst != dstEnd;)
+    *dst++ += a * *src++ + b;
+}
+
+const DeformKernels scalarKernels = { kDeformISAScalar, AddFloatScalar, AddQuantizedScalar };
+
+/* Scatter-add the sparse deltas of the vertices in [v0, v1). This is scalar for all instruction sets. */
+void AddSparse(float *dst, size_t v0, size_t v1, const DeformTerm &t) {
+  const uint32_t *idx    = std::lower_bound(t.indices, t.indices + t.numIndices, (uint32_t)v0),
+                 *idxEnd = t.indices + t.numIndices;
+  const float    *src    = t.fsrc + 3 * (idx - t.indices);
+  for (; idx != idxEnd && *idx < v1; ++idx, src += 3) {
+    float *d = dst + 3 * size_t(*idx);
+    d[0] += t.a * src[0];
+    d[1] += t.a * src[1];
+    d[2] += t.a * src[2];
+  }
+}
+
+
+#ifdef DEFORM_X86_SIMD
+
+/********************************************************************************
+ * SSE2
+ ********************************************************************************/
+
+void AddFloatSSE(float *dst, size_t n, const float *src, float a) {
+  const __m128 va = _mm_set1_ps(a);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128 d0 = _mm_add_ps(_mm_loadu_ps(dst + i + 0), _mm_mul_ps(va, _mm_loadu_ps(src + i + 0))),
+           d1 = _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_mul_ps(va, _mm_loadu_ps(src + i + 4)));
+    _mm_storeu_ps(dst + i + 0, d0);
+    _mm_storeu_ps(dst + i + 4, d1);
+  }
+  AddFloatScalar(dst + i, n - i, src + i, a);
+}
+
+void AddQuantizedSSE(float *dst, size_t n, const int16_t *src, float a, float b) {
+  const __m128 va = _mm_set1_ps(a), vb = _mm_set1_ps(b);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i q  = _mm_loadu_si128((const __m128i*)(src + i)),
+            q0 = _mm_srai_epi32(_mm_unpacklo_epi16(q, q), 16),   // Sign-extend to 32 bits
+            q1 = _mm_srai_epi32(_mm_unpackhi_epi16(q, q), 16);
+    __m128 d0 = _mm_add_ps(_mm_loadu_ps(dst + i + 0), _mm_add_ps(_mm_mul_ps(va, _mm_cvtepi32_ps(q0)), vb)),
+           d1 = _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_add_ps(_mm_mul_ps(va, _mm_cvtepi32_ps(q1)), vb));
+    _mm_storeu_ps(dst + i + 0, d0);
+    _mm_storeu_ps(dst + i + 4, d1);
+  }
+  AddQuantizedScalar(dst + i, n - i, src + i, a, b);
+}
+
+const DeformKernels sseKernels = { kDeformISASSE, AddFloatSSE, AddQuantizedSSE };
+
+
+/********************************************************************************
+ * AVX2
+ ********************************************************************************/
+
+DEFORM_TARGET_AVX2 void AddFloatAVX2(float *dst, size_t n, const float *src, float a) {
+  const __m256 va = _mm256_set1_ps(a);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256 d0 = _mm256_fmadd_ps(va, _mm256_loadu_ps(src + i + 0), _mm256_loadu_ps(dst + i + 0)),
+           d1 = _mm256_fmadd_ps(va, _mm256_loadu_ps(src + i + 8), _mm256_loadu_ps(dst + i + 8));
+    _mm256_storeu_ps(dst + i + 0, d0);
+    _mm256_storeu_ps(dst + i + 8, d1);
+  }
+  AddFloatScalar(dst + i, n - i, src + i, a);
+}
+
+DEFORM_TARGET_AVX2 void AddQuantizedAVX2(float *dst, size_t n, const int16_t *src, float a, float b) {
+  const __m256 va = _mm256_set1_ps(a), vb = _mm256_set1_ps(b);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256 q0 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i + 0)))),
+           q1 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i + 8))));
+    __m256 d0 = _mm256_add_ps(_mm256_loadu_ps(dst + i + 0), _mm256_fmadd_ps(va, q0, vb)),
+           d1 = _mm256_add_ps(_mm256_loadu_ps(dst + i + 8), _mm256_fmadd_ps(va, q1, vb));
+    _mm256_storeu_ps(dst + i + 0, d0);
+    _mm256_storeu_ps(dst + i + 8, d1);
+  }
+  AddQuantizedScalar(dst + i, n - i, src + i, a, b);
+}
+
+const DeformKernels avx2Kernels = { kDeformISAAVX2, AddFloatAVX2, AddQuantizedAVX2 };
+
+bool CPUHasAVX2() {
+#ifdef _MSC_VER
+  int r[4];
+  __cpuid(r, 0);
+  if (r[0] < 7) return false;
+  __cpuid(r, 1);
+  const int osxsave = 1 << 27, avx = 1 << 28, fma = 1 << 12;
+  if ((r[2] & (osxsave | avx | fma)) != (osxsave | avx | fma)) return false;
+  if ((_xgetbv(0) & 6) != 6) return false;   // The OS saves the YMM registers
+  __cpuidex(r, 7, 0);
+  return (r[1] & (1 << 5)) != 0;
+#else  /* !_MSC_VER */
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif /* !_MSC_VER */
+}
+
+#endif /* DEFORM_X86_SIMD */
+
+
+#ifdef DEFORM_NEON_SIMD
+
+/********************************************************************************
+ * NEON
+ ********************************************************************************/
+
+void AddFloatNEON(float *dst, size_t n, const float *src, float a) {
+  const float32x4_t va = vdupq_n_f32(a);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    float32x4_t d0 = vmlaq_f32(vld1q_f32(dst + i + 0), vld1q_f32(src + i + 0), va),
+                d1 = vmlaq_f32(vld1q_f32(dst + i + 4), vld1q_f32(src + i + 4), va);
+    vst1q_f32(dst + i + 0, d0);
+    vst1q_f32(dst + i + 4, d1);
+  }
+  AddFloatScalar(dst + i, n - i, src + i, a);
+}
+
+void AddQuantizedNEON(float *dst, size_t n, const int16_t *src, float a, float b) {
+  const float32x4_t va = vdupq_n_f32(a), vb = vdupq_n_f32(b);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    int16x8_t   q  = vld1q_s16(src + i);
+    float32x4_t q0 = vcvtq_f32_s32(vmovl_s16(vget_low_s16(q))),
+                q1 = vcvtq_f32_s32(vmovl_s16(vget_high_s16(q)));
+    float32x4_t d0 = vaddq_f32(vld1q_f32(dst + i + 0), vmlaq_f32(vb, q0, va)),
+                d1 = vaddq_f32(vld1q_f32(dst + i + 4), vmlaq_f32(vb, q1, va));
+    vst1q_f32(dst + i + 0, d0);
+    vst1q_f32(dst + i + 4, d1);
+  }
+  AddQuantizedScalar(dst + i, n - i, src + i, a, b);
+}
+
+const DeformKernels neonKernels = { kDeformISANEON, AddFloatNEON, AddQuantizedNEON };
+
+#endif /* DEFORM_NEON_SIMD */
+
+
+/********************************************************************************
+ * Dispatch
+ ********************************************************************************/
+
+const DeformKernels* BestKernels() {
+  static const DeformKernels *best =
+#if defined(DEFORM_X86_SIMD)
+    CPUHasAVX2() ? &avx2Kernels : &sseKernels;
+#elif defined(DEFORM_NEON_SIMD)
+    &neonKernels;
+#else
+    &scalarKernels;
+#endif
+  return best;
+}
+
+std::atomic<const DeformKernels*> selectedKernels(nullptr);
+
+const DeformKernels* Kernels() {
+  const DeformKernels *k = selectedKernels.load(std::memory_order_relaxed);
+  return k ? k : BestKernels();
+}
+
+} // namespace anonymous
+
+
+/********************************************************************************
+ * API
+ ********************************************************************************/
+
+void DeformAccumulate(float *dst, const float *base, size_t begin, size_t end, const DeformTerm *terms,
+                      unsigned numTerms) {
+  const DeformKernels *k = Kernels();
+  for (size_t t0 = begin, t1; t0 < end; t0 = t1) {
+    t1 = std::min(end, t0 + kDeformTileSize);
+    size_t n = t1 - t0;
+    if (base)
+      memcpy(dst + t0, base + t0, n * sizeof(*dst));
+    for (const DeformTerm *t = terms, *tEnd = terms + numTerms; t != tEnd; ++t) {
+      if      (t->indices) AddSparse(dst, t0 / 3, t1 / 3, *t);
+      else if (t->fsrc)    (*k->addFloat)(dst + t0, n, t->fsrc + t0, t->a);
+      else                 (*k->addQuantized)(dst + t0, n, t->qsrc + t0, t->a, t->b);
+    }
+  }
+}
+
+void DeformAccumulateReference(float *dst, const float *base, size_t begin, size_t end, const DeformTerm *terms,
+                               unsigned numTerms) {
+  if (base)
+    memcpy(dst + begin, base + begin, (end - begin) * sizeof(*dst));
+  for (const DeformTerm *t = terms, *tEnd = terms + numTerms; t != tEnd; ++t) {
+    if      (t->indices) AddSparse(dst, begin / 3, end / 3, *t);
+    else if (t->fsrc)    AddFloatScalar(dst + begin, end - begin, t->fsrc + begin, t->a);
+    else                 AddQuantizedScalar(dst + begin, end - begin, t->qsrc + begin, t->a, t->b);
+  }
+}
+
+DeformISA DeformSetISA(DeformISA isa) {
+  const DeformKernels *k = BestKernels();
+  switch (isa) {
+    case kDeformISAScalar:  k = &scalarKernels; break;
+#ifdef DEFORM_X86_SIMD
+    case kDeformISASSE:     k = &sseKernels;    break;
+    case kDeformISAAVX2:    if (CPUHasAVX2()) k = &avx2Kernels; break;
+#endif /* DEFORM_X86_SIMD */
+#ifdef DEFORM_NEON_SIMD
+    case kDeformISANEON:    k = &neonKernels;   break;
+#endif /* DEFORM_NEON_SIMD */
+    default:                break;
+  }
+  selectedKernels.store(k, std::memory_order_relaxed);
+  return k->isa;
+}
+
+DeformISA DeformGetISA() {
+  return Kernels()->isa;
+}
+
+const char* DeformISAName(DeformISA isa) {
+  switch (isa) {
+    case kDeformISAScalar:  return "scalar";
+    case kDeformISASSE:     return "SSE2";
+    case kDeformISAAVX2:    return "AVX2";
+    case kDeformISANEON:    return "NEON";
+    default:                return "best";
+  }
+}
+
+bool DeformSelfTest(bool verbose) {
+  const size_t numVerts = 2 * 680 + 17, n = 3 * numVerts;  // Spans several tiles, with a ragged last one
+  const float  guard = -12345.f;                            // Marks floats outside of [begin, end)
+  std::mt19937 rng(0x5eed);
+  std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+  std::vector<float> base(n), dense[2], sparse[2];
+  std::vector<int16_t> quant[2];
+  std::vector<uint32_t> indices[2];
+  std::vector<DeformTerm> terms;
+  bool ok = true;
+
+  for (float &f : base) f = uniform(rng);
+  for (unsigned j = 0; j < 2; ++j) {
+    dense[j].resize(n);
+    for (float &f : dense[j]) f = uniform(rng);
+    quant[j].resize(n);
+    for (int16_t &q : quant[j]) q = int16_t(uniform(rng) * 32767.f);
+    for (uint32_t v = j; v < numVerts; v += 5 + 2 * j) {    // Ascending, and both sparse and dense enough
+      indices[j].push_back(v);
+      for (unsigned k = 0; k < 3; ++k) sparse[j].push_back(uniform(rng));
+    }
+    terms.push_back({ dense[j].data(), nullptr, nullptr, 0, uniform(rng), 0.f });
+    terms.push_back({ nullptr, quant[j].data(), nullptr, 0, uniform(rng) / 32767.f, uniform(rng) });
+  }
+  const unsigned numDenseTerms = unsigned(terms.size());
+  for (unsigned j = 0; j < 2; ++j)
+    terms.push_back({ sparse[j].data(), nullptr, indices[j].data(), indices[j].size(), uniform(rng), 0.f });
+
+  struct Range { size_t begin, end; bool sparse; };
+  const Range ranges[] = {
+    { 0, n,         true  },            // Everything
+    { 3, n - 3,     true  },            // Whole vertices, but not vector-aligned
+    { 3 * 679, 3 * 683, true },         // Across a tile boundary
+    { 1, n - 2,     false },            // Unaligned, so no sparse terms
+    { 5, 12,        false },            // Shorter than a vector
+    { 7, 7,         false },            // Empty
+  };
+
+  const DeformKernels *saved = selectedKernels.load(std::memory_order_relaxed);
+  const DeformISA isas[] = { kDeformISAScalar, kDeformISASSE, kDeformISAAVX2, kDeformISANEON };
+  std::vector<float> ref(n), dst(n);
+  for (DeformISA isa : isas) {
+    if (DeformSetISA(isa) != isa)
+      continue;                                                // Not supported by this build or CPU
+    float maxErr = 0.f;
+    unsigned numBad = 0;
+    for (const Range &r : ranges) {
+      unsigned numTerms = r.sparse ? unsigned(terms.size()) : numDenseTerms;
+      for (int withBase = 0; withBase < 2; ++withBase) {
+        std::fill(ref.begin(), ref.end(), guard);
+        std::fill(dst.begin(), dst.end(), guard);
+        if (!withBase) {
+          std::copy(base.begin() + r.begin, base.begin() + r.end, ref.begin() + r.begin);
+          std::copy(base.begin() + r.begin, base.begin() + r.end, dst.begin() + r.begin);
+        }
+        DeformAccumulateReference(ref.data(), withBase ? base.data() : nullptr, r.begin, r.end, terms.data(),
+                                  numTerms);
+        DeformAccumulate(dst.data(), withBase ? base.data() : nullptr, r.begin, r.end, terms.data(), numTerms);
+        for (size_t i = 0; i < n; ++i) {
+          float err = fabsf(dst[i] - ref[i]);                  // Fused multiply-adds round differently
+          maxErr = std::max(maxErr, err);
+          if (!(err <= 1.e-5f * (1.f + fabsf(ref[i])))) {    // Also catches NaN
+            if (!numBad++)
+              printf("DeformSelfTest: %s differs at %zu in [%zu, %zu): %g vs %g\n", DeformISAName(isa), i,
+                     r.begin, r.end, dst[i], ref[i]);
+          }
+        }
+      }
+    }
+    if (numBad || verbose)
+      printf("DeformSelfTest: %s %s, max error %g, %u mismatches\n", DeformISAName(isa), (numBad ? "FAILED" : "passed"),
+             maxErr, numBad);
+    ok = ok && !numBad;
+  }
+  selectedKernels.store(saved, std::memory_order_relaxed);
+  return ok;
+}
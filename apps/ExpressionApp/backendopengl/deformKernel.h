@@ -0,0 +1,100 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __DEFORM_KERNEL_H
+#define __DEFORM_KERNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/********************************************************************************
+ * DeformTerm
+ * One weighted shape to be added to the mesh, either as floats:
+ *    dst[i] += a * fsrc[i]
+ * or as 16-bit quantized components (see FaceIOQuantization):
+ *    dst[i] += a * qsrc[i] + b
+ * with a = c * scale and b = c * offset for a coefficient c,
+ * or as a sparse list of the vertices that it moves:
+ *    dst[3 * indices[k] + j] += a * fsrc[3 * k + j]
+ ********************************************************************************/
+
+struct DeformTerm {
+  const float    *fsrc;       ///< The float shape, or NULL if quantized.
+  const int16_t  *qsrc;       ///< The quantized shape, used if fsrc is NULL.
+  const uint32_t *indices;    ///< If not NULL, the ascending vertex indices of the sparse deltas in fsrc.
+  size_t         numIndices;  ///< The number of sparse vertex indices.
+  float          a, b;        ///< The weights.
+};
+
+
+/********************************************************************************
+ * DeformKernel
+ * Accumulate weighted shapes into a vertex array, tile by tile, so that each
+ * tile of the destination stays in cache while all of the terms are applied.
+ ********************************************************************************/
+
+enum DeformISA {
+  kDeformISAScalar,       ///< Portable C++, the reference for validation.
+  kDeformISASSE,          ///< SSE2, the baseline on x86-64.
+  kDeformISAAVX2,         ///< AVX2 with FMA.
+  kDeformISANEON,         ///< ARM NEON.
+  kDeformISABest          ///< The best supported by this CPU.
+};
+
+/** Compute dst[i] = base[i] + sum of the terms, for begin <= i < end.
+ * @param[out]  dst       the destination array of floats.
+ * @param[in]   base      the initial values; if NULL, the terms are added to dst.
+ * @param[in]   begin     the index of the first float to compute.
+ * @param[in]   end       one past the index of the last float to compute.
+ * @param[in]   terms     the weighted shapes; each dense one is indexed in the same way as dst.
+ * @param[in]   numTerms  the number of terms.
+ * @note        If there are sparse terms, begin and end must lie on vertex boundaries, i.e. be multiples of 3.
+ */
+void DeformAccumulate(float *dst, const float *base, size_t begin, size_t end, const DeformTerm *terms,
+                      unsigned numTerms);
+
+/** The scalar implementation of DeformAccumulate(), for validating the vectorized ones. */
+void DeformAccumulateReference(float *dst, const float *base, size_t begin, size_t end, const DeformTerm *terms,
+                               unsigned numTerms);
+
+/** Select the implementation used by DeformAccumulate().
+ * @param[in]   isa   the desired instruction set.
+ * @return      the instruction set actually selected, which falls back to the best supported if unavailable.
+ */
+DeformISA DeformSetISA(DeformISA isa);
+
+/** Get the instruction set used by DeformAccumulate(). */
+DeformISA DeformGetISA();
+
+/** Get a printable name for an instruction set. */
+const char* DeformISAName(DeformISA isa);
+
+/** Validate each instruction set supported by this CPU against DeformAccumulateReference(), with dense, quantized
+ * and sparse terms, and with ranges that are not aligned to the vector width. The selected instruction set is restored.
+ * @param[in]   verbose   if true, print the result for each instruction set; mismatches are always printed.
+ * @return      true if every instruction set matched the reference within tolerance.
+ */
+bool DeformSelfTest(bool verbose);
+
+#endif // __DEFORM_KERNEL_H
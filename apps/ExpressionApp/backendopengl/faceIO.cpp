@@ -26,11 +26,37 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <chrono>
+#include <limits>
 #include <stack>
 #include <string>
 #include <vector>
 #include <limits.h>
 
+#if (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)) && defined(__has_include)
+  #if __has_include(<charconv>)
+    #include <charconv>                 // Defines __cpp_lib_to_chars if floating-point conversions are supported
+  #endif /* __has_include(<charconv>) */
+#endif /* C++17 */
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define JSON_SSE2_SIMD 1
+  #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+  #define JSON_NEON_SIMD 1
+  #include <arm_neon.h>
+#endif
+
+#ifdef _WIN32
+  #define _WINSOCKAPI_
+  #include <windows.h>
+#else /* UNIX */
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif /* _WIN32 */
+
 #ifdef _MSC_VER
     #define strcasecmp  _stricmp
     #define strncasecmp _strnicmp
@@ -98,6 +124,43 @@ static void CopyUInt32to16Vector(const uint32_t *fr, uint16_t *to, uint32_t n) {
   for (uint16_t *toEnd = to + n; to != toEnd;) *to++ = (uint16_t)(*fr++);
 }
 
+/********************************************************************************
+ * FaceIOQuantize
+ * The range is widened to include zero, and the offset snapped to a multiple of
+ * the scale, so that zero is represented exactly.
+ ********************************************************************************/
+
+void FaceIOQuantize(const float *v, size_t n, int16_t *q, FaceIOQuantization *quant) {
+  float lo = 0.f, hi = 0.f, inv;
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    if (lo > v[i]) lo = v[i];
+    if (hi < v[i]) hi = v[i];
+  }
+  quant->scale  = (hi - lo) / 65532.f;  // Leave some headroom for snapping the offset
+  quant->offset = 0.f;
+  if (!(quant->scale > 0.f)) {
+    quant->scale = 0.f;
+    memset(q, 0, n * sizeof(*q));
+    return;
+  }
+  quant->offset = quant->scale * nearbyintf(0.5f * (hi + lo) / quant->scale);
+  inv = 1.f / quant->scale;
+  for (i = 0; i < n; ++i) {
+    long k = lrintf((v[i] - quant->offset) * inv);
+    q[i] = (int16_t)((k < -32767) ? -32767 : (k > 32767) ? 32767 : k);
+  }
+}
+
+/********************************************************************************
+ * FaceIODequantize
+ ********************************************************************************/
+
+void FaceIODequantize(const int16_t *q, size_t n, const FaceIOQuantization &quant, float *v) {
+  for (const int16_t *qEnd = q + n; q != qEnd;) *v++ = quant.offset + quant.scale * *q++;
+}
+
 /********************************************************************************
  * FaceIOErrorStringFromCode
  ********************************************************************************/
@@ -141,6 +204,98 @@ static void PrintUnknownFormatMessage(const char *file, const char *msg = nullpt
   printf("\"%s\": Unknown format %s\n", file, msg);
 }
 
+/********************************************************************************
+ * FaceIOMapping
+ ********************************************************************************/
+
+struct FaceIOMapping::Impl {
+  const void  *data;
+  size_t      size;
+  #ifdef _WIN32
+    HANDLE    file, mapping;
+  #endif /* _WIN32 */
+};
+
+FaceIOMapping::FaceIOMapping() {
+  pimpl = new Impl;
+  pimpl->data = nullptr;
+  pimpl->size = 0;
+  #ifdef _WIN32
+    pimpl->file = INVALID_HANDLE_VALUE;
+    pimpl->mapping = nullptr;
+  #endif /* _WIN32 */
+}
+
+FaceIOMapping::~FaceIOMapping() {
+  close();
+  delete pimpl;
+}
+
+const void* FaceIOMapping::data() const { return pimpl->data; }
+size_t      FaceIOMapping::size() const { return pimpl->size; }
+
+#ifdef _WIN32
+
+FaceIOErr FaceIOMapping::open(const char *fileName) {
+  FaceIOErr err = kIOErrNone;
+  LARGE_INTEGER z;
+
+  close();
+  pimpl->file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+  BAIL_IF_TRUE(INVALID_HANDLE_VALUE == pimpl->file, err, kIOErrFileNotFound);
+  BAIL_IF_FALSE(GetFileSizeEx(pimpl->file, &z), err, kIOErrRead);
+  BAIL_IF_FALSE(z.QuadPart > 0, err, kIOErrEOF);  // Empty files cannot be mapped
+  pimpl->mapping = CreateFileMappingA(pimpl->file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  BAIL_IF_NULL(pimpl->mapping, err, kIOErrFileOpen);
+  pimpl->data = MapViewOfFile(pimpl->mapping, FILE_MAP_COPY, 0, 0, 0);  // Copy-on-write
+  BAIL_IF_NULL(pimpl->data, err, kIOErrFileOpen);
+  pimpl->size = (size_t)z.QuadPart;
+bail:
+  if (kIOErrNone != err) close();
+  return err;
+}
+
+void FaceIOMapping::close() {
+  if (pimpl->data) UnmapViewOfFile(pimpl->data);
+  if (pimpl->mapping) CloseHandle(pimpl->mapping);
+  if (INVALID_HANDLE_VALUE != pimpl->file) CloseHandle(pimpl->file);
+  pimpl->data = nullptr;
+  pimpl->size = 0;
+  pimpl->mapping = nullptr;
+  pimpl->file = INVALID_HANDLE_VALUE;
+}
+
+#else /* UNIX */
+
+FaceIOErr FaceIOMapping::open(const char *fileName) {
+  FaceIOErr err = kIOErrNone;
+  struct stat st;
+  void *data;
+  int fd;
+
+  close();
+  fd = ::open(fileName, O_RDONLY);
+  BAIL_IF_NEGATIVE(fd, err, kIOErrFileNotFound);
+  BAIL_IF_NONZERO(fstat(fd, &st), err, kIOErrRead);
+  BAIL_IF_NONPOSITIVE(st.st_size, err, kIOErrEOF);  // Empty files cannot be mapped
+  data = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);  // Copy-on-write
+  BAIL_IF_TRUE(MAP_FAILED == data, err, kIOErrFileOpen);
+  pimpl->data = data;
+  pimpl->size = (size_t)st.st_size;
+bail:
+  if (fd >= 0) ::close(fd);  // The mapping persists after the descriptor is closed
+  return err;
+}
+
+void FaceIOMapping::close() {
+  if (pimpl->data) munmap(const_cast<void*>(pimpl->data), pimpl->size);
+  pimpl->data = nullptr;
+  pimpl->size = 0;
+}
+
+#endif /* _WIN32 */
+
 /********************************************************************************
  * ReadFileIntoString
  ********************************************************************************/
@@ -280,6 +435,8 @@ struct EOTypeSize {
 #define FOURCC_PARTITIONS IOFOURCC('P', 'R', 'T', 'S')
 #define FOURCC_PART IOFOURCC('P', 'A', 'R', 'T')
 #define FOURCC_MATERIAL IOFOURCC('M', 'T', 'R', 'L')
+#define FOURCC_QUANTIZED_BASIS IOFOURCC('Q', 'B', 'S', 'S')
+#define FOURCC_QUANTIZED_SHAPE IOFOURCC('Q', 'S', 'H', 'P')
 
 
 /********************************************************************************
@@ -439,6 +596,7 @@ FaceIOErr EOWriter::writeEncapsulationHeader(unsigned type, unsigned size, unsig
 }
 
 FaceIOErr EOWriter::writeData(unsigned size, const void *data) {
+  if (!size) return kIOErrNone;  // Sections that were not supplied, e.g. by ReadEOSFaceModel(), are empty
   return (1 == fwrite(data, size, 1, pimpl->fd)) ? kIOErrNone : kIOErrWrite;
 }
 
@@ -478,6 +636,169 @@ bail:
   return err;
 }
 
+/********************************************************************************
+ ********************************************************************************
+ * EOReader - Encapsulated Object Reader
+ * This reads either from a stdio file, or from a memory-mapped file.
+ ********************************************************************************
+ ********************************************************************************/
+
+class EOReader
+{
+public:
+
+  EOReader();
+  ~EOReader();
+
+  /// Open a file for reading with stdio.
+  /// @param[in]  fileName    the name of the file to be read.
+  /// @return     kIOErrNone      if the file was opened successfully.
+  /// @return     kIOErrFileOpen  if there were problems opening the file for reading.
+  FaceIOErr open(const char *fileName);
+
+  /// Read from a memory-mapped file. The mapping is not owned, and must persist until close().
+  /// @param[in]  map         the memory-mapped file.
+  void open(const FaceIOMapping *map);
+
+  /// Close the file, or detach from the mapping.
+  void close();
+
+  /// Get the size of the file.
+  /// @return the size of the file, in bytes.
+  size_t size() const;
+
+  /// Read data, in the manner of fread().
+  /// @param[out] ptr     a place to store the data. NULL skips over the data.
+  /// @param[in]  size    the size of each element.
+  /// @param[in]  num     the number of elements.
+  /// @return     the number of elements read.
+  size_t read(void *ptr, size_t size, size_t num);
+
+  /// Skip over data.
+  /// @param[in]  size    the number of bytes to skip.
+  /// @return     0 if successful, nonzero otherwise, in the manner of fseek().
+  int skip(size_t size);
+
+  /// Move to an absolute location in the file.
+  /// @param[in]  offset  the offset from the start of the file, in bytes.
+  /// @return     0 if successful, nonzero otherwise, in the manner of fseek().
+  int seek(size_t offset);
+
+  /// Get the current location in the file.
+  /// @return the offset from the start of the file, in bytes.
+  size_t tell() const;
+
+  /// Get a pointer to the data at the current location in the mapping, without advancing.
+  /// @param[in]  size    the number of bytes that will be accessed.
+  /// @return     a pointer to the data, or NULL if not mapped, misaligned, or there are not enough bytes.
+  const void* peek(size_t size) const;
+
+  /// Enable or query whether data are to be offered to the adapter for referencing in place.
+  void setZeroCopy(bool yes) { _zeroCopy = yes; }
+  bool zeroCopy() const { return _zeroCopy; }
+
+private:
+  FILE          *_fd;
+  const uint8_t *_mem;
+  size_t        _size, _pos;
+  bool          _zeroCopy;
+};
+
+EOReader::EOReader() {
+  _fd       = nullptr;
+  _mem      = nullptr;
+  _size     = 0;
+  _pos      = 0;
+  _zeroCopy = false;
+}
+
+EOReader::~EOReader() {
+  close();
+}
+
+FaceIOErr EOReader::open(const char *fileName) {
+  long z;
+  close();
+  #ifndef _MSC_VER
+    _fd = fopen(fileName, "rb");
+  #else  /* _MSC_VER */
+    if (0 != fopen_s(&_fd, fileName, "rb"))
+      _fd = nullptr;
+  #endif /* _MSC_VER */
+  if (!_fd) return kIOErrFileOpen;
+  if (fseek(_fd, 0L, SEEK_END) || (z = ftell(_fd)) < 0 || fseek(_fd, 0L, SEEK_SET)) {
+    close();
+    return kIOErrRead;
+  }
+  _size = (size_t)z;
+  return kIOErrNone;
+}
+
+void EOReader::open(const FaceIOMapping *map) {
+  close();
+  _mem  = (const uint8_t*)map->data();
+  _size = map->size();
+}
+
+void EOReader::close() {
+  if (_fd) fclose(_fd);
+  _fd       = nullptr;
+  _mem      = nullptr;
+  _size     = 0;
+  _pos      = 0;
+  _zeroCopy = false;
+}
+
+size_t EOReader::size() const {
+  return _size;
+}
+
+size_t EOReader::read(void *ptr, size_t size, size_t num) {
+  if (_fd) {
+    if (ptr) return fread(ptr, size, num, _fd);
+    return skip(size * num) ? 0 : num;
+  }
+  if (size && num > (_size - _pos) / size)  // Only read whole elements
+    num = (_size - _pos) / size;
+  if (ptr) memcpy(ptr, _mem + _pos, size * num);
+  _pos += size * num;
+  return num;
+}
+
+int EOReader::skip(size_t size) {
+  if (_fd) {
+    if (size > LONG_MAX) return -1;  // Check for overflow before cast
+    return fseek(_fd, (long)size, SEEK_CUR);
+  }
+  if (size > _size - _pos) return -1;
+  _pos += size;
+  return 0;
+}
+
+int EOReader::seek(size_t offset) {
+  if (offset > _size) return -1;
+  if (_fd) {
+    if (offset > LONG_MAX) return -1;
+    return fseek(_fd, (long)offset, SEEK_SET);
+  }
+  _pos = offset;
+  return 0;
+}
+
+size_t EOReader::tell() const {
+  if (_fd) {
+    long z = ftell(_fd);
+    return (z < 0) ? _size : (size_t)z;
+  }
+  return _pos;
+}
+
+const void* EOReader::peek(size_t size) const {
+  if (!_mem || size > _size - _pos || ((uintptr_t)(_mem + _pos) & (sizeof(float) - 1)))
+    return nullptr;
+  return _mem + _pos;
+}
+
 /********************************************************************************
  ********************************************************************************
  * JSON reader and writer
@@ -494,11 +815,22 @@ enum JSONNodeType {
   kJSONNull
 };
 
+/* The types into which the numbers of an array can be read in bulk (see JSONInfo::arrayType). */
+enum JSONNumericType {
+  kJSONNumericNone,     ///< Deliver the elements of the array one at a time, through the node callbacks.
+  kJSONNumericUInt16,   ///< Append the numbers to a std::vector<uint16_t>.
+  kJSONNumericInt32,    ///< Append the numbers to a std::vector<int32_t>.
+  kJSONNumericFloat,    ///< Append the numbers to a std::vector<float>.
+  kJSONNumericDouble    ///< Append the numbers to a std::vector<double>.
+};
+
 struct JSONInfo {
   void *userData;
   JSONNodeType type;
   const char *value;
   double number;
+  JSONNumericType arrayType;  ///< When an array is opened, set this to read all of its numbers at once, ...
+  void *arrayVector;          ///< ... into the std::vector of that type, before the array is closed.
 };
 
 typedef FaceIOErr (*JSONOpenNodeProc)(JSONInfo *info);
@@ -535,6 +867,7 @@ class JSONReader {
   JSONInfo _infoBack;
   void skipWhiteSpace();
   FaceIOErr readNumber();
+  template <typename T> FaceIOErr readNumbers(std::vector<T> *v);
   FaceIOErr readString();
   FaceIOErr readValue();
   FaceIOErr readArray();
@@ -547,6 +880,8 @@ class JSONWriter {
   JSONWriter();
   ~JSONWriter();
   FaceIOErr open(const char *file);
+  FaceIOErr open(FaceIOWriteProc proc, void *userData);
+  FaceIOErr flush();
   FaceIOErr close();
   void openObject(const char *tag = nullptr);
   void closeObject();
@@ -576,9 +911,39 @@ JSONReader::JSONReader(JSONOpenNodeProc openNode, JSONCloseNodeProc closeNode) {
   _infoBack.type     = kJSONNull;
   _infoBack.value    = nullptr;
   _infoBack.number   = NAN;
+  _infoBack.arrayType   = kJSONNumericNone;
+  _infoBack.arrayVector = nullptr;
 }
 
+/* The indentation of pretty-printed files is skipped 16 characters at a time, before finishing one at a time. */
 void JSONReader::skipWhiteSpace() {
+#if defined(JSON_SSE2_SIMD)
+  const __m128i sp = _mm_set1_epi8(' '), nl = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r'), tb = _mm_set1_epi8('\t');
+  for (; _jsonLen >= 16; _jsonStr += 16, _jsonLen -= 16) {
+    __m128i c = _mm_loadu_si128((const __m128i*)_jsonStr);
+    unsigned ws = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(c, sp), _mm_cmpeq_epi8(c, nl)),
+                                                           _mm_or_si128(_mm_cmpeq_epi8(c, cr), _mm_cmpeq_epi8(c, tb))));
+    if (0xFFFF != ws) {
+      #ifdef _MSC_VER
+        unsigned long n;
+        _BitScanForward(&n, ~ws);
+      #else  /* !_MSC_VER */
+        unsigned n = (unsigned)__builtin_ctz(~ws);
+      #endif /* !_MSC_VER */
+      _jsonStr += n;
+      _jsonLen -= n;
+      return;
+    }
+  }
+#elif defined(JSON_NEON_SIMD)
+  const uint8x16_t sp = vdupq_n_u8(' '), nl = vdupq_n_u8('\n'), cr = vdupq_n_u8('\r'), tb = vdupq_n_u8('\t');
+  for (; _jsonLen >= 16; _jsonStr += 16, _jsonLen -= 16) {
+    uint8x16_t c = vld1q_u8((const uint8_t*)_jsonStr);
+    uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(c, sp), vceqq_u8(c, nl)), vorrq_u8(vceqq_u8(c, cr), vceqq_u8(c, tb)));
+    if (0xFF != vminvq_u8(ws))
+      break;                                                  /* The scalar loop finds the end */
+  }
+#endif /* JSON_NEON_SIMD */
   for (; _jsonLen && isspace(*_jsonStr); ++_jsonStr, --_jsonLen) {}
 }
 
@@ -677,17 +1042,32 @@ bail:
 
 FaceIOErr JSONReader::readArray() {
   FaceIOErr err;
+  JSONNumericType arrayType;
+  void *arrayVector;
 
   _infoBack.type = kJSONArray;
   _infoBack.value = nullptr;
+  _infoBack.arrayType = kJSONNumericNone;
+  _infoBack.arrayVector = nullptr;
   BAIL_IF_ERR(err = (*_openNode)(&_infoBack));
+  arrayType = _infoBack.arrayType;                    /* Nested arrays must not inherit the request */
+  arrayVector = _infoBack.arrayVector;
+  _infoBack.arrayType = kJSONNumericNone;
   BAIL_IF_FALSE('[' == _jsonStr[0], err, kIOErrSyntax); /* We always enter in this state */
   --_jsonLen;
   BAIL_IF_ZERO(_jsonLen, err, kIOErrEOF);
   ++_jsonStr;
   skipWhiteSpace();
 
-  if (']' != _jsonStr[0]) {
+  switch (arrayType) {
+    case kJSONNumericUInt16:  BAIL_IF_ERR(err = readNumbers((std::vector<uint16_t>*)arrayVector)); break;
+    case kJSONNumericInt32:   BAIL_IF_ERR(err = readNumbers((std::vector<int32_t>*)arrayVector));  break;
+    case kJSONNumericFloat:   BAIL_IF_ERR(err = readNumbers((std::vector<float>*)arrayVector));    break;
+    case kJSONNumericDouble:  BAIL_IF_ERR(err = readNumbers((std::vector<double>*)arrayVector));   break;
+    default:                  break;
+  }
+
+  if (kJSONNumericNone == arrayType && ']' != _jsonStr[0]) {
     do {
       skipWhiteSpace();
       BAIL_IF_ERR(err = readValue());
@@ -733,6 +1113,117 @@ bail:
   return err;
 }
 
+/********************************************************************************
+ * JSONParseNumber
+ * Integers are converted exactly, without a detour through double precision; other numbers are converted as by
+ * std::from_chars() where the library supports it, or strtod() otherwise. Either way, there are no per-element
+ * allocations or locale lookups. Returns s if there is no number there, or NULL if it does not fit in a T.
+ ********************************************************************************/
+
+template <typename T>
+static bool JSONNumberFits(double d) {
+  if (std::numeric_limits<T>::is_integer)
+    return d >= (double)std::numeric_limits<T>::lowest() && d <= (double)std::numeric_limits<T>::max();
+  return !(fabs(d) > (double)std::numeric_limits<T>::max());
+}
+
+template <typename T>
+static const char *JSONParseNumber(const char *s, const char *end, T *x) {
+  const char *p = s;
+  bool neg = false;
+  uint64_t u = 0;
+
+  if (p != end && ('-' == *p || '+' == *p)) neg = ('-' == *p++);
+  const char *digits = p;
+  for (; p != end && (unsigned)(*p - '0') < 10u && p - digits < 18; ++p)
+    u = u * 10 + (unsigned)(*p - '0');
+  if (p != digits && (p == end || ((unsigned)(*p - '0') >= 10u && '.' != *p && 'e' != *p && 'E' != *p))) {
+    int64_t i = neg ? -(int64_t)u : (int64_t)u;               /* A plain integer */
+    if (!JSONNumberFits<T>((double)i)) return nullptr;
+    *x = (T)i;
+    return p;
+  }
+
+  double d;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  p = s + (('+' == *s) ? 1 : 0);                              /* from_chars() rejects a leading plus */
+  std::from_chars_result r = std::from_chars(p, end, d);
+  if (std::errc() != r.ec) return s;
+  p = r.ptr;
+#else  /* !__cpp_lib_to_chars */
+  char *endPtr;
+  d = strtod(s, &endPtr);
+  p = endPtr;
+  if (p > end) return s;
+#endif /* !__cpp_lib_to_chars */
+  if (!JSONNumberFits<T>(d)) return nullptr;
+  *x = (T)d;
+  return p;
+}
+
+/********************************************************************************
+ * JSONReader::readNumbers
+ * Read the elements of an array, from just after its opening bracket up to its closing bracket, as numbers.
+ * Elements that are themselves arrays, or objects whose members are all numbers (as cereal writes fixed-size arrays),
+ * are flattened into the sequence; anything else is a syntax error.
+ ********************************************************************************/
+
+template <typename T>
+FaceIOErr JSONReader::readNumbers(std::vector<T> *v) {
+  FaceIOErr err = kIOErrNone;
+  const char *end = _jsonStr + _jsonLen, *p;
+  std::vector<char> closers;                                  /* The brackets of the nested arrays and objects */
+  std::string name;
+  char closer;
+  T x;
+
+  BAIL_IF_NULL(v, err, kIOErrNullPointer);
+  while (1) {
+    skipWhiteSpace();                                         /* Expect an element, or the end of the container */
+    BAIL_IF_ZERO(_jsonLen, err, kIOErrEOF);
+    closer = closers.empty() ? ']' : closers.back();
+    if (closer == _jsonStr[0]) {
+      if (closers.empty())
+        break;                                                /* The caller consumes the array's closing bracket */
+      closers.pop_back();
+      ++_jsonStr;
+      --_jsonLen;
+    } else {
+      if ('}' == closer) {                                    /* Skip the name of a member */
+        BAIL_IF_ERR(err = getString(&name));
+        skipWhiteSpace();
+        BAIL_IF_FALSE(_jsonLen && ':' == _jsonStr[0], err, kIOErrSyntax);
+        ++_jsonStr;
+        --_jsonLen;
+        skipWhiteSpace();
+        BAIL_IF_ZERO(_jsonLen, err, kIOErrEOF);
+      } else if ('[' == _jsonStr[0] || '{' == _jsonStr[0]) {  /* Members must be numbers, elements need not be */
+        closers.push_back('[' == _jsonStr[0] ? ']' : '}');
+        ++_jsonStr;
+        --_jsonLen;
+        continue;
+      }
+      p = JSONParseNumber(_jsonStr, end, &x);
+      BAIL_IF_NULL(p, err, kIOErrFormat);                     /* Out of range for the element type */
+      BAIL_IF_TRUE(p == _jsonStr, err, kIOErrSyntax);
+      v->push_back(x);
+      _jsonLen -= p - _jsonStr;
+      _jsonStr = p;
+    }
+    skipWhiteSpace();                                         /* Expect a comma, or the end of the container */
+    BAIL_IF_ZERO(_jsonLen, err, kIOErrEOF);
+    if (',' == _jsonStr[0]) {
+      ++_jsonStr;
+      --_jsonLen;
+    } else {
+      BAIL_IF_FALSE((closers.empty() ? ']' : closers.back()) == _jsonStr[0], err, kIOErrSyntax);
+    }
+  }
+
+bail:
+  return err;
+}
+
 FaceIOErr JSONReader::readValue() {
   static const char kTrue[] = "true", kFalse[] = "false", kNull[] = "null";
   FaceIOErr err = kIOErrNotValue;
@@ -806,47 +1297,138 @@ FaceIOErr JSONReader::parse(const char *fileName, void *userState) {
 }
 
 
+/********************************************************************************
+ * JSONWriter::Impl
+ * Output is formatted into a large buffer, which is handed to the file or to the user's procedure when it fills up.
+ * Floating-point numbers are formatted as the shortest strings that read back to the same value, where the library
+ * supports std::to_chars() for them; otherwise, with enough digits to read back to the same value.
+ ********************************************************************************/
+
 class JSONWriter::Impl {
  public:
+  enum {
+    kBufferSize = 1 << 16,  ///< The size of the buffer, in bytes.
+    kMaxNumber  = 32        ///< The most characters that any number can be formatted into.
+  };
   int level;
   FILE *fd;
+  FaceIOWriteProc proc;
+  void *procData;
+  FaceIOErr err;            ///< The first error that occurred while writing; later output is discarded.
   std::stack<int> count;
+  char *pos;
+  char buf[kBufferSize];
+
+  Impl() : level(0), fd(nullptr), proc(nullptr), procData(nullptr), err(kIOErrNone), pos(buf) {}
+  void reserve(size_t n) { if ((size_t)(buf + kBufferSize - pos) < n) flush(); }
+  void put(char c) { reserve(1); *pos++ = c; }
+  void write(const char *str, size_t n);
+  void write(const char *str) { write(str, strlen(str)); }
+  void writeNumber(float x);
+  void writeNumber(double x);
+  void writeNumber(int x);
+  void writeNumber(unsigned x);
+  void writeNumber(unsigned short x) { writeNumber((unsigned)x); }
+  void writeNumber(unsigned char x) { writeNumber((unsigned)x); }
+  FaceIOErr flush();
   void doIndent();
   void maybeComma();
   void maybeTag(const char *tag);
   void commaIndentTag(const char *tag);
-  template<typename T> void writeArray(unsigned n, const T *v, unsigned maxRow, const char *fmt, const char *tag);
+  template<typename T> void writeArray(unsigned n, const T *v, unsigned maxRow, const char *tag);
   void openObject(const char *tag);
   void closeObject();
   void openArray(const char *tag);
   void closeArray();
 };
 
+FaceIOErr JSONWriter::Impl::flush() {
+  size_t n = pos - buf;
+  pos = buf;
+  if (!n || kIOErrNone != err) return err;
+  if (proc)
+    err = (*proc)(procData, buf, n);
+  else if (!fd || n != fwrite(buf, 1, n, fd))
+    err = kIOErrWrite;
+  return err;
+}
+
+void JSONWriter::Impl::write(const char *str, size_t n) {
+  for (size_t k; n; str += k, n -= k) {
+    reserve(1);
+    k = buf + kBufferSize - pos;
+    if (k > n) k = n;
+    memcpy(pos, str, k);
+    pos += k;
+  }
+}
+
+static char *JSONFormatUInt(char *p, uint64_t u) {
+  char tmp[20], *t = tmp + sizeof(tmp);
+  do { *--t = (char)('0' + u % 10); } while (u /= 10);
+  memcpy(p, t, tmp + sizeof(tmp) - t);
+  return p + (tmp + sizeof(tmp) - t);
+}
+
+void JSONWriter::Impl::writeNumber(unsigned x) {
+  reserve(kMaxNumber);
+  pos = JSONFormatUInt(pos, x);
+}
+
+void JSONWriter::Impl::writeNumber(int x) {
+  reserve(kMaxNumber);
+  if (x < 0) *pos++ = '-';
+  pos = JSONFormatUInt(pos, (x < 0) ? (0 - (uint64_t)(int64_t)x) : (uint64_t)x);
+}
+
+void JSONWriter::Impl::writeNumber(float x) {
+  reserve(kMaxNumber);
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  pos = std::to_chars(pos, buf + kBufferSize, x).ptr;
+#else  /* !__cpp_lib_to_chars */
+  pos += snprintf(pos, kMaxNumber, "%.9g", x);
+#endif /* !__cpp_lib_to_chars */
+}
+
+void JSONWriter::Impl::writeNumber(double x) {
+  reserve(kMaxNumber);
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  pos = std::to_chars(pos, buf + kBufferSize, x).ptr;
+#else  /* !__cpp_lib_to_chars */
+  pos += snprintf(pos, kMaxNumber, "%.17g", x);
+#endif /* !__cpp_lib_to_chars */
+}
+
 void JSONWriter::Impl::doIndent() {
-  for (int i = level * 2; i-- > 0;) putc(' ', fd);
+  size_t n = level * 2;
+  reserve(n);
+  memset(pos, ' ', n);
+  pos += n;
 }
 
 void JSONWriter::Impl::maybeComma() {
   if (count.top())
-    putc(',', fd);
+    put(',');
   count.top()++;
 }
 
 void JSONWriter::Impl::maybeTag(const char *tag) {
   if (!tag) return;
-  fprintf(fd, "\"%s\": ", tag);
+  put('"');
+  write(tag);
+  write("\": ", 3);
 }
 
 void JSONWriter::Impl::commaIndentTag(const char *tag) {
   maybeComma();
-  if (level) putc('\n', fd);
+  if (level) put('\n');
   doIndent();
   maybeTag(tag);
 }
 void JSONWriter::Impl::openObject(const char *tag)
 {
   commaIndentTag(tag);
-  putc('{', fd);
+  put('{');
   ++(level);
   count.push(0);
 }
@@ -854,16 +1436,16 @@ void JSONWriter::Impl::openObject(const char *tag)
 void JSONWriter::Impl::closeObject()
 {
   --(level);
-  putc('\n', fd);
+  put('\n');
   doIndent();
-  putc('}', fd);
+  put('}');
   count.pop();
 }
 
 void JSONWriter::Impl::openArray(const char *tag)
 {
   commaIndentTag(tag);
-  putc('[', fd);
+  put('[');
   ++(level);
   count.push(0);
 }
@@ -871,26 +1453,26 @@ void JSONWriter::Impl::openArray(const char *tag)
 void JSONWriter::Impl::closeArray()
 {
   --(level);
-  putc('\n', fd);
+  put('\n');
   doIndent();
-  putc(']', fd);
+  put(']');
   count.pop();
 }
 
 JSONWriter::JSONWriter() {
   pimpl = new Impl();
-  pimpl->level = 0;
-  pimpl->fd = nullptr;
   pimpl->count.push(0);
 }
 
 JSONWriter::~JSONWriter() {
+  (void)pimpl->flush();
   if (pimpl->fd && pimpl->fd != stdout) fclose(pimpl->fd);
   delete pimpl;
 }
 
 FaceIOErr JSONWriter::open(const char *file) {
-  if (pimpl->fd && pimpl->fd != stdout) (void)(this->close());
+  if (pimpl->fd || pimpl->proc) (void)(this->close());
+  pimpl->err = kIOErrNone;
   if (file && file[0]) {
     #ifndef _MSC_VER
       pimpl->fd = fopen(file, "w");
@@ -904,11 +1486,31 @@ FaceIOErr JSONWriter::open(const char *file) {
   return pimpl->fd ? kIOErrNone : kIOErrWrite;
 }
 
+FaceIOErr JSONWriter::open(FaceIOWriteProc proc, void *userData) {
+  if (pimpl->fd || pimpl->proc) (void)(this->close());
+  pimpl->err = kIOErrNone;
+  pimpl->proc = proc;
+  pimpl->procData = userData;
+  return proc ? kIOErrNone : kIOErrNullPointer;
+}
+
+FaceIOErr JSONWriter::flush() {
+  FaceIOErr err = pimpl->flush();
+  if (kIOErrNone == err && pimpl->fd && 0 != fflush(pimpl->fd))
+    err = pimpl->err = kIOErrWrite;
+  return err;
+}
+
 FaceIOErr JSONWriter::close() {
-  putc('\n', pimpl->fd);
-  if (pimpl->fd && pimpl->fd != stdout) (void)fclose(pimpl->fd);
+  FaceIOErr err;
+  pimpl->put('\n');
+  err = pimpl->flush();
+  if (pimpl->fd && pimpl->fd != stdout && 0 != fclose(pimpl->fd) && kIOErrNone == err)
+    err = kIOErrWrite;
   pimpl->fd = nullptr;
-  return kIOErrNone;
+  pimpl->proc = nullptr;
+  pimpl->procData = nullptr;
+  return err;
 }
 
 void JSONWriter::openObject(const char *tag) {
@@ -928,24 +1530,24 @@ void JSONWriter::closeArray() {
 }
 
 template<typename T>
-void JSONWriter::Impl::writeArray(unsigned n, const T * v, unsigned maxRow, const char *fmt, const char * tag)
+void JSONWriter::Impl::writeArray(unsigned n, const T * v, unsigned maxRow, const char * tag)
 {
   openArray(tag);
-  putc('\n', fd);
+  put('\n');
   if (n) {
-    for (; n > maxRow; n -= maxRow) {
+    for (; n > maxRow; n -= maxRow) {     /* Full rows end with a comma */
       doIndent();
       for (unsigned i = maxRow; i--; ++v) {
-        fprintf(fd, fmt, *v, (i ? ' ' : '\n'));
-        putc(',', fd);
-        putc((i ? ' ' : '\n'), fd);
+        writeNumber(*v);
+        put(',');
+        put((i ? ' ' : '\n'));
       }
     }
     doIndent();
-    for (; n--; ++v) {
-      fprintf(fd, fmt, *v, (n ? ", " : ""));
+    for (; n--; ++v) {                    /* The last row does not */
+      writeNumber(*v);
       if (n)
-        fprintf(fd, ", ");
+        write(", ", 2);
     }
   }
   closeArray();
@@ -953,43 +1555,45 @@ void JSONWriter::Impl::writeArray(unsigned n, const T * v, unsigned maxRow, cons
 
 
 void JSONWriter::writeNumericArray(unsigned n, const float *v, unsigned maxRow, const char *tag) {
-  pimpl->writeArray(n, v, maxRow, "%.8g", tag);
+  pimpl->writeArray(n, v, maxRow, tag);
 }
 
 void JSONWriter::writeNumericArray(unsigned n, const double *v, unsigned maxRow, const char *tag) {
-  pimpl->writeArray(n, v, maxRow, "%.17g", tag);
+  pimpl->writeArray(n, v, maxRow, tag);
 }
 
 void JSONWriter::writeNumericArray(unsigned n, const int *v, unsigned maxRow, const char *tag) {
-  pimpl->writeArray(n, v, maxRow, "%d", tag);
+  pimpl->writeArray(n, v, maxRow, tag);
 }
 
 void JSONWriter::writeNumericArray(unsigned n, const unsigned short *v, unsigned maxRow, const char *tag) {
-  pimpl->writeArray(n, v, maxRow, "%u", tag);
+  pimpl->writeArray(n, v, maxRow, tag);
 }
 
 void JSONWriter::writeNumericArray(unsigned n, const unsigned char *v, unsigned maxRow, const char *tag) {
-  pimpl->writeArray(n, v, maxRow, "%u", tag);
+  pimpl->writeArray(n, v, maxRow, tag);
 }
 
 void JSONWriter::writeNumber(double number, const char *tag) {
   pimpl->commaIndentTag(tag);
-  fprintf(pimpl->fd, "%.17g", number);
+  pimpl->writeNumber(number);
 }
 
 void JSONWriter::writeString(const char *str, const char *tag) {
   pimpl->commaIndentTag(tag);
-  fprintf(pimpl->fd, "\"%s\"", str);
+  pimpl->put('"');
+  pimpl->write(str);
+  pimpl->put('"');
 }
 
 void JSONWriter::writeBool(bool value, const char *tag) {
   pimpl->commaIndentTag(tag);
-  fprintf(pimpl->fd, "%s", value ? "true" : "false");
+  pimpl->write(value ? "true" : "false");
 }
 
 void JSONWriter::writeNull(const char *tag) {
   pimpl->commaIndentTag(tag);
-  fprintf(pimpl->fd, "null");
+  pimpl->write("null", 4);
 }
 
 
@@ -1018,28 +1622,113 @@ FaceIOErr NVFWriteOpaqueObject(uint32_t type, uint32_t size, const ElementType *
 
 }  // namespace
 
-static uint32_t NVFSizeShapeModel(const FaceIOAdapter *fac) {
+/* Quantized data are padded to a multiple of 4 bytes, to keep the objects that follow aligned. */
+static uint32_t NVFSizeQuantized(uint32_t n) {
+  return (uint32_t)((n * sizeof(int16_t) + 3) & ~3u);
+}
+
+static FaceIOErr NVFWriteQuantized(uint32_t n, const int16_t *q, EOWriter &wtr) {
+  static const uint32_t zero = 0;
+  uint32_t size = n * sizeof(*q), pad = NVFSizeQuantized(n) - size;
+  FaceIOErr err = kIOErrNone;
+  if (size) err = wtr.writeData(size, q);
+  if (!err && pad) err = wtr.writeData(pad, &zero);
+  return err;
+}
+
+static bool NVFShapeModesQuantized(const FaceIOAdapter *fac, unsigned options) {
+  return (options & kIOWriteQuantizeShapes) || (fac->getQuantizedShapeModes() && fac->getShapeModesQuantization());
+}
+
+static bool NVFBlendShapeQuantized(const FaceIOAdapter *fac, uint32_t i, unsigned options) {
+  return (options & kIOWriteQuantizeShapes) || (fac->getQuantizedBlendShape(i) && fac->getBlendShapeQuantization(i));
+}
+
+/* QBSS: { numModes, modeSize, FaceIOQuantization[numModes], int16_t[numModes * modeSize], padding } */
+static uint32_t NVFSizeQuantizedShapeModes(const FaceIOAdapter *fac) {
+  return (uint32_t)(2 * sizeof(uint32_t) + fac->getShapeNumModes() * sizeof(FaceIOQuantization))
+       + NVFSizeQuantized(fac->getShapeModesSize());
+}
+
+static FaceIOErr NVFWriteQuantizedShapeModes(const FaceIOAdapter *fac, EOWriter &wtr) {
+  FaceIOErr err;
+  uint32_t hdr[2] = { fac->getShapeNumModes(), 0 }, size = fac->getShapeModesSize(), i;
+  const int16_t *q = fac->getQuantizedShapeModes();
+  const FaceIOQuantization *quant = fac->getShapeModesQuantization();
+  std::vector<int16_t> qBuf;
+  std::vector<FaceIOQuantization> quantBuf;
+
+  if (hdr[0]) hdr[1] = size / hdr[0];
+  if (!q || !quant) {  // Quantize each mode on the fly
+    const float *v = fac->getShapeModes();
+    qBuf.resize(size);
+    quantBuf.resize(hdr[0]);
+    for (i = 0; i < hdr[0]; ++i)
+      FaceIOQuantize(v + i * hdr[1], hdr[1], qBuf.data() + i * hdr[1], &quantBuf[i]);
+    q = qBuf.data();
+    quant = quantBuf.data();
+  }
+  BAIL_IF_ERR(err = wtr.writeEncapsulationHeader(FOURCC_QUANTIZED_BASIS, NVFSizeQuantizedShapeModes(fac), 0));
+  BAIL_IF_ERR(err = wtr.writeData(sizeof(hdr), hdr));
+  if (hdr[0]) BAIL_IF_ERR(err = wtr.writeData(hdr[0] * sizeof(*quant), quant));
+  BAIL_IF_ERR(err = NVFWriteQuantized(size, q, wtr));
+bail:
+  return err;
+}
+
+/* QSHP: { size, FaceIOQuantization, int16_t[size], padding } */
+static uint32_t NVFSizeQuantizedBlendShape(const FaceIOAdapter *fac, uint32_t i) {
+  return (uint32_t)(sizeof(uint32_t) + sizeof(FaceIOQuantization)) + NVFSizeQuantized(fac->getBlendShapeSize(i));
+}
+
+static FaceIOErr NVFWriteQuantizedBlendShape(const FaceIOAdapter *fac, uint32_t i, EOWriter &wtr) {
+  FaceIOErr err;
+  uint32_t size = fac->getBlendShapeSize(i);
+  const int16_t *q = fac->getQuantizedBlendShape(i);
+  const FaceIOQuantization *quant = fac->getBlendShapeQuantization(i);
+  FaceIOQuantization quantBuf;
+  std::vector<int16_t> qBuf;
+
+  if (!q || !quant) {  // Quantize on the fly
+    qBuf.resize(size);
+    FaceIOQuantize(fac->getBlendShape(i), size, qBuf.data(), &quantBuf);
+    q = qBuf.data();
+    quant = &quantBuf;
+  }
+  BAIL_IF_ERR(err = wtr.writeEncapsulationHeader(FOURCC_QUANTIZED_SHAPE, NVFSizeQuantizedBlendShape(fac, i), 0));
+  BAIL_IF_ERR(err = wtr.writeData(sizeof(size), &size));
+  BAIL_IF_ERR(err = wtr.writeData(sizeof(*quant), quant));
+  BAIL_IF_ERR(err = NVFWriteQuantized(size, q, wtr));
+bail:
+  return err;
+}
+
+static uint32_t NVFSizeShapeModel(const FaceIOAdapter *fac, unsigned options) {
   uint32_t size = 8 + NVFSize(fac->getShapeMeanSize(), fac->getShapeMean())
-                + 8 + NVFSize(fac->getShapeModesSize(), fac->getShapeModes())
-                + sizeof(uint32_t)
+                + 8 + (NVFShapeModesQuantized(fac, options) ? NVFSizeQuantizedShapeModes(fac)
+                      : NVFSize(fac->getShapeModesSize(), fac->getShapeModes()) + (uint32_t)sizeof(uint32_t))
                 + 8 + NVFSize(fac->getShapeEigenvaluesSize(), fac->getShapeEigenvalues())
                 + 8 + NVFSize(fac->getTriangleListSize(), fac->getTriangleList());
   return size;
 }
 
-static FaceIOErr NVFWriteShapeModel(const FaceIOAdapter *fac, EOWriter &wtr) {
+static FaceIOErr NVFWriteShapeModel(const FaceIOAdapter *fac, EOWriter &wtr, unsigned options) {
   FaceIOErr err;
   uint32_t numModes = fac->getShapeNumModes(), sizeNumMode = sizeof(uint32_t),
            sizeMean = NVFSize(fac->getShapeMeanSize(), fac->getShapeMean()),
-           sizeModes = NVFSize(fac->getShapeModesSize(), fac->getShapeModes()),
            sizeEigen = NVFSize(fac->getShapeEigenvaluesSize(), fac->getShapeEigenvalues()),
            sizeTriList = NVFSize(fac->getTriangleListSize(), fac->getTriangleList()),
-           size = 8 + sizeMean + 8 + sizeModes + sizeNumMode + 8 + sizeEigen + 8 + sizeTriList;
+           size = NVFSizeShapeModel(fac, options);
   BAIL_IF_ERR(err = wtr.writeEncapsulationHeader(FOURCC_SHAPE, size, 0));
   BAIL_IF_ERR(err = wtr.writeOpaqueObject(FOURCC_MEAN, sizeMean, fac->getShapeMean(), 0));
-  BAIL_IF_ERR(err = wtr.writeEncapsulationHeader(FOURCC_BASIS, sizeModes + sizeNumMode, 0));
-  BAIL_IF_ERR(err = wtr.writeData(sizeNumMode, &numModes));
-  BAIL_IF_ERR(err = wtr.writeData(sizeModes, fac->getShapeModes()));
+  if (NVFShapeModesQuantized(fac, options)) {
+    BAIL_IF_ERR(err = NVFWriteQuantizedShapeModes(fac, wtr));
+  } else {
+    uint32_t sizeModes = NVFSize(fac->getShapeModesSize(), fac->getShapeModes());
+    BAIL_IF_ERR(err = wtr.writeEncapsulationHeader(FOURCC_BASIS, sizeModes + sizeNumMode, 0));
+    BAIL_IF_ERR(err = wtr.writeData(sizeNumMode, &numModes));
+    BAIL_IF_ERR(err = wtr.writeData(sizeModes, fac->getShapeModes()));
+  }
   BAIL_IF_ERR(err = wtr.writeOpaqueObject(FOURCC_EIGENVALUES, sizeEigen, fac->getShapeEigenvalues(), 0));
   BAIL_IF_ERR(err = wtr.writeOpaqueObject(FOURCC_TRIANGLE_LIST, sizeTriList, fac->getTriangleList(), 0));
 bail:
@@ -1077,8 +1766,8 @@ bail:
   return err;
 }
 
-static uint32_t NVFSizeMorphableModel(const FaceIOAdapter *fac) {
-  uint32_t  size        = 8 + NVFSizeShapeModel(fac),
+static uint32_t NVFSizeMorphableModel(const FaceIOAdapter *fac, unsigned options) {
+  uint32_t  size        = 8 + NVFSizeShapeModel(fac, options),
             textureSize = NVFSize(fac->getTextureCoordinatesSize(), fac->getTextureCoordinates()),
             colorSize   = NVFSizeColorModel(fac);
   if (textureSize) size += 8 + textureSize;
@@ -1086,12 +1775,12 @@ static uint32_t NVFSizeMorphableModel(const FaceIOAdapter *fac) {
   return size;
 }
 
-static FaceIOErr NVFWriteMorphableModel(const FaceIOAdapter *fac, EOWriter &wtr) {
+static FaceIOErr NVFWriteMorphableModel(const FaceIOAdapter *fac, EOWriter &wtr, unsigned options) {
   FaceIOErr err;
   uint32_t size;
 
   /* Write the shape model */
-  BAIL_IF_ERR(err = NVFWriteShapeModel(fac, wtr));
+  BAIL_IF_ERR(err = NVFWriteShapeModel(fac, wtr, options));
 
   /* Write the color model */
   BAIL_IF_ERR(err = NVFWriteColorModel(fac, wtr));
@@ -1118,17 +1807,18 @@ bail:
   return err;
 }
 
-static uint32_t NVFSizeBlendShapes(const FaceIOAdapter *fac) {
+static uint32_t NVFSizeBlendShapes(const FaceIOAdapter *fac, unsigned options) {
   uint32_t size = sizeof(uint32_t),  // sizeof(numShapes)
       numShapes = fac->getNumBlendShapes(), i;
   for (i = 0; i < numShapes; ++i) {
     size += 8 + NVFSizeString(fac->getBlendShapeName(i));
-    size += 8 + NVFSize(fac->getBlendShapeSize(i), fac->getBlendShape(i));
+    size += 8 + (NVFBlendShapeQuantized(fac, i, options) ? NVFSizeQuantizedBlendShape(fac, i)
+                                                          : NVFSize(fac->getBlendShapeSize(i), fac->getBlendShape(i)));
   }
   return size;
 }
 
-static FaceIOErr NVFWriteBlendShapes(const FaceIOAdapter *fac, EOWriter &wtr) {
+static FaceIOErr NVFWriteBlendShapes(const FaceIOAdapter *fac, EOWriter &wtr, unsigned options) {
   FaceIOErr err = kIOErrNone;
   uint32_t numShapes = fac->getNumBlendShapes();
   uint32_t i;
@@ -1138,7 +1828,10 @@ static FaceIOErr NVFWriteBlendShapes(const FaceIOAdapter *fac, EOWriter &wtr) {
     const char *str = fac->getBlendShapeName(i);
     BAIL_IF_ERR(err = wtr.writeEncapsulationHeader(FOURCC_NAME, NVFSizeString(str)));
     BAIL_IF_ERR(err = NVFWriteString(str, wtr));
-    BAIL_IF_ERR(err = NVFWriteOpaqueObject(FOURCC_SHAPE, fac->getBlendShapeSize(i), fac->getBlendShape(i), wtr));
+    if (NVFBlendShapeQuantized(fac, i, options))
+      BAIL_IF_ERR(err = NVFWriteQuantizedBlendShape(fac, i, wtr));
+    else
+      BAIL_IF_ERR(err = NVFWriteOpaqueObject(FOURCC_SHAPE, fac->getBlendShapeSize(i), fac->getBlendShape(i), wtr));
   }
 bail:
   return err;
@@ -1276,7 +1969,7 @@ bail:
  * API                          WriteNVFFaceModel                           API *
  ********************************************************************************/
 
-FaceIOErr WriteNVFFaceModel(FaceIOAdapter *fac, const char *fileName) {
+FaceIOErr WriteNVFFaceModel(FaceIOAdapter *fac, const char *fileName, unsigned options) {
   FaceIOErr err;
   EOWriter wtr;
   NVFFileHeader header;
@@ -1289,14 +1982,15 @@ FaceIOErr WriteNVFFaceModel(FaceIOAdapter *fac, const char *fileName) {
 
   BAIL_IF_ERR(err = wtr.writeData(sizeof(header), &header));
 
-  BAIL_IF_ERR(err = wtr.writeEncapsulationHeader(FOURCC_MODEL, NVFSizeMorphableModel(fac), FOURCC_MODEL));
-  BAIL_IF_ERR(err = NVFWriteMorphableModel(fac, wtr));
+  BAIL_IF_ERR(err = wtr.writeEncapsulationHeader(FOURCC_MODEL, NVFSizeMorphableModel(fac, options), FOURCC_MODEL));
+  BAIL_IF_ERR(err = NVFWriteMorphableModel(fac, wtr, options));
 
   BAIL_IF_ERR(err = wtr.writeEncapsulationHeader(FOURCC_IBUG, NVFSizeIbugMappings(fac), FOURCC_IBUG));
   BAIL_IF_ERR(err = NVFWriteIbugMappings(fac, wtr));
 
-  BAIL_IF_ERR(err = wtr.writeEncapsulationHeader(FOURCC_BLEND_SHAPES, NVFSizeBlendShapes(fac), FOURCC_BLEND_SHAPES));
-  BAIL_IF_ERR(err = NVFWriteBlendShapes(fac, wtr));
+  BAIL_IF_ERR(err = wtr.writeEncapsulationHeader(FOURCC_BLEND_SHAPES, NVFSizeBlendShapes(fac, options),
+                                                 FOURCC_BLEND_SHAPES));
+  BAIL_IF_ERR(err = NVFWriteBlendShapes(fac, wtr, options));
 
   BAIL_IF_ERR(err =
                   wtr.writeEncapsulationHeader(FOURCC_MODEL_CONTOUR, NVFSizeModelContours(fac), FOURCC_MODEL_CONTOUR));
@@ -1329,45 +2023,168 @@ bail:
  ********************************************************************************
  ********************************************************************************/
 
+/********************************************************************************
+ * Section selection
+ ********************************************************************************/
+
+/* The section to which a top-level chunk belongs; the model holds two of them. */
+static unsigned NVFChunkSection(uint32_t type) {
+  switch (type) {
+    case FOURCC_MODEL:          return kIOSectionModel | kIOSectionShapeModes;
+    case FOURCC_IBUG:           return kIOSectionIbug;
+    case FOURCC_BLEND_SHAPES:   return kIOSectionBlendShapes;
+    case FOURCC_MODEL_CONTOUR:  return kIOSectionModelContours;
+    case FOURCC_TOPOLOGY:       return kIOSectionTopology;
+    case FOURCC_NVLM:           return kIOSectionNvlm;
+    case FOURCC_PARTITIONS:     return kIOSectionPartitions;
+    default:                    return 0;
+  }
+}
+
+/* The section to which a chunk of the shape model belongs. Unknown chunks are passed through to be skipped. */
+static unsigned NVFShapeModelSection(uint32_t type) {
+  switch (type) {
+    case FOURCC_BASIS:
+    case FOURCC_QUANTIZED_BASIS:
+    case FOURCC_EIGENVALUES:    return kIOSectionShapeModes;
+    case FOURCC_MEAN:
+    case FOURCC_TRIANGLE_LIST:  return kIOSectionModel;
+    default:                    return kIOSectionAll;
+  }
+}
 
-static size_t SafeRead(void *ptr, size_t size, size_t num, FILE *fd) {
-  if (ptr) return(fread(ptr, size, num, fd));
-  else     return fseek(fd, (long)(size * num), SEEK_CUR) ? 0 : num;
+/********************************************************************************
+ * Quantized shapes
+ * These are kept quantized if the adapter can store them that way, otherwise
+ * they are dequantized into its float storage.
+ ********************************************************************************/
+
+static FaceIOErr NVFReadQuantizedShapeModes(FaceIOAdapter *fac, uint32_t size, EOReader &rdr) {
+  FaceIOErr err = kIOErrNone;
+  uint32_t hdr[2], numModes, modeSize, sizeQuant = 0, sizeData = 0, i;
+  const uint8_t *mem;
+  int16_t *q;
+  FaceIOQuantization *quant;
+  std::vector<int16_t> qBuf;
+  std::vector<FaceIOQuantization> quantBuf;
+  float *v;
+
+  BAIL_IF_FALSE(size >= sizeof(hdr), err, kIOErrFormat);
+  BAIL_IF_FALSE(1 == rdr.read(hdr, sizeof(hdr), 1), err, kIOErrEOF);
+  size -= sizeof(hdr);
+  numModes = hdr[0];
+  modeSize = hdr[1];
+  BAIL_IF_FALSE(numModes <= size / sizeof(*quant), err, kIOErrFormat);
+  sizeQuant = numModes * sizeof(*quant);
+  BAIL_IF_FALSE(!numModes || modeSize <= (size - sizeQuant) / sizeof(*q) / numModes, err, kIOErrFormat);
+  sizeData = numModes * modeSize * sizeof(*q);
+  if (!sizeData) {
+    sizeQuant = 0;                                                                      // Nothing to read
+  }
+  else if (rdr.zeroCopy() && nullptr != (mem = (const uint8_t*)rdr.peek(sizeQuant + sizeData)) &&
+      fac->adoptQuantizedShapeModes((const int16_t*)(mem + sizeQuant), (const FaceIOQuantization*)mem, modeSize,
+                                    numModes)) {
+    sizeQuant = sizeData = 0;                                                           // Referenced in place
+  }
+  else if (nullptr != (q = fac->getQuantizedShapeModes(modeSize, numModes)) &&
+           nullptr != (quant = fac->getShapeModesQuantization())) {
+    BAIL_IF_FALSE(1 == rdr.read(quant, sizeQuant, 1), err, kIOErrRead);
+    BAIL_IF_FALSE(1 == rdr.read(q, sizeData, 1), err, kIOErrRead);
+  }
+  else {
+    quantBuf.resize(numModes);
+    qBuf.resize(numModes * modeSize);
+    BAIL_IF_FALSE(1 == rdr.read(quantBuf.data(), sizeQuant, 1), err, kIOErrRead);
+    BAIL_IF_FALSE(1 == rdr.read(qBuf.data(), sizeData, 1), err, kIOErrRead);
+    if (nullptr != (v = fac->getShapeModes(modeSize, numModes)))
+      for (i = 0; i < numModes; ++i)
+        FaceIODequantize(qBuf.data() + i * modeSize, modeSize, quantBuf[i], v + i * modeSize);
+  }
+  BAIL_IF_NONZERO(rdr.skip(size - sizeQuant - sizeData), err, kIOErrEOF);              // Skip the padding
+bail:
+  return err;
+}
+
+static FaceIOErr NVFReadQuantizedBlendShape(FaceIOAdapter *fac, uint32_t i, uint32_t size, EOReader &rdr) {
+  FaceIOErr err = kIOErrNone;
+  uint32_t n, sizeData;
+  const uint8_t *mem;
+  int16_t *q;
+  FaceIOQuantization *quant, quantBuf;
+  std::vector<int16_t> qBuf;
+  float *v;
+
+  BAIL_IF_FALSE(size >= sizeof(n) + sizeof(quantBuf), err, kIOErrFormat);
+  BAIL_IF_FALSE(1 == rdr.read(&n, sizeof(n), 1), err, kIOErrEOF);
+  size -= sizeof(n);
+  BAIL_IF_FALSE(n <= (size - sizeof(quantBuf)) / sizeof(*q), err, kIOErrFormat);
+  sizeData = n * sizeof(*q);
+  if (rdr.zeroCopy() && nullptr != (mem = (const uint8_t*)rdr.peek(sizeof(quantBuf) + sizeData)) &&
+      fac->adoptQuantizedBlendShape(i, (const int16_t*)(mem + sizeof(quantBuf)), (const FaceIOQuantization*)mem, n)) {
+    sizeData = 0;                                                                       // Referenced in place
+  }
+  else if (nullptr != (q = fac->getQuantizedBlendShape(i, n)) &&
+           nullptr != (quant = fac->getBlendShapeQuantization(i))) {
+    BAIL_IF_FALSE(1 == rdr.read(quant, sizeof(*quant), 1), err, kIOErrRead);
+    size -= sizeof(*quant);
+    if (sizeData) BAIL_IF_FALSE(1 == rdr.read(q, sizeData, 1), err, kIOErrRead);
+  }
+  else {
+    qBuf.resize(n);
+    BAIL_IF_FALSE(1 == rdr.read(&quantBuf, sizeof(quantBuf), 1), err, kIOErrRead);
+    size -= sizeof(quantBuf);
+    if (sizeData) BAIL_IF_FALSE(1 == rdr.read(qBuf.data(), sizeData, 1), err, kIOErrRead);
+    if (nullptr != (v = fac->getBlendShape(i, n)))
+      FaceIODequantize(qBuf.data(), n, quantBuf, v);
+  }
+  BAIL_IF_NONZERO(rdr.skip(size - sizeData), err, kIOErrEOF);                          // Skip the padding
+bail:
+  return err;
 }
 
-static FaceIOErr NVFReadShapeModel(FaceIOAdapter *fac, uint32_t size, FILE *fd) {
+static FaceIOErr NVFReadShapeModel(FaceIOAdapter *fac, uint32_t size, EOReader &rdr, unsigned sections) {
   FaceIOErr err = kIOErrNone;
   EOTypeSize ts;
   uint32_t n, numModes;
 
   while (size >= sizeof(ts)) {
-    BAIL_IF_FALSE(1 == fread(&ts, sizeof(ts), 1, fd), err, kIOErrEOF);
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
     size -= sizeof(ts);
     BAIL_IF_FALSE(ts.size <= size, err, kIOErrEOF);
     size -= ts.size;
+    if (!(sections & NVFShapeModelSection(ts.type))) {
+      BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);  // Not requested
+      continue;
+    }
     switch (ts.type) {
       case FOURCC_MEAN:
         n = ts.size / sizeof(*fac->getShapeMean());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getShapeMean(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getShapeMean(n), ts.size, 1), err, kIOErrRead);
         break;
       case FOURCC_BASIS:
-        BAIL_IF_FALSE((1 == fread(&numModes, sizeof(numModes), 1, fd)), numModes, 0);  // The number of modes
+        BAIL_IF_FALSE((1 == rdr.read(&numModes, sizeof(numModes), 1)), numModes, 0);  // The number of modes
         BAIL_IF_FALSE(ts.size >= sizeof(numModes), err, kIOErrEOF);  // Check for underflow
         ts.size -= sizeof(numModes);                                                   // The byte size of all modes
         n = ts.size / sizeof(*fac->getShapeModes());                                   // The elements size of all nodes
-        BAIL_IF_FALSE(1 == SafeRead(fac->getShapeModes(n / numModes, numModes), ts.size, 1, fd), err, kIOErrRead);
+        if (rdr.zeroCopy() && fac->adoptShapeModes((const float*)rdr.peek(ts.size), n / numModes, numModes)) {
+          BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);                          // Referenced in place
+          break;
+        }
+        BAIL_IF_FALSE(1 == rdr.read(fac->getShapeModes(n / numModes, numModes), ts.size, 1), err, kIOErrRead);
+        break;
+      case FOURCC_QUANTIZED_BASIS:
+        BAIL_IF_ERR(err = NVFReadQuantizedShapeModes(fac, ts.size, rdr));
         break;
       case FOURCC_EIGENVALUES:
         n = ts.size / sizeof(*fac->getShapeEigenvalues());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getShapeEigenvalues(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getShapeEigenvalues(n), ts.size, 1), err, kIOErrRead);
         break;
       case FOURCC_TRIANGLE_LIST:
         n = ts.size / sizeof(*fac->getTriangleList());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getTriangleList(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getTriangleList(n), ts.size, 1), err, kIOErrRead);
         break;
       default:
-        BAIL_IF_FALSE(ts.size <= LONG_MAX, err, kIOErrEOF);  // Check for overflow before cast
-        BAIL_IF_NONZERO(fseek(fd, (long)ts.size, SEEK_CUR), err, kIOErrEOF);  // We skip over objects we don't understand
+        BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);  // We skip over objects we don't understand
         break;
     }
   }
@@ -1375,38 +2192,37 @@ bail:
   return err;
 }
 
-static FaceIOErr NVFReadColorModel(FaceIOAdapter *fac, uint32_t size, FILE *fd) {
+static FaceIOErr NVFReadColorModel(FaceIOAdapter *fac, uint32_t size, EOReader &rdr) {
   FaceIOErr err = kIOErrNone;
   EOTypeSize ts;
   uint32_t n, numModes;
 
   while (size >= sizeof(ts)) {
-    BAIL_IF_FALSE(1 == fread(&ts, sizeof(ts), 1, fd), err, kIOErrEOF);
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
     size -= sizeof(ts);
     BAIL_IF_FALSE(ts.size <= size, err, kIOErrEOF);
     size -= ts.size;
     switch (ts.type) {
       case FOURCC_MEAN:
         n = ts.size / sizeof(*fac->getColorMean());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getColorMean(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getColorMean(n), ts.size, 1), err, kIOErrRead);
         break;
       case FOURCC_BASIS:
-        BAIL_IF_FALSE((1 == fread(&numModes, sizeof(numModes), 1, fd)), numModes, 0);  // The number of modes
+        BAIL_IF_FALSE((1 == rdr.read(&numModes, sizeof(numModes), 1)), numModes, 0);  // The number of modes
         BAIL_IF_FALSE(ts.size >= sizeof(numModes), err, kIOErrEOF);  // Check for underflow
         ts.size -= sizeof(numModes);                                                   // The byte size of all modes
         n = ts.size / sizeof(*fac->getColorModes());                                   // The elements size of all nodes
-        BAIL_IF_FALSE(1 == SafeRead(fac->getColorModes(n / numModes, numModes), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getColorModes(n / numModes, numModes), ts.size, 1), err, kIOErrRead);
         break;
       case FOURCC_EIGENVALUES:
         n = ts.size / sizeof(*fac->getColorEigenvalues());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getColorEigenvalues(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getColorEigenvalues(n), ts.size, 1), err, kIOErrRead);
         break;
       case FOURCC_TRIANGLE_LIST:
-        if (ts.size <= LONG_MAX) (void)fseek(fd, (long)ts.size, SEEK_CUR);  // Skip color triangle list -- it doesn't make sense
+        (void)rdr.skip(ts.size);  // Skip color triangle list -- it doesn't make sense
         break;
       default:
-        BAIL_IF_FALSE(ts.size <= LONG_MAX, err, kIOErrEOF);  // Check for overflow before cast
-        BAIL_IF_NONZERO(fseek(fd, (long)ts.size, SEEK_CUR), err, kIOErrEOF);  // We skip over objects we don't understand
+        BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);  // We skip over objects we don't understand
         break;
     }
   }
@@ -1414,30 +2230,37 @@ bail:
   return err;
 }
 
-static FaceIOErr NVFReadMorphableModel(FaceIOAdapter *fac, uint32_t size, FILE *fd) {
+static FaceIOErr NVFReadMorphableModel(FaceIOAdapter *fac, uint32_t size, EOReader &rdr, unsigned sections) {
   FaceIOErr err = kIOErrNone;
   EOTypeSize ts;
   uint32_t n;
 
   while (size >= sizeof(ts)) {
-    BAIL_IF_FALSE(1 == fread(&ts, sizeof(ts), 1, fd), err, kIOErrEOF);
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
     size -= sizeof(ts);
     BAIL_IF_FALSE(ts.size <= size, err, kIOErrEOF);
     size -= ts.size;
     switch (ts.type) {
       case FOURCC_SHAPE:
-        BAIL_IF_ERR(err = NVFReadShapeModel(fac, ts.size, fd));
+        BAIL_IF_ERR(err = NVFReadShapeModel(fac, ts.size, rdr, sections));
         break;
       case FOURCC_COLOR:
-        BAIL_IF_ERR(err = NVFReadColorModel(fac, ts.size, fd));
+        if (sections & kIOSectionModel) {
+          BAIL_IF_ERR(err = NVFReadColorModel(fac, ts.size, rdr));
+        } else {
+          BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);
+        }
         break;
       case FOURCC_TEXTURE_COORDS:
-        n = ts.size / sizeof(*fac->getTextureCoordinates());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getTextureCoordinates(n), ts.size, 1, fd), err, kIOErrRead);
+        if (sections & kIOSectionModel) {
+          n = ts.size / sizeof(*fac->getTextureCoordinates());
+          BAIL_IF_FALSE(1 == rdr.read(fac->getTextureCoordinates(n), ts.size, 1), err, kIOErrRead);
+        } else {
+          BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);
+        }
         break;
       default:
-        BAIL_IF_FALSE(ts.size <= LONG_MAX, err, kIOErrEOF);  // Check for overflow before cast
-        BAIL_IF_NONZERO(fseek(fd, (long)ts.size, SEEK_CUR), err, kIOErrEOF);  // We skip over objects we don't understand
+        BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);  // We skip over objects we don't understand
         break;
     }
   }
@@ -1445,9 +2268,9 @@ bail:
   return err;
 }
 
-static FaceIOErr NVFReadString(std::string &str, uint32_t size, FILE *fd) {
+static FaceIOErr NVFReadString(std::string &str, uint32_t size, EOReader &rdr) {
   str.resize(size);
-  FaceIOErr err = (size == fread(&str[0], 1, size, fd)) ? kIOErrNone : kIOErrRead;
+  FaceIOErr err = (size == rdr.read(&str[0], 1, size)) ? kIOErrNone : kIOErrRead;
   BAIL_IF_ERR(err);
   for (; size; --size)
     if (str[size - 1]) break;
@@ -1456,35 +2279,43 @@ bail:
   return err;
 }
 
-static FaceIOErr NVFReadBlendShapes(FaceIOAdapter *fac, uint32_t size, FILE *fd) {
+static FaceIOErr NVFReadBlendShapes(FaceIOAdapter *fac, uint32_t size, EOReader &rdr) {
   uint32_t numShapes;
   FaceIOErr err = kIOErrNone;
   EOTypeSize ts;
   std::string name;
   float *shape;
 
-  BAIL_IF_FALSE(1 == fread(&numShapes, sizeof(numShapes), 1, fd), err, kIOErrEOF);
+  BAIL_IF_FALSE(1 == rdr.read(&numShapes, sizeof(numShapes), 1), err, kIOErrEOF);
   fac->setNumBlendShapes(numShapes);
 
   for (uint32_t idxShape = 0, idxName = 0; size >= sizeof(ts);) {
-    BAIL_IF_FALSE(1 == fread(&ts, sizeof(ts), 1, fd), err, kIOErrEOF);
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
     size -= sizeof(ts);
     BAIL_IF_FALSE(ts.size <= size, err, kIOErrEOF);
     size -= ts.size;
     switch (ts.type) {
       case FOURCC_NAME:
         BAIL_IF_FALSE(idxName < numShapes, err, kIOErrRead);
-        BAIL_IF_ERR(err = NVFReadString(name, ts.size, fd));
+        BAIL_IF_ERR(err = NVFReadString(name, ts.size, rdr));
         fac->setBlendShapeName(idxName++, name.c_str());
         break;
       case FOURCC_SHAPE:
         BAIL_IF_FALSE(idxShape < numShapes, err, kIOErrRead);
+        if (rdr.zeroCopy() && fac->adoptBlendShape(idxShape, (const float*)rdr.peek(ts.size), ts.size / sizeof(*shape))) {
+          ++idxShape;
+          BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);                          // Referenced in place
+          break;
+        }
         shape = fac->getBlendShape(idxShape++, ts.size / sizeof(*shape));
-        BAIL_IF_FALSE(1 == SafeRead(shape, ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(shape, ts.size, 1), err, kIOErrRead);
+        break;
+      case FOURCC_QUANTIZED_SHAPE:
+        BAIL_IF_FALSE(idxShape < numShapes, err, kIOErrRead);
+        BAIL_IF_ERR(err = NVFReadQuantizedBlendShape(fac, idxShape++, ts.size, rdr));
         break;
       default:
-        BAIL_IF_FALSE(ts.size <= LONG_MAX, err, kIOErrEOF);  // Check for overflow before cast
-        BAIL_IF_NONZERO(fseek(fd, (long)ts.size, SEEK_CUR), err, kIOErrEOF);  // We skip over objects we don't understand
+        BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);  // We skip over objects we don't understand
         break;
     }
   }
@@ -1492,32 +2323,31 @@ bail:
     return err;
 }
 
-static FaceIOErr NVFReadIbugMappings(FaceIOAdapter *fac, uint32_t size, FILE *fd) {
+static FaceIOErr NVFReadIbugMappings(FaceIOAdapter *fac, uint32_t size, EOReader &rdr) {
   FaceIOErr err = kIOErrNone;
   EOTypeSize ts;
   uint32_t n;
 
   while (size >= sizeof(ts)) {
-    BAIL_IF_FALSE(1 == fread(&ts, sizeof(ts), 1, fd), err, kIOErrEOF);
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
     size -= sizeof(ts);
     BAIL_IF_FALSE(ts.size <= size, err, kIOErrEOF);
     size -= ts.size;
     switch (ts.type) {
       case FOURCC_LANDMARK_MAP:
         n = ts.size / sizeof(*fac->getIbugLandmarkMappings());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getIbugLandmarkMappings(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getIbugLandmarkMappings(n), ts.size, 1), err, kIOErrRead);
         break;
       case FOURCC_RIGHT_CONTOUR:
         n = ts.size / sizeof(*fac->getIbugRightContour());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getIbugRightContour(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getIbugRightContour(n), ts.size, 1), err, kIOErrRead);
         break;
       case FOURCC_LEFT_CONTOUR:
         n = ts.size / sizeof(*fac->getIbugLeftContour());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getIbugLeftContour(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getIbugLeftContour(n), ts.size, 1), err, kIOErrRead);
         break;
       default:
-        BAIL_IF_FALSE(ts.size <= LONG_MAX, err, kIOErrEOF);  // Check for overflow before cast
-        BAIL_IF_NONZERO(fseek(fd, (long)ts.size, SEEK_CUR), err, kIOErrEOF);  // We skip over objects we don't understand
+        BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);  // We skip over objects we don't understand
         break;
     }
   }
@@ -1525,29 +2355,28 @@ bail:
   return err;
 }
 
-static FaceIOErr NVFReadModelContours(FaceIOAdapter *fac, uint32_t size, FILE *fd) {
+static FaceIOErr NVFReadModelContours(FaceIOAdapter *fac, uint32_t size, EOReader &rdr) {
   FaceIOErr err = kIOErrNone;
   ;
   EOTypeSize ts;
   uint32_t n;
 
   while (size >= sizeof(ts)) {
-    BAIL_IF_FALSE(1 == fread(&ts, sizeof(ts), 1, fd), err, kIOErrEOF);
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
     size -= sizeof(ts);
     BAIL_IF_FALSE(ts.size <= size, err, kIOErrEOF);
     size -= ts.size;
     switch (ts.type) {
       case FOURCC_RIGHT_CONTOUR:
         n = ts.size / sizeof(*fac->getModelRightContour());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getModelRightContour(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getModelRightContour(n), ts.size, 1), err, kIOErrRead);
         break;
       case FOURCC_LEFT_CONTOUR:
         n = ts.size / sizeof(*fac->getModelLeftContour());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getModelLeftContour(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getModelLeftContour(n), ts.size, 1), err, kIOErrRead);
         break;
       default:
-        BAIL_IF_FALSE(ts.size <= LONG_MAX, err, kIOErrEOF);  // Check for overflow before cast
-        BAIL_IF_NONZERO(fseek(fd, (long)ts.size, SEEK_CUR), err, kIOErrEOF);  // We skip over objects we don't understand
+        BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);  // We skip over objects we don't understand
         break;
     }
   }
@@ -1555,28 +2384,27 @@ bail:
   return err;
 }
 
-static FaceIOErr NVFReadTopology(FaceIOAdapter *fac, uint32_t size, FILE *fd) {
+static FaceIOErr NVFReadTopology(FaceIOAdapter *fac, uint32_t size, EOReader &rdr) {
   FaceIOErr err = kIOErrNone;
   EOTypeSize ts;
   uint32_t n;
 
   while (size >= sizeof(ts)) {
-    BAIL_IF_FALSE(1 == fread(&ts, sizeof(ts), 1, fd), err, kIOErrEOF);
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
     size -= sizeof(ts);
     BAIL_IF_FALSE(ts.size <= size, err, kIOErrEOF);
     size -= ts.size;
     switch (ts.type) {
       case FOURCC_ADJACENT_FACES:
         n = ts.size / sizeof(*fac->getAdjacentFaces());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getAdjacentFaces(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getAdjacentFaces(n), ts.size, 1), err, kIOErrRead);
         break;
       case FOURCC_ADJACENT_VERTICES:
         n = ts.size / sizeof(*fac->getAdjacentVertices());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getAdjacentVertices(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getAdjacentVertices(n), ts.size, 1), err, kIOErrRead);
         break;
       default:
-        BAIL_IF_FALSE(ts.size <= LONG_MAX, err, kIOErrEOF);  // Check for overflow before cast
-        BAIL_IF_NONZERO(fseek(fd, (long)ts.size, SEEK_CUR), err, kIOErrEOF);  // We skip over objects we don't understand
+        BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);  // We skip over objects we don't understand
         break;
     }
   }
@@ -1584,32 +2412,31 @@ bail:
   return err;
 }
 
-static FaceIOErr NVFReadNvlm(FaceIOAdapter *fac, uint32_t size, FILE *fd) {
+static FaceIOErr NVFReadNvlm(FaceIOAdapter *fac, uint32_t size, EOReader &rdr) {
   FaceIOErr err = kIOErrNone;
   EOTypeSize ts;
   uint32_t n;
 
   while (size >= sizeof(ts)) {
-    BAIL_IF_FALSE(1 == fread(&ts, sizeof(ts), 1, fd), err, kIOErrEOF);
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
     size -= sizeof(ts);
     BAIL_IF_FALSE(ts.size <= size, err, kIOErrEOF);
     size -= ts.size;
     switch (ts.type) {
       case FOURCC_LANDMARK_MAP:
         n = ts.size / sizeof(*fac->getNvlmLandmarks());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getNvlmLandmarks(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getNvlmLandmarks(n), ts.size, 1), err, kIOErrRead);
         break;
       case FOURCC_RIGHT_CONTOUR:
         n = ts.size / sizeof(*fac->getIbugRightContour());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getNvlmRightContour(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getNvlmRightContour(n), ts.size, 1), err, kIOErrRead);
         break;
       case FOURCC_LEFT_CONTOUR:
         n = ts.size / sizeof(*fac->getIbugLeftContour());
-        BAIL_IF_FALSE(1 == SafeRead(fac->getNvlmLeftContour(n), ts.size, 1, fd), err, kIOErrRead);
+        BAIL_IF_FALSE(1 == rdr.read(fac->getNvlmLeftContour(n), ts.size, 1), err, kIOErrRead);
         break;
       default:
-        BAIL_IF_FALSE(ts.size <= LONG_MAX, err, kIOErrEOF);  // Check for overflow before cast
-        BAIL_IF_NONZERO(fseek(fd, (long)ts.size, SEEK_CUR), err, kIOErrEOF);  // We skip over objects we don't understand
+        BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);  // We skip over objects we don't understand
         break;
     }
   }
@@ -1617,33 +2444,32 @@ bail:
   return err;
 }
 
-static FaceIOErr NVFReadPart(uint32_t i, FaceIOAdapter *fac, uint32_t size, FILE *fd) {
+static FaceIOErr NVFReadPart(uint32_t i, FaceIOAdapter *fac, uint32_t size, EOReader &rdr) {
   FaceIOErr err = kIOErrNone;
   EOTypeSize ts;
   TPart part;
   std::string name;
 
   BAIL_IF_FALSE(sizeof(part) <= size, err, kIOErrEOF);
-  BAIL_IF_FALSE(1 == fread(&part, sizeof(part), 1, fd), err, kIOErrEOF);
+  BAIL_IF_FALSE(1 == rdr.read(&part, sizeof(part), 1), err, kIOErrEOF);
   size -= sizeof(part);
   fac->setPartition(i, part.faceIndex, part.numFaces, part.vertexIndex, part.numVertices, part.smoothingGroup);
   while (size >= sizeof(ts)) {
-    BAIL_IF_FALSE(1 == fread(&ts, sizeof(ts), 1, fd), err, kIOErrEOF);
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
     size -= sizeof(ts);
     BAIL_IF_FALSE(ts.size <= size, err, kIOErrEOF);
     size -= ts.size;
     switch (ts.type) {
       case FOURCC_NAME:
-        BAIL_IF_ERR(err = NVFReadString(name, ts.size, fd));
+        BAIL_IF_ERR(err = NVFReadString(name, ts.size, rdr));
         fac->setPartitionName(i, name.c_str());
         break;
       case FOURCC_MATERIAL:
-        BAIL_IF_ERR(err = NVFReadString(name, ts.size, fd));
+        BAIL_IF_ERR(err = NVFReadString(name, ts.size, rdr));
         fac->setPartitionMaterialName(i, name.c_str());
         break;
       default:
-        BAIL_IF_FALSE(ts.size <= LONG_MAX, err, kIOErrEOF);  // Check for overflow before cast
-        BAIL_IF_NONZERO(fseek(fd, (long)ts.size, SEEK_CUR), err, kIOErrEOF);  // We skip over objects we don't understand
+        BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);  // We skip over objects we don't understand
         break;
     }
   }
@@ -1652,28 +2478,27 @@ bail:
   return err;
 }
 
-static FaceIOErr NVFReadPartitions(FaceIOAdapter *fac, uint32_t size, FILE *fd) {
+static FaceIOErr NVFReadPartitions(FaceIOAdapter *fac, uint32_t size, EOReader &rdr) {
   FaceIOErr err = kIOErrNone;
   EOTypeSize ts;
   uint32_t numPartitions, partIx = 0;
 
   BAIL_IF_FALSE(sizeof(numPartitions) <= size, err, kIOErrEOF);
-  BAIL_IF_FALSE(1 == fread(&numPartitions, sizeof(numPartitions), 1, fd), err, kIOErrEOF);
+  BAIL_IF_FALSE(1 == rdr.read(&numPartitions, sizeof(numPartitions), 1), err, kIOErrEOF);
   size -= sizeof(numPartitions);
   fac->setNumPartitions(numPartitions);
 
   for (; size >= sizeof(ts); ++partIx) {
-    BAIL_IF_FALSE(1 == fread(&ts, sizeof(ts), 1, fd), err, kIOErrEOF);
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
     size -= sizeof(ts);
     BAIL_IF_FALSE(ts.size <= size, err, kIOErrEOF);
     size -= ts.size;
     switch (ts.type) {
       case FOURCC_PART:
-        BAIL_IF_ERR(err = NVFReadPart(partIx, fac, ts.size, fd));
+        BAIL_IF_ERR(err = NVFReadPart(partIx, fac, ts.size, rdr));
         break;
       default:
-        BAIL_IF_FALSE(ts.size <= LONG_MAX, err, kIOErrEOF);  // Check for overflow before cast
-        BAIL_IF_NONZERO(fseek(fd, (long)ts.size, SEEK_CUR), err, kIOErrEOF);  // We skip over objects we don't understand
+        BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrEOF);  // We skip over objects we don't understand
         break;
     }
   }
@@ -1683,35 +2508,102 @@ bail:
 }
 
 /********************************************************************************
- * API                              ReadNVFFaceModel                        API *
+ * NVFReadSection
  ********************************************************************************/
 
-FaceIOErr ReadNVFFaceModel(const char *fileName, FaceIOAdapter *fac) {
+static FaceIOErr NVFReadSection(FaceIOAdapter *fac, const EOTypeSize &ts, EOReader &rdr, unsigned sections) {
+  FaceIOErr err = kIOErrNone;
+
+  switch (ts.type) {
+    case FOURCC_MODEL:
+      BAIL_IF_ERR(err = NVFReadMorphableModel(fac, ts.size, rdr, sections));
+      break;
+    case FOURCC_IBUG:
+      BAIL_IF_ERR(err = NVFReadIbugMappings(fac, ts.size, rdr));
+      break;
+    case FOURCC_BLEND_SHAPES:
+      BAIL_IF_ERR(err = NVFReadBlendShapes(fac, ts.size, rdr));
+      break;
+    case FOURCC_MODEL_CONTOUR:
+      BAIL_IF_ERR(err = NVFReadModelContours(fac, ts.size, rdr));
+      break;
+    case FOURCC_TOPOLOGY:
+      BAIL_IF_ERR(err = NVFReadTopology(fac, ts.size, rdr));
+      break;
+    case FOURCC_NVLM:
+      BAIL_IF_ERR(err = NVFReadNvlm(fac, ts.size, rdr));
+      break;
+    case FOURCC_PARTITIONS:
+      BAIL_IF_ERR(err = NVFReadPartitions(fac, ts.size, rdr));
+      break;
+    default:
+      BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrRead);  // We skip over objects we don't understand, and the EOTOC
+      break;
+  }
+bail:
+  return err;
+}
+
+/********************************************************************************
+ * NVFReadFaceModelWithTOC
+ * Visit only the requested sections, in the order listed in the table of contents.
+ ********************************************************************************/
+
+static FaceIOErr NVFReadFaceModelWithTOC(FaceIOAdapter *fac, uint32_t tocLoc, uint32_t dataLoc, EOReader &rdr,
+                                         unsigned sections) {
+  FaceIOErr err = kIOErrNone;
+  uint32_t fileSize = (uint32_t)rdr.size(), recordSize, numRecords, rec[2];
+  std::vector<EOTOC> toc;
+  EOTypeSize ts;
+
+  /* Read the whole table of contents first, since we will be jumping around the file */
+  BAIL_IF_FALSE(tocLoc >= dataLoc && tocLoc <= fileSize - sizeof(ts), err, kIOErrFormat);
+  BAIL_IF_NONZERO(rdr.seek(tocLoc), err, kIOErrRead);
+  BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
+  BAIL_IF_FALSE(FOURCC_EOTOC == ts.type, err, kIOErrFormat);
+  BAIL_IF_FALSE(ts.size >= sizeof(recordSize) && ts.size <= fileSize - tocLoc - sizeof(ts), err, kIOErrFormat);
+  BAIL_IF_FALSE(1 == rdr.read(&recordSize, sizeof(recordSize), 1), err, kIOErrEOF);
+  BAIL_IF_FALSE(recordSize >= sizeof(rec), err, kIOErrFormat);  // Records may grow, but never shrink
+  numRecords = (ts.size - sizeof(recordSize)) / recordSize;
+  toc.reserve(numRecords);
+  for (; numRecords--;) {
+    BAIL_IF_FALSE(1 == rdr.read(rec, sizeof(rec), 1), err, kIOErrEOF);
+    BAIL_IF_NONZERO(rdr.skip(recordSize - sizeof(rec)), err, kIOErrRead);
+    toc.emplace_back(rec[0], rec[1]);
+  }
+
+  /* Visit the requested sections; the rest of the file is never touched */
+  for (const EOTOC &entry : toc) {
+    if (!(sections & NVFChunkSection(entry._tag))) continue;
+    BAIL_IF_FALSE(entry._offset >= dataLoc && entry._offset <= fileSize - sizeof(ts), err, kIOErrFormat);
+    BAIL_IF_NONZERO(rdr.seek(entry._offset), err, kIOErrRead);
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
+    BAIL_IF_FALSE(entry._tag == ts.type, err, kIOErrFormat);
+    BAIL_IF_FALSE(ts.size <= fileSize - entry._offset - sizeof(ts), err, kIOErrFormat);
+    BAIL_IF_ERR(err = NVFReadSection(fac, ts, rdr, sections));
+  }
+
+bail:
+  return err;
+}
+
+/********************************************************************************
+ * NVFReadFaceModel
+ ********************************************************************************/
+
+static FaceIOErr NVFReadFaceModel(FaceIOAdapter *fac, EOReader &rdr, unsigned sections) {
   FaceIOErr err = kIOErrNone;
-  FILE *fd = nullptr;
   EOTypeSize ts;
   NVFFileHeader header;
   uint32_t size;
 
-#ifndef _MSC_VER
-  fd = fopen(fileName, "rb");
-#else  /* _MSC_VER */
-  if (0 != fopen_s(&fd, fileName, "rb"))
-    fd = nullptr;
-#endif /* _MSC_VER */
-  if (!fd) {
-    PrintIOError(fileName, err = kIOErrFileOpen);
-    goto bail;
-  }
-
   /* Find the length of the file */
-  BAIL_IF_NEGATIVE(fseek(fd, 0L, SEEK_END), err, kIOErrRead);
-  size = ftell(fd);
-  BAIL_IF_NEGATIVE(fseek(fd, 0L, SEEK_SET), err, kIOErrRead);
+  BAIL_IF_FALSE(rdr.size() <= UINT32_MAX, err, kIOErrFormat);                           // We only use 32 bit sizes
+  size = (uint32_t)rdr.size();
   BAIL_IF_FALSE(size >= sizeof(header), err, kIOErrEOF);
 
   /* Validate header */
-  BAIL_IF_FALSE(1 == fread(&header, sizeof(header), 1, fd), err, kIOErrRead);
+  BAIL_IF_FALSE(1 == rdr.read(&header, sizeof(header), 1), err, kIOErrRead);
   BAIL_IF_FALSE(FOURCC_FILE_TYPE == header.type, err, kIOErrFormat);
   BAIL_IF_FALSE(8 <= header.size, err, kIOErrFormat);                                    // TODO: robustify
   BAIL_IF_FALSE(NVFFileHeader::LITTLE_ENDIAN_CODE == header.endian, err, kIOErrFormat);  // We only handle little-endian
@@ -1722,47 +2614,82 @@ FaceIOErr ReadNVFFaceModel(const char *fileName, FaceIOAdapter *fac) {
     uint32_t extra = header.size - 8;
     BAIL_IF_FALSE(size >= extra, err, kIOErrEOF);
     size -= extra;
-    BAIL_IF_NEGATIVE(fseek(fd, extra, SEEK_CUR), err, kIOErrRead);
+    BAIL_IF_NONZERO(rdr.skip(extra), err, kIOErrRead);
   }
 
-  while (size >= sizeof(ts)) {
-    BAIL_IF_FALSE(1 == fread(&ts, sizeof(ts), 1, fd), err, kIOErrEOF);
+  if (header.tocLoc) {  /* Random access */
+    err = NVFReadFaceModelWithTOC(fac, header.tocLoc, (uint32_t)rdr.tell(), rdr, sections);
+    goto bail;
+  }
+
+  while (size >= sizeof(ts)) {  /* Sequential access */
+    BAIL_IF_FALSE(1 == rdr.read(&ts, sizeof(ts), 1), err, kIOErrEOF);
     size -= sizeof(ts);
     BAIL_IF_FALSE(ts.size <= size, err, kIOErrEOF);
     size -= ts.size;
-    switch (ts.type) {
-      case FOURCC_MODEL:
-        BAIL_IF_ERR(err = NVFReadMorphableModel(fac, ts.size, fd));
-        break;
-      case FOURCC_IBUG:
-        BAIL_IF_ERR(err = NVFReadIbugMappings(fac, ts.size, fd));
-        break;
-      case FOURCC_BLEND_SHAPES:
-        BAIL_IF_ERR(err = NVFReadBlendShapes(fac, ts.size, fd));
-        break;
-      case FOURCC_MODEL_CONTOUR:
-        BAIL_IF_ERR(err = NVFReadModelContours(fac, ts.size, fd));
-        break;
-      case FOURCC_TOPOLOGY:
-        BAIL_IF_ERR(err = NVFReadTopology(fac, ts.size, fd));
-        break;
-      case FOURCC_NVLM:
-        BAIL_IF_ERR(err = NVFReadNvlm(fac, ts.size, fd));
-        break;
-      case FOURCC_PARTITIONS:
-        BAIL_IF_ERR(err = NVFReadPartitions(fac, ts.size, fd));
-        break;
-      case FOURCC_EOTOC:
-        BAIL_IF_FALSE(ts.size <= LONG_MAX, err, kIOErrRead);  // Check for overflow before cast
-        BAIL_IF_NEGATIVE(fseek(fd, (long)ts.size, SEEK_CUR), err, kIOErrRead);  // Skip the EOTOC
-        break;
-      default:
-        BAIL(err, kIOErrSyntax);  // TODO: We should just skip over objects we don't understand
+    if (sections & NVFChunkSection(ts.type)) {
+      BAIL_IF_ERR(err = NVFReadSection(fac, ts, rdr, sections));
+    } else {
+      BAIL_IF_NONZERO(rdr.skip(ts.size), err, kIOErrRead);  // Not requested, unknown, or the EOTOC
     }
   }
 
 bail:
-  if (fd) fclose(fd);
+  return err;
+}
+
+/********************************************************************************
+ * API                              ReadNVFFaceModel                        API *
+ ********************************************************************************/
+
+FaceIOErr ReadNVFFaceModel(const char *fileName, FaceIOAdapter *fac) {
+  FaceIOErr err;
+  EOReader rdr;
+
+  if (kIOErrNone != (err = rdr.open(fileName))) {
+    PrintIOError(fileName, err);
+    return err;
+  }
+  return NVFReadFaceModel(fac, rdr, kIOSectionAll);
+}
+
+/********************************************************************************
+ * API                         ReadNVFFaceModelSections                     API *
+ ********************************************************************************/
+
+FaceIOErr ReadNVFFaceModelSections(const char *fileName, FaceIOAdapter *fac, unsigned sections) {
+  FaceIOErr err;
+  EOReader rdr;
+
+  if (kIOErrNone != (err = rdr.open(fileName))) {
+    PrintIOError(fileName, err);
+    return err;
+  }
+  return NVFReadFaceModel(fac, rdr, sections);
+}
+
+/********************************************************************************
+ * API                          ReadNVFFaceModelMapped                      API *
+ ********************************************************************************/
+
+FaceIOErr ReadNVFFaceModelMapped(const char *fileName, FaceIOAdapter *fac, unsigned sections) {
+  FaceIOErr err;
+  EOReader rdr;
+  FaceIOMapping *map = new FaceIOMapping;
+  bool adopted;
+
+  if (kIOErrNone != (err = map->open(fileName))) {
+    PrintIOError(fileName, err);
+    delete map;
+    return err;
+  }
+  fac->clear();                       // Release any earlier mapping, and the views into it
+  rdr.open(map);
+  adopted = fac->adoptMapping(map);   // The adapter now owns the mapping if it accepted it
+  rdr.setZeroCopy(adopted);
+  err = NVFReadFaceModel(fac, rdr, sections);
+  rdr.close();
+  if (!adopted) delete map;           // Everything was copied
   return err;
 }
 
@@ -1931,6 +2858,15 @@ bail:
   return err;
 }
 
+/* Indices are read in bulk into a vector of the reader state, and appended to the adapter when their array closes. */
+static void EOSAppendIndices(const std::vector<uint16_t> &v, uint32_t size, uint16_t *(FaceIOAdapter::*get)(uint32_t),
+                             FaceIOAdapter *fac) {
+  uint16_t *dst;
+  if (v.empty()) return;
+  if (nullptr != (dst = (fac->*get)(size + (uint32_t)v.size())))
+    memcpy(dst + size, v.data(), v.size() * sizeof(*dst));
+}
+
 struct EOSContoursReaderState {
   enum {
     STATE_NULL,
@@ -1943,6 +2879,7 @@ struct EOSContoursReaderState {
   };
   int state, nest;
   FaceIOAdapter *fac;
+  std::vector<uint16_t> indices;
   EOSContoursReaderState() {
     state = STATE_NULL;
     nest = 0;
@@ -1969,19 +2906,12 @@ static FaceIOErr EOSContoursOpenNode(JSONInfo *info) {
           st->state = EOSContoursReaderState::STATE_ERROR;
           break;
       }
+      st->indices.clear();
+      info->arrayType = kJSONNumericUInt16;
+      info->arrayVector = &st->indices;
       break;
-    case kJSONNumber:
-      switch (st->state) {
-        case EOSContoursReaderState::STATE_RIGHT_CONTOUR_ARRAY:
-          st->fac->appendModelRightContour((uint16_t)info->number);
-          break;
-        case EOSContoursReaderState::STATE_LEFT_CONTOUR_ARRAY:
-          st->fac->appendModelLeftContour((uint16_t)info->number);
-          break;
-        default:
-          st->state = EOSContoursReaderState::STATE_ERROR;
-          break;
-      }
+    case kJSONNumber:   /* Numbers are only expected in the contour arrays, which are read in bulk */
+      st->state = EOSContoursReaderState::STATE_ERROR;
       break;
     case kJSONMember:
       if (!strcmp(info->value, "model_contour"))
@@ -2005,6 +2935,12 @@ static FaceIOErr EOSContoursCloseNode(JSONInfo *info) {
       break;
     case kJSONArray:
       --(st->nest);
+      if (EOSContoursReaderState::STATE_RIGHT_CONTOUR_ARRAY == st->state)
+        EOSAppendIndices(st->indices, st->fac->getModelRightContourSize(), &FaceIOAdapter::getModelRightContour,
+                         st->fac);
+      else if (EOSContoursReaderState::STATE_LEFT_CONTOUR_ARRAY == st->state)
+        EOSAppendIndices(st->indices, st->fac->getModelLeftContourSize(), &FaceIOAdapter::getModelLeftContour,
+                         st->fac);
       st->state = EOSContoursReaderState::STATE_NULL;
       break;
   }
@@ -2023,6 +2959,8 @@ static FaceIOErr EOSReadContours(FaceIOAdapter *fac, const char *fileName) {
   return err;
 }
 
+/* The adjacent faces and vertices are arrays of pairs, which cereal writes as objects with members "value0" and
+ * "value1"; the bulk reader flattens these into a sequence of indices. */
 struct EOSTopologyReaderState {
   enum {
     STATE_NULL,
@@ -2031,12 +2969,11 @@ struct EOSTopologyReaderState {
     STATE_VERTICES,
     STATE_FACES_ARRAY,
     STATE_VERTICES_ARRAY,
-    STATE_FACES_ARRAY_OBJ,
-    STATE_VERTICES_ARRAY_OBJ,
     STATE_ERROR
   };
   int state, nest;
   FaceIOAdapter *fac;
+  std::vector<uint16_t> indices;
   EOSTopologyReaderState() {
     state = STATE_NULL;
     nest = 0;
@@ -2049,16 +2986,6 @@ static FaceIOErr EOSTopologyOpenNode(JSONInfo *info) {
   switch (info->type) {
     case kJSONObject:
       ++(st->nest);
-      switch (st->state) {
-        case EOSTopologyReaderState::STATE_FACES_ARRAY:
-          st->state = EOSTopologyReaderState::STATE_FACES_ARRAY_OBJ;
-          break;
-        case EOSTopologyReaderState::STATE_VERTICES_ARRAY:
-          st->state = EOSTopologyReaderState::STATE_VERTICES_ARRAY_OBJ;
-          break;
-        default:
-          break;
-      }
       break;
     case kJSONArray:
       ++(st->nest);
@@ -2073,21 +3000,12 @@ static FaceIOErr EOSTopologyOpenNode(JSONInfo *info) {
           st->state = EOSTopologyReaderState::STATE_ERROR;
           break;
       }
+      st->indices.clear();
+      info->arrayType = kJSONNumericUInt16;
+      info->arrayVector = &st->indices;
       break;
-    case kJSONNumber:
-      switch (st->state) {
-        case EOSTopologyReaderState::STATE_FACES_ARRAY:
-        case EOSTopologyReaderState::STATE_FACES_ARRAY_OBJ:
-          st->fac->appendAdjacentFace((uint16_t)info->number);
-          break;
-        case EOSTopologyReaderState::STATE_VERTICES_ARRAY:
-        case EOSTopologyReaderState::STATE_VERTICES_ARRAY_OBJ:
-          st->fac->appendAdjacentVertex((uint16_t)info->number);
-          break;
-        default:
-          st->state = EOSTopologyReaderState::STATE_ERROR;
-          break;
-      }
+    case kJSONNumber:   /* Numbers are only expected in the adjacency arrays, which are read in bulk */
+      st->state = EOSTopologyReaderState::STATE_ERROR;
       break;
     case kJSONMember:
       if (!strcmp(info->value, "edge_topology"))
@@ -2096,10 +3014,7 @@ static FaceIOErr EOSTopologyOpenNode(JSONInfo *info) {
         st->state = EOSTopologyReaderState::STATE_FACES;
       else if (!strcmp(info->value, "adjacent_vertices"))
         st->state = EOSTopologyReaderState::STATE_VERTICES;
-      else if ((!strcmp(info->value, "value0") || !strcmp(info->value, "value1")) &&
-               (EOSTopologyReaderState::STATE_FACES_ARRAY_OBJ == st->state ||
-                EOSTopologyReaderState::STATE_VERTICES_ARRAY_OBJ == st->state)) {
-      } else
+      else
         st->state = EOSTopologyReaderState::STATE_ERROR;
       break;
   }
@@ -2111,20 +3026,14 @@ static FaceIOErr EOSTopologyCloseNode(JSONInfo *info) {
   switch (info->type) {
     case kJSONObject:
       --(st->nest);
-      switch (st->state) {
-        case EOSTopologyReaderState::STATE_FACES_ARRAY_OBJ:
-          st->state = EOSTopologyReaderState::STATE_FACES_ARRAY;
-          break;
-        case EOSTopologyReaderState::STATE_VERTICES_ARRAY_OBJ:
-          st->state = EOSTopologyReaderState::STATE_VERTICES_ARRAY;
-          break;
-        default:
-          st->state = EOSTopologyReaderState::STATE_ERROR;
-          break;
-      }
       break;
     case kJSONArray:
       --(st->nest);
+      if (EOSTopologyReaderState::STATE_FACES_ARRAY == st->state)
+        EOSAppendIndices(st->indices, st->fac->getAdjacentFacesSize(), &FaceIOAdapter::getAdjacentFaces, st->fac);
+      else if (EOSTopologyReaderState::STATE_VERTICES_ARRAY == st->state)
+        EOSAppendIndices(st->indices, st->fac->getAdjacentVerticesSize(), &FaceIOAdapter::getAdjacentVertices,
+                         st->fac);
       st->state = EOSTopologyReaderState::STATE_NULL;
       break;
   }
@@ -2237,6 +3146,188 @@ bail:
   return err;
 }
 
+/********************************************************************************
+ * EOSCacheHashMix
+ * The 64-bit finalizer of MurmurHash3, which makes every bit of the result depend on every bit of the input.
+ ********************************************************************************/
+
+static uint64_t EOSCacheHashMix(uint64_t k) {
+  k ^= k >> 33;
+  k *= 0xFF51AFD7ED558CCDULL;
+  k ^= k >> 33;
+  k *= 0xC4CEB9FE1A85EC53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+/********************************************************************************
+ * EOSCacheHashData
+ ********************************************************************************/
+
+static uint64_t EOSCacheHashData(uint64_t h, const void *data, size_t size) {
+  const unsigned char *p = (const unsigned char*)data;
+  uint64_t w;
+
+  h = EOSCacheHashMix(h ^ size);
+  for (; size >= sizeof(w); p += sizeof(w), size -= sizeof(w)) {
+    memcpy(&w, p, sizeof(w));                               // Unaligned, endian-dependent, but only used locally
+    h = (h ^ EOSCacheHashMix(w)) * 0x9E3779B97F4A7C15ULL;
+    h = (h << 31) | (h >> 33);
+  }
+  if (size) {
+    w = 0;
+    memcpy(&w, p, size);
+    h = (h ^ EOSCacheHashMix(w)) * 0x9E3779B97F4A7C15ULL;
+  }
+  return EOSCacheHashMix(h);
+}
+
+/********************************************************************************
+ * EOSCacheHashFile
+ * Absent files are hashed differently from empty ones.
+ ********************************************************************************/
+
+static FaceIOErr EOSCacheHashFile(const char *fileName, uint64_t *h) {
+  FaceIOErr err = kIOErrNone;
+  FaceIOMapping map;
+
+  if (!fileName) {
+    *h = EOSCacheHashMix(*h + 1);
+    return kIOErrNone;
+  }
+  err = map.open(fileName);
+  if (kIOErrEOF == err) {
+    *h = EOSCacheHashMix(*h + 2);
+    return kIOErrNone;
+  }
+  if (kIOErrNone == err)
+    *h = EOSCacheHashData(*h, map.data(), map.size());
+  return err;
+}
+
+/********************************************************************************
+ * EOSCacheFileName
+ * Returns false if any of the input files could not be read, in which case the cache is bypassed.
+ ********************************************************************************/
+
+static bool EOSCacheFileName(const char *cacheDir, const char *shape, const char *blendShapes, const char *contours,
+                             const char *topology, std::string &cacheFile) {
+  const uint64_t kVersion = 1;  // Increment whenever the EOS parser or the NVF writer changes what is produced
+  const char *files[4] = { shape, blendShapes, contours, topology };
+  uint64_t h = EOSCacheHashMix(kVersion);
+  char name[32];
+
+  for (const char *file : files)
+    if (kIOErrNone != EOSCacheHashFile(file, &h))
+      return false;
+  snprintf(name, sizeof(name), "eos-%016llx.nvf", (unsigned long long)h);
+  cacheFile = cacheDir;
+  if (!cacheFile.empty() && '/' != cacheFile.back()
+  #ifdef _WIN32
+      && '\\' != cacheFile.back()
+  #endif /* _WIN32 */
+  )
+    cacheFile += '/';
+  cacheFile += name;
+  return true;
+}
+
+/********************************************************************************
+ * EOSCacheFileExists
+ ********************************************************************************/
+
+static bool EOSCacheFileExists(const char *fileName) {
+  FILE *fd;
+  #ifndef _MSC_VER
+    fd = fopen(fileName, "rb");
+  #else  /* _MSC_VER */
+    if (0 != fopen_s(&fd, fileName, "rb"))
+      fd = nullptr;
+  #endif /* _MSC_VER */
+  if (!fd)
+    return false;
+  fclose(fd);
+  return true;
+}
+
+/********************************************************************************
+ * EOSCacheStore
+ * The model is written under a temporary name and then renamed, so that concurrent loaders never see a partial file.
+ ********************************************************************************/
+
+static FaceIOErr EOSCacheStore(const char *cacheDir, const std::string &cacheFile, FaceIOAdapter *fac) {
+  FaceIOErr err;
+  std::string tmpFile(cacheFile);
+
+  #ifdef _WIN32
+    CreateDirectoryA(cacheDir, nullptr);  // Fails harmlessly if it already exists
+    tmpFile += ".tmp" + std::to_string(GetCurrentProcessId());
+  #else /* UNIX */
+    mkdir(cacheDir, 0777);                // Fails harmlessly if it already exists
+    tmpFile += ".tmp" + std::to_string(getpid());
+  #endif /* _WIN32 */
+  err = WriteNVFFaceModel(fac, tmpFile.c_str());
+  if (kIOErrNone == err) {
+    #ifdef _WIN32
+      if (!MoveFileExA(tmpFile.c_str(), cacheFile.c_str(), MOVEFILE_REPLACE_EXISTING))
+        err = kIOErrWrite;
+    #else /* UNIX */
+      if (0 != rename(tmpFile.c_str(), cacheFile.c_str()))
+        err = kIOErrWrite;
+    #endif /* _WIN32 */
+  }
+  if (kIOErrNone != err)
+    remove(tmpFile.c_str());
+  return err;
+}
+
+/********************************************************************************
+ * API                           ReadEOSFaceModelCached                     API *
+ ********************************************************************************/
+
+FaceIOErr ReadEOSFaceModelCached(const char *shape, unsigned int ibugNumLandmarks, const char *blendShapes,
+                                 const char *contours, const char *topology, const char *cacheDir,
+                                 FaceIOAdapter *fac, FaceIOCacheStats *stats,
+                                 char *cacheFileName, size_t cacheFileNameSize) {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  FaceIOErr err;
+  std::string cacheFile;
+  bool hit = false, stored = false;
+  double seconds;
+
+  if (cacheFileName && cacheFileNameSize)
+    cacheFileName[0] = 0;
+  if (cacheDir && EOSCacheFileName(cacheDir, shape, blendShapes, contours, topology, cacheFile)
+      && EOSCacheFileExists(cacheFile.c_str())) {
+    hit = (kIOErrNone == ReadNVFFaceModelMapped(cacheFile.c_str(), fac));
+    if (!hit)
+      fac->clear();   // Discard whatever was read before the failure, before parsing the EOS files instead
+  }
+  if (!hit) {
+    err = ReadEOSFaceModel(shape, ibugNumLandmarks, blendShapes, contours, topology, fac);
+    if (kIOErrNone != err)
+      return err;
+    if (!cacheFile.empty())
+      stored = (kIOErrNone == EOSCacheStore(cacheDir, cacheFile, fac));
+  }
+  if ((hit || stored) && cacheFileName && cacheFile.size() < cacheFileNameSize)
+    memcpy(cacheFileName, cacheFile.c_str(), cacheFile.size() + 1);
+
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  if (stats) {
+    if (hit) {
+      ++stats->hits;
+      stats->hitSeconds += seconds;
+    } else {
+      ++stats->misses;
+      stats->missSeconds += seconds;
+    }
+    if (stored) ++stats->stores;
+    stats->lastSeconds = seconds;
+  }
+  return kIOErrNone;
+}
+
 /********************************************************************************
  ********************************************************************************
  ********************************************************************************
@@ -2366,6 +3457,22 @@ static void JSONPrintPartitions(const FaceIOAdapter *fac, JSONWriter &wtr, const
 }
 
 
+static FaceIOErr JSONPrintFaceModel(const FaceIOAdapter *fac, JSONWriter &wtr) {
+  wtr.openObject();
+  JSONPrintMorphableModel(fac, wtr, "morphable_model");
+  JSONPrintIbugMappings(fac, wtr, "ibug_mappings");
+  JSONPrintBlendShapes(fac, wtr, "blend_shapes");
+  JSONPrintContours(fac, wtr, "contours");
+  JSONPrintTopology(fac, wtr, "edge_topology");
+  if (fac->getNvlmLandmarksSize())
+    JSONPrintNvlm(fac, wtr, "nvidia_mappings");
+  if (fac->getNumPartitions())
+    JSONPrintPartitions(fac, wtr, "partitions");
+  wtr.closeObject();
+  return wtr.flush();
+}
+
+
 /********************************************************************************
  * API                      PrintJSONFaceModel                              API *
  ********************************************************************************/
@@ -2379,18 +3486,17 @@ FaceIOErr PrintJSONFaceModel(FaceIOAdapter *fac, const char *file) {
     PrintIOError(file, err);
     return err;
   }
+  err = JSONPrintFaceModel(fac, wtr);
+  if (kIOErrNone != err)
+    PrintIOError(file ? file : "stdout", err);
+  return err;
+}
 
-  wtr.openObject();
-  JSONPrintMorphableModel(fac, wtr, "morphable_model");
-  JSONPrintIbugMappings(fac, wtr, "ibug_mappings");
-  JSONPrintBlendShapes(fac, wtr, "blend_shapes");
-  JSONPrintContours(fac, wtr, "contours");
-  JSONPrintTopology(fac, wtr, "edge_topology");
-  if (fac->getNvlmLandmarksSize())
-    JSONPrintNvlm(fac, wtr, "nvidia_mappings");
-  if (fac->getNumPartitions())
-    JSONPrintPartitions(fac, wtr, "partitions");
-  wtr.closeObject();
+FaceIOErr PrintJSONFaceModel(FaceIOAdapter *fac, FaceIOWriteProc proc, void *userData) {
+  FaceIOErr err;
+  JSONWriter wtr;
 
-  return err;
+  if (kIOErrNone != (err = wtr.open(proc, userData)))
+    return err;
+  return JSONPrintFaceModel(fac, wtr);
 }
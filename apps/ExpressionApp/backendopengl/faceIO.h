@@ -24,6 +24,7 @@
 #ifndef __FACE_IO__
 #define __FACE_IO__
 
+#include <stddef.h>
 #include <stdint.h>
 
 enum FaceIOErr {
@@ -42,6 +43,46 @@ enum FaceIOErr {
 
 const char* FaceIOErrorStringFromCode(FaceIOErr err);
 
+/* Sections of an NVF file, to be OR'ed together to select those that are to be read. */
+enum FaceIOSection {
+  kIOSectionModel         = 0x01,   ///< The mean shape, triangle list, color model and texture coordinates.
+  kIOSectionShapeModes    = 0x02,   ///< The identity shape modes and their eigenvalues.
+  kIOSectionIbug          = 0x04,   ///< The ibug landmark mappings.
+  kIOSectionBlendShapes   = 0x08,   ///< The expression blend shapes.
+  kIOSectionModelContours = 0x10,   ///< The model contours.
+  kIOSectionTopology      = 0x20,   ///< The adjacent faces and vertices.
+  kIOSectionNvlm          = 0x40,   ///< The NVLM landmark mappings and contours.
+  kIOSectionPartitions    = 0x80,   ///< The partitions and their materials.
+  kIOSectionAll           = 0xFF
+};
+
+/* Options for writing an NVF file, to be OR'ed together. */
+enum FaceIOWriteOption {
+  kIOWriteQuantizeShapes  = 0x01    ///< Store the shape modes and blend shapes as 16-bit quantized components.
+};
+
+/* The affine map from 16-bit quantized components back to floats: value = offset + scale * q.
+ * Zero is always represented exactly, so that unaffected vertices contribute nothing. */
+struct FaceIOQuantization {
+  float scale, offset;
+};
+
+/** Quantize a shape vector to 16 bits, choosing the scale and offset to cover its range.
+ * @param[in]   v       the shape vector.
+ * @param[in]   n       the number of components in the vector.
+ * @param[out]  q       the quantized components.
+ * @param[out]  quant   the scale and offset.
+ */
+void FaceIOQuantize(const float* v, size_t n, int16_t* q, FaceIOQuantization* quant);
+
+/** Dequantize a shape vector.
+ * @param[in]   q       the quantized components.
+ * @param[in]   n       the number of components in the vector.
+ * @param[in]   quant   the scale and offset.
+ * @param[out]  v       the shape vector.
+ */
+void FaceIODequantize(const int16_t* q, size_t n, const FaceIOQuantization& quant, float* v);
+
 /********************************************************************************
  ********************************************************************************
  ********************************************************************************
@@ -50,6 +91,39 @@ const char* FaceIOErrorStringFromCode(FaceIOErr err);
  ********************************************************************************
  ********************************************************************************/
 
+/********************************************************************************
+ * FaceIOMapping.
+ * A copy-on-write memory mapping of a whole file. The pages are shared among all
+ * processes that map the same file until written, and are faulted in on demand.
+ * Writes go to private copies of the pages, and never reach the file.
+ ********************************************************************************/
+
+class FaceIOMapping {
+public:
+  FaceIOMapping();
+  ~FaceIOMapping();
+
+  /** Map the specified file into memory, copy-on-write.
+   * @param[in]   fileName    the name of the file to be mapped.
+   * @return      kIOErrNone          if the file was mapped successfully.
+   * @return      kIOErrFileNotFound  if the file could not be found.
+   * @return      kIOErrFileOpen      if the file could not be mapped.
+   */
+  FaceIOErr open(const char* fileName);
+
+  /** Unmap the file. This invalidates any pointers into the mapping. */
+  void close();
+
+  const void* data() const;   /* A pointer to the first byte of the file, or NULL if not mapped. */
+  size_t      size() const;   /* The size of the file in bytes. */
+
+private:
+  FaceIOMapping(const FaceIOMapping&) = delete;
+  FaceIOMapping& operator=(const FaceIOMapping&) = delete;
+  struct Impl;
+  Impl* pimpl;
+};
+
 /********************************************************************************
  * FaceIOAdapter.
  * Subclass from this and supply the accessors.
@@ -92,6 +166,14 @@ public:
   virtual uint32_t getBlendShapeSize(uint32_t /*i*/) const { return 0; }
   virtual float* getBlendShape(uint32_t /*i*/, uint32_t /*size*/) { return nullptr; }
 
+  /* Quantized shape modes and blend shapes (see FaceIOQuantization). These resize like their float counterparts,
+   * and replace them. An adapter that returns NULL from these stores only floats, and is given dequantized data;
+   * if it does store quantized data, its float accessors should supply dequantized copies for the writers. */
+  virtual int16_t* getQuantizedShapeModes(uint32_t /*modeSize*/, uint32_t /*numModes*/) { return nullptr; }
+  virtual FaceIOQuantization* getShapeModesQuantization() { return nullptr; }  /* One per mode */
+  virtual int16_t* getQuantizedBlendShape(uint32_t /*i*/, uint32_t /*size*/) { return nullptr; }
+  virtual FaceIOQuantization* getBlendShapeQuantization(uint32_t /*i*/) { return nullptr; }
+
   virtual void setIbugLandmarkMappingsSize(uint32_t /*n*/) {} /* The mappings from IBUG landmarks to vertex index */
   virtual uint32_t getIbugLandmarkMappingsSize() const { return 0; }
   virtual uint16_t* getIbugLandmarkMappings(uint32_t /*size*/) { return nullptr; }
@@ -159,6 +241,22 @@ public:
     if (numVertices) *numVertices = 0u; if (smoothingGroup) *smoothingGroup = -1; return /*partitionIndex*/-1;
   }
 
+  /* Remove everything from the target data structure, including any adopted mapping. */
+  virtual void clear() {}
+
+  /* Zero-copy input from a memory-mapped file (see ReadNVFFaceModelMapped).
+   * If adoptMapping() returns true, the adapter takes ownership of the mapping, and the reader will offer pointers
+   * into it for the bulky sections; an adopt*() returning true means the adapter references the data in place,
+   * otherwise it is copied through the resizing accessors above. If adoptMapping() returns false, everything is
+   * copied and the mapping is released after reading. */
+  virtual bool adoptMapping(FaceIOMapping* /*map*/) { return false; }
+  virtual bool adoptShapeModes(const float* /*modes*/, uint32_t /*modeSize*/, uint32_t /*numModes*/) { return false; }
+  virtual bool adoptBlendShape(uint32_t /*i*/, const float* /*shape*/, uint32_t /*size*/) { return false; }
+  virtual bool adoptQuantizedShapeModes(const int16_t* /*modes*/, const FaceIOQuantization* /*quant*/,
+                                        uint32_t /*modeSize*/, uint32_t /*numModes*/) { return false; }
+  virtual bool adoptQuantizedBlendShape(uint32_t /*i*/, const int16_t* /*shape*/, const FaceIOQuantization* /*quant*/,
+                                        uint32_t /*size*/) { return false; }
+
 
   /* Const accessors do not have the ability to resize. */
   const float* getShapeMean() const { return const_cast<FaceIOAdapter*>(this)->getShapeMean(0); }
@@ -170,6 +268,13 @@ public:
   const float* getTextureCoordinates() const { return const_cast<FaceIOAdapter*>(this)->getTextureCoordinates(0); }
   const uint16_t* getTriangleList() const { return const_cast<FaceIOAdapter*>(this)->getTriangleList(0); }
   const float* getBlendShape(uint32_t i) const { return const_cast<FaceIOAdapter*>(this)->getBlendShape(i, 0); }
+  const int16_t* getQuantizedShapeModes() const { return const_cast<FaceIOAdapter*>(this)->getQuantizedShapeModes(0, 0); }
+  const FaceIOQuantization* getShapeModesQuantization() const
+    { return const_cast<FaceIOAdapter*>(this)->getShapeModesQuantization(); }
+  const int16_t* getQuantizedBlendShape(uint32_t i) const
+    { return const_cast<FaceIOAdapter*>(this)->getQuantizedBlendShape(i, 0); }
+  const FaceIOQuantization* getBlendShapeQuantization(uint32_t i) const
+    { return const_cast<FaceIOAdapter*>(this)->getBlendShapeQuantization(i); }
   const uint16_t* getIbugLandmarkMappings() const { return const_cast<FaceIOAdapter*>(this)->getIbugLandmarkMappings(0); }
   const uint16_t* getIbugRightContour() const { return const_cast<FaceIOAdapter*>(this)->getIbugRightContour(0); }
   const uint16_t* getIbugLeftContour() const { return const_cast<FaceIOAdapter*>(this)->getIbugLeftContour(0); }
@@ -183,13 +288,15 @@ public:
 };
 
 /** Write the face model as an NVF model.
+ * Shapes that the adapter holds quantized are always written quantized.
  * @param[in]   fac         the face I/O adapter for the target data structure.
  * @param[in]   fileName    the desired name of the output file.
+ * @param[in]   options     a combination of FaceIOWriteOption flags.
  * @return      kIOErrNone       if the file was written completed successfully.
  * @return      kIOErrFileOpen   if the file could not be opened.
  * @return      kIOErrWrite      if an error occurred while writing the file.
  */
-FaceIOErr WriteNVFFaceModel(FaceIOAdapter* fac, const char* fileName);
+FaceIOErr WriteNVFFaceModel(FaceIOAdapter* fac, const char* fileName, unsigned options = 0);
 
 /** Read a face model from an NVF file.
  * @param[in]       fileName    the name of the file to be read.
@@ -202,6 +309,36 @@ FaceIOErr WriteNVFFaceModel(FaceIOAdapter* fac, const char* fileName);
  */
 FaceIOErr ReadNVFFaceModel(const char* fileName, FaceIOAdapter* fac);
 
+/** Read selected sections of a face model from an NVF file.
+ * Sections are located through the file's table of contents, so those that are not requested are never touched.
+ * Files without a table of contents are scanned sequentially instead. Sections not requested are left unchanged
+ * in the adapter, so this can be called again later to fetch the remaining sections on demand.
+ * @param[in]       fileName    the name of the file to be read.
+ * @param[in,out]   fac         the face I/O adapter for the target data structure.
+ * @param[in]       sections    the sections to be read, a combination of FaceIOSection flags.
+ * @return      kIOErrNone           if the file was read successfully.
+ * @return      kIOErrFileNotFound   if the file was not found .
+ * @return      kIOErrFileOpen       if the file could not be opened.
+ * @return      kIOErrRead           if an error occurred while reading the file.
+ * @return      kIOErrFormat         if the table of contents is inconsistent with the file.
+ */
+FaceIOErr ReadNVFFaceModelSections(const char* fileName, FaceIOAdapter* fac, unsigned sections);
+
+/** Read a face model from an NVF file, by mapping it into memory rather than reading it.
+ * Adapters that accept the mapping (FaceIOAdapter::adoptMapping) can reference the shape modes and blend shapes
+ * in place, so that these pages are shared among all processes that load the same model, until written.
+ * The adapter is cleared first (FaceIOAdapter::clear), releasing any mapping adopted by an earlier read.
+ * @param[in]       fileName    the name of the file to be read.
+ * @param[in,out]   fac         the face I/O adapter for the target data structure.
+ * @param[in]       sections    the sections to be read, a combination of FaceIOSection flags.
+ * @return      kIOErrNone           if the file was read successfully.
+ * @return      kIOErrFileNotFound   if the file was not found .
+ * @return      kIOErrFileOpen       if the file could not be mapped.
+ * @return      kIOErrRead           if an error occurred while reading the file.
+ * @return      kIOErrFormat         if the table of contents is inconsistent with the file.
+ */
+FaceIOErr ReadNVFFaceModelMapped(const char* fileName, FaceIOAdapter* fac, unsigned sections = kIOSectionAll);
+
 /** Read a face model from five OES files.
  * @param[in]       shape                  the name of the shape        file to be read.
  * @param[in]       ibugNumandmarks        the number of Ibug landmarks.
@@ -218,6 +355,41 @@ FaceIOErr ReadNVFFaceModel(const char* fileName, FaceIOAdapter* fac);
 FaceIOErr ReadEOSFaceModel(const char* shape, const unsigned ibugNumLandmarks, const char* blendShapes,
                            const char* contours, const char* topology, FaceIOAdapter* fac);
 
+/* Statistics of the compiled model cache, accumulated by ReadEOSFaceModelCached(). */
+struct FaceIOCacheStats {
+  unsigned long long  hits;           ///< The number of loads that were satisfied by a compiled model in the cache.
+  unsigned long long  misses;         ///< The number of loads that had to parse the EOS files.
+  unsigned long long  stores;         ///< The number of compiled models that were written to the cache.
+  double              hitSeconds;     ///< The total time spent in loads that hit  the cache, in seconds.
+  double              missSeconds;    ///< The total time spent in loads that missed the cache, in seconds.
+  double              lastSeconds;    ///< The time spent in the most recent load, in seconds.
+};
+
+/** Read a face model from five EOS files, through a cache of compiled NVF models.
+ * The cache is keyed by a hash of the contents of the EOS files, so it remains valid when files are renamed or
+ * copied, and is bypassed as soon as any of them is edited. On a miss, the EOS files are parsed with
+ * ReadEOSFaceModel(), and the resulting model is written to the cache as an NVF file; on a hit, only the NVF file is
+ * read, by mapping it into memory. A cache file that cannot be read is treated as a miss and replaced.
+ * @param[in]       shape                  the name of the shape        file to be read.
+ * @param[in]       ibugNumandmarks        the number of Ibug landmarks.
+ * @param[in]       blendShapes            the name of the blend shapes  file to be read.
+ * @param[in]       contours               the name of the contours      file to be read.
+ * @param[in]       topology               the name of the topology      file to be read.
+ * @param[in]       cacheDir               the directory holding the compiled models; it is created if necessary.
+ *                                         If NULL is supplied, the EOS files are read without a cache.
+ * @param[in,out]   fac                    the face I/O adapter for the target data structure.
+ * @param[in,out]   stats                  statistics to be accumulated, or NULL.
+ * @param[out]      cacheFile              a place to store the name of the compiled model in the cache, or NULL.
+ *                                         It is set to the empty string if the model is not in the cache.
+ * @param[in]       cacheFileSize          the size of the cacheFile buffer, in bytes.
+ * @return      kIOErrNone       if the model was read successfully, whether or not it could be added to the cache.
+ * @return      otherwise        the error returned by ReadEOSFaceModel().
+ */
+FaceIOErr ReadEOSFaceModelCached(const char* shape, const unsigned ibugNumLandmarks, const char* blendShapes,
+                                 const char* contours, const char* topology, const char* cacheDir,
+                                 FaceIOAdapter* fac, FaceIOCacheStats* stats = nullptr,
+                                 char* cacheFile = nullptr, size_t cacheFileSize = 0);
+
 /** Write the face model as a JSON model.
  * @param[in]   fac         the face I/O adapter for the target data structure.
  * @param[in]   fileName    the desired name of the output file.
@@ -228,4 +400,23 @@ FaceIOErr ReadEOSFaceModel(const char* shape, const unsigned ibugNumLandmarks, c
  */
 FaceIOErr PrintJSONFaceModel(FaceIOAdapter* fac, const char* fileName);
 
+/** A destination for output that is not written to a file, such as a socket.
+ * @param[in]   userData    the data supplied along with the procedure.
+ * @param[in]   data        the next block of output.
+ * @param[in]   size        the size of the block, in bytes.
+ * @return      kIOErrNone  if the whole block was consumed; any other code aborts the output and is returned by it.
+ */
+typedef FaceIOErr (*FaceIOWriteProc)(void* userData, const void* data, size_t size);
+
+/** Write the face model as a JSON model, through a procedure rather than to a file.
+ * The output is delivered in large blocks, in order, and is the same as that written to a file.
+ * @param[in]   fac         the face I/O adapter for the target data structure.
+ * @param[in]   proc        the procedure that consumes the output.
+ * @param[in]   userData    data passed along to the procedure.
+ * @return      kIOErrNone        if the model was written successfully.
+ * @return      kIOErrNullPointer if proc is NULL.
+ * @return      otherwise         the error returned by the procedure.
+ */
+FaceIOErr PrintJSONFaceModel(FaceIOAdapter* fac, FaceIOWriteProc proc, void* userData);
+
 #endif /* __FACE_IO__ */
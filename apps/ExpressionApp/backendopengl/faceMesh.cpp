@@ -0,0 +1,364 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "faceMesh.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#include "deformKernel.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "simpleFaceModel.h"
+#include "workerPool.h"
+
+
+#ifndef __BYTE_ORDER__                  /* How bytes are packed into a 32 bit word */
+  #define __ORDER_LITTLE_ENDIAN__ 3210  /* First byte in the least significant position */
+  #define __ORDER_BIG_ENDIAN__    0123  /* First byte in the most  significant position */
+#if defined(__amd64__) || defined(__amd64) || defined(__x86_64__) || defined(__x86_64) || defined(_M_AMD64) || _MSC_VER
+  #define __BYTE_ORDER__ __ORDER_LITTLE_ENDIAN__
+  #endif /* _MSC_VER */
+#endif /* __BYTE_ORDER__ */
+
+
+/********************************************************************************
+ * Renderer defaults
+ ********************************************************************************/
+
+const float        kFaceMeshSparseEpsilon   = 1.0e-5f;
+const float        kFaceMeshDeformThreshold = 1.0e-4f;
+const glm::vec4    kFaceMeshLightLoc[kFaceMeshNumLights]   = { { 0, 0, +1000, 0 }, { 100, -200, -500, 0 } };
+const GLSpectrum3f kFaceMeshLightColor[kFaceMeshNumLights] = { { 1.f, 1.f, 1.f }, { .8f, .1f, .1f } };
+const GLSpectrum3f kFaceMeshClearColor = { 0.2f, 0.2f, 0.2f };
+const GLSpectrum3f kFaceMeshDiffuse    = { 0.77f, 0.63f, 0.55f };
+const GLSpectrum3f kFaceMeshAmbient    = kFaceMeshDiffuse * 0.3f;
+
+unsigned FaceMeshNumThreads(unsigned numThreads) {
+  return (~0u == numThreads) ? std::min(WorkerPool::defaultNumThreads(), unsigned(kFaceMeshMaxDefaultThreads))
+                             : numThreads;
+}
+
+
+/********************************************************************************
+ * ComputeDualTopologyFromAdjacencies
+ ********************************************************************************/
+
+static NvCV_Status ComputeDualTopologyFromAdjacencies(const SimpleFaceModelAdapter *fma, GLMesh *mesh) {
+  union IVF {
+    unsigned i;
+    struct VF {
+      #if      __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        unsigned short face, vertex;                  // Vertex in most significant position
+      #else // __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        unsigned short vertex, face;                  // Vertex in most significant position
+      #endif // __BYTE_ORDER__
+    } vf;
+    bool operator<( const IVF& other) { return i <  other.i; }
+    bool operator==(const IVF& other) { return i == other.i; }
+  };
+  std::vector<IVF> topo;
+
+  topo.reserve(mesh->numVertices() * 6 * 2);          // Assume valence-6, duplicated
+  const unsigned short *adjVertices = const_cast<SimpleFaceModelAdapter*>(fma)->getAdjacentVertices(0),
+                       *adjFaces    = const_cast<SimpleFaceModelAdapter*>(fma)->getAdjacentFaces(0);
+  unsigned n = fma->getAdjacentVerticesSize();
+  if (n != fma->getAdjacentFacesSize()) return NVCV_ERR_MISMATCH;
+  for (unsigned ej = 0; ej < n; ej += 2) {            // 2 adjacencies per edge
+    for (unsigned vx = 0; vx < 2; ++vx) {             // for every vertex on the edge
+      for (unsigned fc = 0; fc < 2; ++fc) {           // and every face on the edge
+        IVF vf;
+        vf.vf.vertex = adjVertices[ej + vx];
+        vf.vf.face = adjFaces[ej + fc];
+        if (vf.vf.vertex && vf.vf.face) {             // if a real vertex and a real face
+          --vf.vf.vertex;                             // convert from 1-based index ...
+          --vf.vf.face;                               // ... to 0-based index
+          topo.push_back(vf);
+        }
+      }
+    }
+  }
+  std::sort(topo.begin(), topo.end());
+  topo.erase(std::unique(topo.begin(), topo.end()), topo.end());
+  mesh->resizeDualIndices(unsigned(topo.size()));
+  unsigned short *dual     = mesh->getDualIndices(),
+                 *numFaces = mesh->getVertexFaceCounts();
+  memset(numFaces, 0, mesh->numVertices() * sizeof(*numFaces));
+  for (unsigned i = 0; i < topo.size(); ++i) {
+    numFaces[topo[i].vf.vertex]++;
+    dual[i] = topo[i].vf.face;
+  }
+  return NVCV_SUCCESS;
+}
+
+
+/********************************************************************************
+ * MakeMesh
+ ********************************************************************************/
+
+NvCV_Status MakeMesh(const SimpleFaceModelAdapter *fma, GLMesh *mesh) {
+  mesh->clear();
+  mesh->addVertices(fma->getShapeMeanSize() / 3, const_cast<SimpleFaceModelAdapter*>(fma)->getShapeMean(0));
+  mesh->addFaces(fma->getTriangleListSize() / 3, 3, const_cast<SimpleFaceModelAdapter*>(fma)->getTriangleList(0), 0, 0);
+  NvCV_Status err = ComputeDualTopologyFromAdjacencies(fma, mesh); // This make vertex normal computation lightning fast
+  if (NVCV_SUCCESS != err) return err;
+  mesh->computeVertexNormals();
+  if (fma->fm.partitions.size()) {
+    std::vector<GLMesh::Partition> parts(fma->fm.partitions.size());
+    for (unsigned i = unsigned(parts.size()); i--;) {
+      const SimpleFaceModel::Partition& fr = fma->fm.partitions[i];
+      GLMesh::Partition& to = parts[fr.partitionIndex];
+      //to.partitionIndex = fr.partitionIndex;  // to doesn't have a partitionIndex
+      to.faceIndex = fr.faceIndex;
+      to.numFaces = fr.numFaces;
+      to.vertexIndex = fr.vertexIndex;
+      to.numVertexIndices = fr.numVertexIndices;
+      to.name = fr.name;
+      to.materialName = fr.materialName;
+      to.smooth = fr.smoothingGroup;
+    }
+    mesh->partitionMesh(unsigned(parts.size()), parts.data());
+  }
+  return NVCV_SUCCESS;
+}
+
+
+/********************************************************************************
+ * DeformModel
+ ********************************************************************************/
+
+static bool MakeBlendShapeTerm(const SimpleFaceModel::BlendShape& bs, float c, DeformTerm *term) {
+  if (bs.sparse) {                                              // Scatter-add only the vertices that move
+    if (bs.sparseIndices.empty()) return false;
+    term->fsrc        = bs.sparseDeltas.data()->vec;
+    term->qsrc        = nullptr;
+    term->indices     = bs.sparseIndices.data();
+    term->numIndices  = bs.sparseIndices.size();
+    term->a           = c;
+    term->b           = 0.f;
+  }
+  else if (bs.quantized()) {
+    term->fsrc        = nullptr;
+    term->qsrc        = bs.qdata();
+    term->indices     = nullptr;
+    term->numIndices  = 0;
+    term->a           = c * bs.quant.scale;
+    term->b           = c * bs.quant.offset;
+  }
+  else {
+    term->fsrc        = bs.data()->vec;
+    term->qsrc        = nullptr;
+    term->indices     = nullptr;
+    term->numIndices  = 0;
+    term->a           = c;
+    term->b           = 0.f;
+  }
+  return true;
+}
+
+/// Accumulate the terms into the mesh, splitting the vertices into chunks of whole tiles across the pool.
+static void ParallelDeformAccumulate(float *dst, const float *base, size_t size, const std::vector<DeformTerm>& terms,
+                                     WorkerPool *pool) {
+  const size_t chunk = 3 * 2720;  // 4 tiles of whole vertices: 32 KB, so that each core works in its own L1
+  if (!pool) {
+    DeformAccumulate(dst, base, 0, size, terms.data(), unsigned(terms.size()));
+    return;
+  }
+  pool->parallelFor(0, size, chunk, [=, &terms](size_t b, size_t e) {
+    DeformAccumulate(dst, base, b, e, terms.data(), unsigned(terms.size()));
+  });
+}
+
+NvCV_Status DeformModel(const SimpleFaceModel& model, const float *identCoeffs, const float *exprCoeffs, GLMesh *mesh,
+                        DeformState *state, float threshold, unsigned rebuildInterval, WorkerPool *pool) {
+  unsigned    size = unsigned(model.shapeMean.size()) * 3,    // the number of floats in the mesh vector
+              numModes = size ? unsigned(model.shapeModesSize() * 3 / size) : 0u, // The modes may not have been read
+              numShapes = unsigned(model.blendShapes.size()),
+              numCoeffs, numNonZero, numChanged, i;
+  std::vector<DeformTerm> terms;
+  DeformTerm  term = { nullptr, nullptr, nullptr, 0, 0.f, 0.f };
+  float       c;
+  bool        incremental = state && !identCoeffs && rebuildInterval && state->coeffs.size() == numShapes &&
+                            state->framesSinceRebuild < rebuildInterval;
+
+  if (incremental) {  // Rebuilding is as cheap and exact if at least as many shapes changed as are active
+    for (i = 0, numNonZero = 0, numChanged = 0; i < numShapes; ++i) {
+      numNonZero += (exprCoeffs[i] != 0.f);
+      numChanged += (fabsf(exprCoeffs[i] - state->coeffs[i]) > threshold);
+    }
+    incremental = numChanged < numNonZero || !numChanged;
+  }
+
+  if (incremental) {
+    terms.reserve(numChanged);
+    for (i = 0; i < numShapes; ++i) {
+      if (!(fabsf((c = exprCoeffs[i] - state->coeffs[i])) > threshold)) continue;
+      state->coeffs[i] = exprCoeffs[i];
+      if (MakeBlendShapeTerm(model.blendShapes[i], c, &term))
+        terms.push_back(term);
+    }
+    ++state->framesSinceRebuild;
+    if (!terms.empty()) {
+      ParallelDeformAccumulate(&mesh->getVertices()->x, nullptr, size, terms, pool);
+      mesh->computeVertexNormals(0, pool);
+    }
+    else {
+      ++state->stats.skippedFrames;
+    }
+  }
+  else {
+    terms.reserve(numShapes + (identCoeffs ? numModes : 0u));
+    if (identCoeffs) {
+      for (i = 0, numCoeffs = numModes; i < numCoeffs; ++i) {
+        if ((c = identCoeffs[i]) == 0.f) continue;
+        if (model.shapeModesQuantized()) {
+          term.fsrc = nullptr;
+          term.qsrc = model.getQuantizedShapeModes() + size_t(i) * size;
+          term.a    = c * model.shapeModesQuant[i].scale;
+          term.b    = c * model.shapeModesQuant[i].offset;
+        }
+        else {
+          term.fsrc = model.getShapeModes()->vec + size_t(i) * size;
+          term.qsrc = nullptr;
+          term.a    = c;
+          term.b    = 0.f;
+        }
+        terms.push_back(term);
+      }
+    }
+    for (i = 0; i < numShapes; ++i) {
+      if ((c = exprCoeffs[i]) == 0.f) continue;
+      if (MakeBlendShapeTerm(model.blendShapes[i], c, &term))
+        terms.push_back(term);
+    }
+    ParallelDeformAccumulate(&mesh->getVertices()->x, &model.shapeMean.data()->x, size, terms, pool);
+    mesh->computeVertexNormals(0, pool);
+    if (state) {
+      if (identCoeffs) state->invalidate();                     // The cached coefficients do not include the identity
+      else             state->coeffs.assign(exprCoeffs, exprCoeffs + numShapes);
+      state->framesSinceRebuild = 0;
+      ++state->stats.fullRebuilds;
+    }
+  }
+
+  if (state) {
+    ++state->stats.frames;
+    state->stats.lastShapesTouched = unsigned(terms.size());
+    state->stats.shapesTouched    += terms.size();
+  }
+  return NVCV_SUCCESS;
+}
+
+
+/********************************************************************************
+ * FrameBoundingBox
+ ********************************************************************************/
+
+void FrameBoundingBox(const GLMesh::BoundingBox& bbox, const glm::vec3& lookAt, const glm::vec3& up, float vfov,
+                      float fracFill, float aspect, float yDir, float yOff, float z_near, float z_far,
+                      glm::mat4x4 *V, glm::mat4x4 *P) {
+  glm::vec3 boxSize     = bbox.max() - bbox.min();
+  glm::vec3 boxCenter   = bbox.center();
+  float     borderFrac  = ((1.f - fracFill) / fracFill),
+            dx          = boxSize.x * (1.f + borderFrac),       // border on left and right
+            dy          = boxSize.y * (1.f + borderFrac) * (1.f - fabsf(yOff)),
+            r           = ((dx > dy) ? dx : dy),                // radius of bounding sphere
+            aspectGeom  = dx / dy,
+            signZ       = -yDir,
+            dist;
+
+  if (vfov > 0) {  // Perspective
+    dist = r * .5f / tanf(vfov * .5f);
+    if (z_near == 0.0f && z_far == 0.0f) {
+      // If z_near and z_far are both 0, use default values
+      z_near = dist - r;
+      z_far = dist + r;
+    }
+    *P = glm::perspective(vfov, aspect, z_near, z_far);
+  } else {  // Orthographic
+    if (aspectGeom > aspect) dy *= aspectGeom / aspect;
+    else                     dx *= aspect / aspectGeom;
+    dist = r * 2.f;
+    dx *= .5f;
+    dy *= .5f;
+    *P = glm::orthoLH_NO(-dx, +dx, -dy, +dy, (dist - r) * signZ, (dist + r) * signZ);
+  }
+  boxCenter.y += boxSize.y * yOff;
+  *V = glm::lookAt(boxCenter - glm::normalize(lookAt) * dist, boxCenter, up);
+}
+
+
+/********************************************************************************
+ * FrameFaceMesh
+ ********************************************************************************/
+
+NvCV_Status FrameFaceMesh(const GLMesh& mesh, float vfov, float aspect, float z_near, float z_far,
+                          glm::vec3 *ctrRot, glm::mat4x4 *V, glm::mat4x4 *P) {
+  if (0 == mesh.numVertices())
+    return NVCV_ERR_MODEL;
+  GLMesh::BoundingBox bbox;
+  mesh.getBoundingBox(&bbox);
+  *ctrRot = bbox.center();
+  ctrRot->y = bbox.min().y;  // Assume that assets are designed with Y-up.
+  float vShift = (mesh.numVertices() > 10000) ? 0.15f : 0.0f;  // Heuristic to determine whether there is a neck
+  FrameBoundingBox(bbox, glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, +1.f, 0.f), vfov, .7f, aspect, +1, vShift,
+                   z_near, z_far, V, P);
+  return NVCV_SUCCESS;
+}
+
+
+/********************************************************************************
+ * FitProjectionToAspect
+ * Both glm::perspective() and glm::orthoLH_NO() with symmetric bounds have P[0][0] == P[1][1] / aspect.
+ ********************************************************************************/
+
+glm::mat4x4 FitProjectionToAspect(const glm::mat4x4& P, float fromAspect, float toAspect) {
+  glm::mat4x4 Q = P;
+  if (toAspect >= fromAspect) Q[0][0] = P[1][1] / toAspect;   // Wider:    keep the vertical   extent
+  else                        Q[1][1] = P[0][0] * toAspect;   // Narrower: keep the horizontal extent
+  return Q;
+}
+
+
+/********************************************************************************
+ * FaceModelMatrix
+ ********************************************************************************/
+
+glm::mat4x4 FaceModelMatrix(const float qrot[4], const float trans[3], const glm::vec3& ctrRot) {
+  glm::mat4x4 M;
+  glm::quat q;  // Convert quaternion from {x,y,z,w} --> GLM's {w,x,y,z}
+
+  if (qrot) { q.x = qrot[0]; q.y = qrot[1]; q.z = qrot[2]; q.w = qrot[3]; }
+  else      { q.x = 0.0f;    q.y = 0.0f;    q.z = 0.0f;    q.w = 1.0f;    }
+
+  M = glm::mat4_cast(q);
+  if (trans) {
+    M = glm::translate(glm::mat4x4(1.f), *((const glm::vec3 *)(trans))) * M;
+  } else {
+    M = glm::translate(glm::mat4x4(1.f), -ctrRot);
+    M = glm::mat4_cast(q) * M;
+    M = glm::translate(M, ctrRot);
+  }
+  return M;
+}
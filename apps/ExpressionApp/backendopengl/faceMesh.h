@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __FACE_MESH_H
+#define __FACE_MESH_H
+
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "glMesh.h"
+#include "glSpectrum.h"
+#include "nvCVStatus.h"
+#include "openGLMeshRenderer.h"
+
+class SimpleFaceModelAdapter;
+class WorkerPool;
+struct SimpleFaceModel;
+
+
+/// The state of the incremental deformation, carried from one frame to the next.
+struct DeformState {
+  std::vector<float>            coeffs;             ///< The expression coefficients currently applied to the mesh.
+  unsigned                      framesSinceRebuild; ///< The number of incremental frames since the last full rebuild.
+  OpenGLMeshRendererDeformStats stats;              ///< Performance counters.
+
+  DeformState() : framesSinceRebuild(0), stats() {}
+  void invalidate() { coeffs.clear(); framesSinceRebuild = 0; }
+};
+
+/// The defaults shared by the renderers of face models, so that they render alike.
+enum {
+  kFaceMeshNumLights          = 2,    ///< The number of lights, as in LAMBERTIAN_NUM_LIGHTS.
+  kFaceMeshMaxDefaultThreads  = 15,   ///< The default number of worker threads is no more than this.
+  kFaceMeshRebuildInterval    = 300   ///< The default maximum number of incremental frames between full rebuilds.
+};
+extern const float        kFaceMeshSparseEpsilon;                   ///< The default sparse blend shape threshold.
+extern const float        kFaceMeshDeformThreshold;                 ///< The default incremental deformation threshold.
+extern const glm::vec4    kFaceMeshLightLoc[kFaceMeshNumLights];    ///< The light locations, xyzw.
+extern const GLSpectrum3f kFaceMeshLightColor[kFaceMeshNumLights];  ///< The light colors.
+extern const GLSpectrum3f kFaceMeshClearColor;                      ///< The background color.
+extern const GLSpectrum3f kFaceMeshDiffuse;                         ///< The diffuse color without a material.
+extern const GLSpectrum3f kFaceMeshAmbient;                         ///< The ambient color without a material.
+
+/// Get the number of worker threads to use.
+/// @param[in]  numThreads  the number of worker threads requested, or ~0u for the default, which is one less than
+///                         the number of hardware threads, up to kFaceMeshMaxDefaultThreads.
+/// @return the number of worker threads.
+unsigned FaceMeshNumThreads(unsigned numThreads);
+
+/// Make a renderable mesh from the mean shape, topology and partitions of a face model.
+/// @param[in]  fma   the face model.
+/// @param[out] mesh  the mesh, with vertex normals and the dual topology used to compute them quickly.
+/// @return NVCV_SUCCESS if successful, or NVCV_ERR_MISMATCH if the adjacencies are inconsistent.
+NvCV_Status MakeMesh(const SimpleFaceModelAdapter *fma, GLMesh *mesh);
+
+/// Deform the mesh to the given coefficients.
+/// If a state is supplied, and the identity is not, only the expression coefficients that have changed by more than
+/// the threshold since the previous frame are applied, as deltas to the mesh of the previous frame. The mesh is
+/// rebuilt from the mean shape every rebuildInterval frames, to bound the accumulation of rounding errors.
+/// @param[in]      model           the face model.
+/// @param[in]      identCoeffs     the identity coefficients, or NULL to use the mean shape.
+/// @param[in]      exprCoeffs      the expression coefficients, one per blend shape.
+/// @param[in,out]  mesh            the mesh, made by MakeMesh(), whose vertices and normals are updated.
+/// @param[in,out]  state           the incremental deformation state, or NULL to always rebuild.
+/// @param[in]      threshold       the largest change in a coefficient that is not applied incrementally.
+/// @param[in]      rebuildInterval the maximum number of incremental frames between full rebuilds.
+/// @param[in]      pool            the worker threads to share the work with, or NULL.
+/// @return NVCV_SUCCESS if successful.
+NvCV_Status DeformModel(const SimpleFaceModel& model, const float *identCoeffs, const float *exprCoeffs, GLMesh *mesh,
+                        DeformState *state = nullptr, float threshold = 0.f, unsigned rebuildInterval = 0,
+                        WorkerPool *pool = nullptr);
+
+/// Compute the viewing and projection matrices that frame a bounding box.
+/// @param[in]  bbox      the bounding box to be framed.
+/// @param[in]  lookAt    the direction of view.
+/// @param[in]  up        the up direction.
+/// @param[in]  vfov      the vertical field of view, in radians; 0 yields an orthographic projection.
+/// @param[in]  fracFill  the fraction of the viewport to be filled by the box.
+/// @param[in]  aspect    the aspect ratio of the viewport, width / height.
+/// @param[in]  yDir      the direction of Y: +1 up, -1 down.
+/// @param[in]  yOff      the fraction of the height of the box by which to move the center of view upward.
+/// @param[in]  z_near    the distance to the near clipping plane; if both this and z_far are 0, it is computed.
+/// @param[in]  z_far     the distance to the far  clipping plane; if both this and z_near are 0, it is computed.
+/// @param[out] V         the viewing matrix.
+/// @param[out] P         the projection matrix.
+void FrameBoundingBox(const GLMesh::BoundingBox& bbox, const glm::vec3& lookAt, const glm::vec3& up, float vfov,
+                      float fracFill, float aspect, float yDir, float yOff, float z_near, float z_far,
+                      glm::mat4x4 *V, glm::mat4x4 *P);
+
+/// Frame the face mesh, looking down -Z with Y up, as the renderers do by default.
+/// @param[in]  mesh      the face mesh.
+/// @param[in]  vfov      the vertical field of view, in radians; 0 yields an orthographic projection.
+/// @param[in]  aspect    the aspect ratio of the viewport, width / height.
+/// @param[in]  z_near    the distance to the near clipping plane, or 0 (with z_far) to compute it.
+/// @param[in]  z_far     the distance to the far  clipping plane, or 0 (with z_near) to compute it.
+/// @param[out] ctrRot    the center of rotation of the head.
+/// @param[out] V         the viewing matrix.
+/// @param[out] P         the projection matrix.
+/// @return NVCV_SUCCESS if successful, or NVCV_ERR_MODEL if the mesh is empty.
+NvCV_Status FrameFaceMesh(const GLMesh& mesh, float vfov, float aspect, float z_near, float z_far,
+                          glm::vec3 *ctrRot, glm::mat4x4 *V, glm::mat4x4 *P);
+
+/// Fit a symmetric perspective or orthographic projection, made for one aspect ratio, to another, preserving
+/// whichever of its horizontal or vertical field of view would otherwise be cropped.
+/// @param[in]  P           the projection matrix.
+/// @param[in]  fromAspect  the aspect ratio, width / height, for which P was made.
+/// @param[in]  toAspect    the desired aspect ratio.
+/// @return the projection matrix for the desired aspect ratio.
+glm::mat4x4 FitProjectionToAspect(const glm::mat4x4& P, float fromAspect, float toAspect);
+
+/// Compute the modeling matrix of the head.
+/// @param[in]  qrot    the rotation quaternion {x, y, z, w}, or NULL for no rotation.
+/// @param[in]  trans   the translation, or NULL to rotate about the center of rotation instead.
+/// @param[in]  ctrRot  the center of rotation, from FrameFaceMesh().
+/// @return the modeling matrix.
+glm::mat4x4 FaceModelMatrix(const float qrot[4], const float trans[3], const glm::vec3& ctrRot);
+
+
+#endif // __FACE_MESH_H
@@ -22,10 +22,26 @@
  */
 
 #include "glMesh.h"
+#include "workerPool.h"
 
+#include <math.h>
 #include <string.h>
 #include <algorithm>
 
+#ifdef _MSC_VER
+  #include "glad/glad.h"
+#else
+  #include <GLES3/gl3.h>
+#endif // _MSC_VER
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define GLMESH_SSE 1
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+  #define GLMESH_NEON 1
+  #include <arm_neon.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////                                                                        ////
@@ -75,12 +91,13 @@ GLMesh::GLMesh(const GLMesh& mesh) {
   m_textureIndices = mesh.m_textureIndices;
   m_normals = mesh.m_normals;
   m_normalIndices = mesh.m_normalIndices;
+  const_cast<GLMesh&>(mesh).syncFaceNormals();
   m_faceNormals = mesh.m_faceNormals;
-
+  m_faceNormalsStale = false;
 }
 
-GLMesh::GLMesh() { }
-GLMesh::~GLMesh() { }
+GLMesh::GLMesh() : m_faceNormalsStale(false) { }
+GLMesh::~GLMesh() { releaseBuffers(); }
 void        GLMesh::resizeVertices(unsigned n) { m_vertices.resize(n); }
 void        GLMesh::resizeTexCoords(unsigned n) {
               m_texCoords.resize(n);
@@ -90,9 +107,12 @@ void        GLMesh::resizeNormals(unsigned n) {
               m_normals.resize(n);
               m_normalIndices.resize(n ? unsigned(m_vertexIndices.size()) : 0);
             }
+void        GLMesh::swapVertices(std::vector<glm::vec3>& v) { m_vertices.swap(v); }
+void        GLMesh::swapNormals(std::vector<glm::vec3>& n) { m_normals.swap(n); }
 void        GLMesh::resizeFaces(unsigned n) { m_faceVertexCount.resize(n); }
 void        GLMesh::resizeTriangles(unsigned n) { m_faceVertexCount.clear(); m_faceVertexCount.resize(n, 3); }
 void        GLMesh::resizeVertexIndices(unsigned n) {
+              m_buffers.topologyStale = true;
               m_vertexIndices.resize(n);
               m_textureIndices.resize(m_texCoords.size() ? n : 0);
               m_normalIndices.resize(m_normals.size() ? n : 0);
@@ -100,6 +120,7 @@ void        GLMesh::resizeVertexIndices(unsigned n) {
 void        GLMesh::resizeDualIndices(unsigned n) {
               m_dualIndices.resize(n);
               m_vertexFaceCount.resize(m_vertices.size());
+              m_dualOffsets.clear();
             }
 void        GLMesh::useFaceNormals(bool yes) { m_faceNormals.resize(yes ? numFaces() : 0); }
 
@@ -234,6 +255,9 @@ void GLMesh::clear() {
   m_vertexIndices.resize(0);
   m_textureIndices.resize(0);
   m_normalIndices.resize(0);
+  m_dualOffsets.clear();
+  m_faceNormalsStale = false;
+  m_buffers.topologyStale = true;
   initPartitions();
 }
 
@@ -253,6 +277,7 @@ glm::vec3* GLMesh::getNormals() {
 }
 
 glm::vec3* GLMesh::getFaceNormals() {
+  syncFaceNormals();
   assureConsistency();
   return m_faceNormals.size() ? m_faceNormals.data() : nullptr;
 }
@@ -263,7 +288,7 @@ const glm::vec3* GLMesh::getNormals()     const { return const_cast<GLMesh*>(thi
 const glm::vec3* GLMesh::getFaceNormals() const { return const_cast<GLMesh*>(this)->getFaceNormals(); }
 
 unsigned short* GLMesh::getFaceVertexCounts() { return m_faceVertexCount.data(); }
-unsigned short* GLMesh::getVertexIndices() { return m_vertexIndices.data(); }
+unsigned short* GLMesh::getVertexIndices() { m_buffers.topologyStale = true; return m_vertexIndices.data(); }
 unsigned short* GLMesh::getTextureIndices() {
   return m_textureIndices.size() ? m_textureIndices.data() : nullptr;
 }
@@ -275,12 +300,19 @@ const unsigned short* GLMesh::getVertexIndices()    const { return m_vertexIndic
 const unsigned short* GLMesh::getTextureIndices()   const { return const_cast<GLMesh*>(this)->getTextureIndices(); }
 const unsigned short* GLMesh::getNormalIndices()    const { return const_cast<GLMesh*>(this)->getNormalIndices(); }
 
-unsigned short* GLMesh::getVertexFaceCounts() { return m_vertexFaceCount.data(); }
+unsigned short* GLMesh::getVertexFaceCounts() {
+  m_dualOffsets.clear();  // The counts may be changed, so the offsets will be recomputed
+  return m_vertexFaceCount.data();
+}
 unsigned short* GLMesh::getDualIndices() {
   return m_dualIndices.size() ? m_dualIndices.data() : nullptr;
 }
-const unsigned short* GLMesh::getVertexFaceCounts() const { return const_cast<GLMesh*>(this)->getVertexFaceCounts(); }
+const unsigned short* GLMesh::getVertexFaceCounts() const { return m_vertexFaceCount.data(); }
 const unsigned short* GLMesh::getDualIndices() const { return const_cast<GLMesh*>(this)->getDualIndices(); }
+const unsigned* GLMesh::getDualOffsets() const {
+  const_cast<GLMesh*>(this)->updateDualOffsets();
+  return m_dualOffsets.size() ? m_dualOffsets.data() : nullptr;
+}
 
 
 void GLMesh::addVertex(float x, float y, float z) { m_vertices.emplace_back(glm::vec3{ x, y, z }); }
@@ -310,6 +342,7 @@ void GLMesh::addFace(unsigned numVertices, const unsigned short *vertexIndices,
   const unsigned short *textureIndices, const unsigned short *normalIndices)
 {
   size_t n;
+  m_buffers.topologyStale = true;
   m_faceVertexCount.push_back((unsigned short)numVertices);
   if (vertexIndices) {
     n = m_vertexIndices.size();
@@ -336,6 +369,7 @@ void GLMesh::addFaces(unsigned numFaces, unsigned numVerticesPerFace, const unsi
     indexBytes = numIndices * sizeof(*vertexIndices);
   size_t n;
 
+  m_buffers.topologyStale = true;
   n = m_faceVertexCount.size();
   m_faceVertexCount.resize(n + numFaces, (unsigned short)numVerticesPerFace);
 
@@ -391,6 +425,7 @@ bool GLMesh::isTriQuadMesh() const {
 
 
 void GLMesh::transform(const glm::mat4x4& M) {
+  syncFaceNormals();
   TransformPoints (M, unsigned(m_vertices.size()),    m_vertices.data(),    m_vertices.data());
   TransformNormals(M, unsigned(m_normals.size()),     m_normals.data(),     m_normals.data());
   TransformNormals(M, unsigned(m_faceNormals.size()), m_faceNormals.data(), m_faceNormals.data());
@@ -414,19 +449,38 @@ NvCV_Status GLMesh::setMaterial(const char *name) {
 }
 
 
-void GLMesh::computeFaceNormals(int weighted) {
+enum {
+  kFacesPerChunk    = 2048,   // 2048 faces: 12 KB of indices and 24 KB of face normals
+  kVerticesPerChunk = 2048    // 2048 vertices: 24 KB of vertex normals, gathered from about 6 faces each
+};
+
+/* Compute the starting index of each chunk from the per-element counts, so that chunks of faces with
+ * differing numbers of vertices can be processed independently. The last entry is the total.
+ */
+static void ComputeChunkStarts(unsigned n, const unsigned short *counts, unsigned chunk, std::vector<unsigned>& starts) {
+  unsigned i, sum;
+  starts.resize((n + chunk - 1) / chunk + 1);
+  for (i = 0, sum = 0; i < n; ++i) {
+    if (0 == i % chunk) starts[i / chunk] = sum;
+    sum += counts[i];
+  }
+  starts.back() = sum;
+}
+
+
+void GLMesh::computeFaceNormals(glm::vec3 *faceNormals, unsigned faceBegin, unsigned faceEnd, unsigned indexBegin,
+                                int weighted) {
   const glm::vec3 *vertices = m_vertices.data();
-  const unsigned short *numVertices = m_faceVertexCount.data();
+  const unsigned short *numVertices = m_faceVertexCount.data() + faceBegin;
   glm::vec3 *nrm, *nrmEnd;
   const unsigned short *ix;
   const glm::vec3 *p0, *p1, *p2;
   glm::vec3 n;
   float mag;
 
-  useFaceNormals(true);
-  nrm = getFaceNormals();
-  nrmEnd = nrm + numFaces();
-  ix = m_vertexIndices.data();
+  nrm = faceNormals + faceBegin;
+  nrmEnd = faceNormals + faceEnd;
+  ix = m_vertexIndices.data() + indexBegin;
 
   for (; nrm != nrmEnd; ++nrm, ix += *numVertices++) {
     if (3 == *numVertices) {
@@ -456,22 +510,250 @@ void GLMesh::computeFaceNormals(int weighted) {
 }
 
 
-void GLMesh::computeVertexNormals(int weighted) {
-  glm::vec3 nrm;
+/* A minimal vector of 4 floats, so that the normal kernels are written once for every instruction set.
+ * V4RNorm() returns 1/sqrt(d2) from a reciprocal square root estimate refined with one Newton-Raphson step,
+ * accurate to about 1 ulp, or 0 where d2 is 0 so that degenerate faces get a zero normal rather than NaNs.
+ */
+#if defined(GLMESH_SSE)
+  typedef __m128 V4;
+  static inline V4 V4Set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+  static inline V4 V4Add(V4 a, V4 b) { return _mm_add_ps(a, b); }
+  static inline V4 V4Sub(V4 a, V4 b) { return _mm_sub_ps(a, b); }
+  static inline V4 V4Mul(V4 a, V4 b) { return _mm_mul_ps(a, b); }
+  static inline V4 V4Zero() { return _mm_setzero_ps(); }
+  static inline V4 V4Load(const float *p) { return _mm_loadu_ps(p); }
+  static inline void V4Store(float *p, V4 a) { _mm_storeu_ps(p, a); }
+  static inline void V4Transpose(V4& a, V4& b, V4& c, V4& d) { _MM_TRANSPOSE4_PS(a, b, c, d); }
+  static inline V4 V4RNorm(V4 d2) {
+    V4 r = _mm_rsqrt_ps(d2);
+    r = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), r), _mm_sub_ps(_mm_set1_ps(3.f), _mm_mul_ps(_mm_mul_ps(d2, r), r)));
+    return _mm_and_ps(r, _mm_cmpgt_ps(d2, _mm_setzero_ps()));
+  }
+#elif defined(GLMESH_NEON)
+  typedef float32x4_t V4;
+  static inline V4 V4Set(float a, float b, float c, float d) { const float v[4] = { a, b, c, d }; return vld1q_f32(v); }
+  static inline V4 V4Add(V4 a, V4 b) { return vaddq_f32(a, b); }
+  static inline V4 V4Sub(V4 a, V4 b) { return vsubq_f32(a, b); }
+  static inline V4 V4Mul(V4 a, V4 b) { return vmulq_f32(a, b); }
+  static inline V4 V4Zero() { return vdupq_n_f32(0.f); }
+  static inline V4 V4Load(const float *p) { return vld1q_f32(p); }
+  static inline void V4Store(float *p, V4 a) { vst1q_f32(p, a); }
+  static inline void V4Transpose(V4& a, V4& b, V4& c, V4& d) {
+    float32x4x2_t ab = vtrnq_f32(a, b), cd = vtrnq_f32(c, d);
+    a = vcombine_f32(vget_low_f32(ab.val[0]),  vget_low_f32(cd.val[0]));
+    b = vcombine_f32(vget_low_f32(ab.val[1]),  vget_low_f32(cd.val[1]));
+    c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+    d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+  }
+  static inline V4 V4RNorm(V4 d2) {
+    V4 r = vrsqrteq_f32(d2);
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(d2, r), r));
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(r), vcgtq_f32(d2, vdupq_n_f32(0.f))));
+  }
+#else
+  struct V4 { float v[4]; };
+  static inline V4 V4Set(float a, float b, float c, float d) { V4 r = { { a, b, c, d } }; return r; }
+  static inline V4 V4Add(V4 a, V4 b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+  static inline V4 V4Sub(V4 a, V4 b) { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+  static inline V4 V4Mul(V4 a, V4 b) { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+  static inline V4 V4Zero() { V4 r = { { 0.f, 0.f, 0.f, 0.f } }; return r; }
+  static inline V4 V4Load(const float *p) { V4 r; memcpy(r.v, p, sizeof(r.v)); return r; }
+  static inline void V4Store(float *p, V4 a) { memcpy(p, a.v, sizeof(a.v)); }
+  static inline void V4Transpose(V4& a, V4& b, V4& c, V4& d) {
+    V4 m[4] = { a, b, c, d };
+    for (int i = 0; i < 4; ++i) { a.v[i] = m[i].v[0]; b.v[i] = m[i].v[1]; c.v[i] = m[i].v[2]; d.v[i] = m[i].v[3]; }
+  }
+  static inline V4 V4RNorm(V4 d2) {
+    for (int i = 0; i < 4; ++i) d2.v[i] = (d2.v[i] > 0.f) ? 1.f / sqrtf(d2.v[i]) : 0.f;
+    return d2;
+  }
+#endif
+
+static inline V4 V4Dot(V4 ax, V4 ay, V4 az, V4 bx, V4 by, V4 bz) {
+  return V4Add(V4Add(V4Mul(ax, bx), V4Mul(ay, by)), V4Mul(az, bz));
+}
+
+
+/* Compute the unit normals of the 4 triangles with the given 12 vertex indices, as 4 { x, y, z, 0 } vectors. */
+static inline void TriNormals4(const glm::vec3 *vtx, const unsigned short *ix, float *nrm4) {
+  const glm::vec3 *a0 = &vtx[ix[0]], *a1 = &vtx[ix[3]], *a2 = &vtx[ix[6]], *a3 = &vtx[ix[ 9]],
+                  *b0 = &vtx[ix[1]], *b1 = &vtx[ix[4]], *b2 = &vtx[ix[7]], *b3 = &vtx[ix[10]],
+                  *c0 = &vtx[ix[2]], *c1 = &vtx[ix[5]], *c2 = &vtx[ix[8]], *c3 = &vtx[ix[11]];
+  V4 ax = V4Set(a0->x, a1->x, a2->x, a3->x), ay = V4Set(a0->y, a1->y, a2->y, a3->y),
+     az = V4Set(a0->z, a1->z, a2->z, a3->z);
+  V4 ex = V4Sub(V4Set(b0->x, b1->x, b2->x, b3->x), ax), ey = V4Sub(V4Set(b0->y, b1->y, b2->y, b3->y), ay),
+     ez = V4Sub(V4Set(b0->z, b1->z, b2->z, b3->z), az);
+  V4 fx = V4Sub(V4Set(c0->x, c1->x, c2->x, c3->x), ax), fy = V4Sub(V4Set(c0->y, c1->y, c2->y, c3->y), ay),
+     fz = V4Sub(V4Set(c0->z, c1->z, c2->z, c3->z), az);
+  V4 cx = V4Sub(V4Mul(ey, fz), V4Mul(ez, fy)),
+     cy = V4Sub(V4Mul(ez, fx), V4Mul(ex, fz)),
+     cz = V4Sub(V4Mul(ex, fy), V4Mul(ey, fx)),
+     r  = V4RNorm(V4Dot(cx, cy, cz, cx, cy, cz)),
+     cw = V4Zero();
+  cx = V4Mul(cx, r);
+  cy = V4Mul(cy, r);
+  cz = V4Mul(cz, r);
+  V4Transpose(cx, cy, cz, cw);                          // SoA --> AoS, one vector per face
+  V4Store(nrm4 +  0, cx);
+  V4Store(nrm4 +  4, cy);
+  V4Store(nrm4 +  8, cz);
+  V4Store(nrm4 + 12, cw);
+}
+
+
+/* Compute unit face normals for the triangles [faceBegin, faceEnd), 4 faces at a time in SoA form.
+ * Positions are gathered by index, so they stay interleaved: each vertex is then a single cache line.
+ * The normals are stored as padded { x, y, z, 0 } vectors, so that they can be gathered into the vertex normals
+ * with a single vector load each.
+ */
+void GLMesh::computeTriFaceNormals4(unsigned faceBegin, unsigned faceEnd) {
+  const glm::vec3 *vtx = m_vertices.data();
+  const unsigned short *ix = m_vertexIndices.data() + size_t(faceBegin) * 3;
+  float *nrm4 = m_faceNormals4.data() + size_t(faceBegin) * 4;
+  unsigned f;
+
+  for (f = faceBegin; f + 4 <= faceEnd; f += 4, ix += 12, nrm4 += 16)
+    TriNormals4(vtx, ix, nrm4);
+  if (f < faceEnd) {                                    // The array is padded to a multiple of 4,
+    unsigned short tail[12] = { 0 };                    // so pad the last few with degenerate faces
+    memcpy(tail, ix, (faceEnd - f) * 3 * sizeof(*ix));
+    TriNormals4(vtx, tail, nrm4);
+  }
+}
+
+
+/* Sum the face normals around each vertex in [vertexBegin, vertexEnd) via the CSR dual topology,
+ * and normalize them 4 at a time in SoA form.
+ */
+void GLMesh::gatherVertexNormals4(unsigned vertexBegin, unsigned vertexEnd) {
+  const float *nrm4 = m_faceNormals4.data();
+  const unsigned short *dual = m_dualIndices.data();
+  const unsigned *offsets = m_dualOffsets.data();
+  glm::vec3 *normals = m_normals.data();
+  float out[12];
+  V4 sum[4];
+  unsigned v, i, n, k, kEnd;
+
+  for (v = vertexBegin; v < vertexEnd; v += 4) {
+    n = (vertexEnd - v < 4) ? vertexEnd - v : 4;
+    for (i = 0; i < 4; ++i) {
+      sum[i] = V4Zero();
+      if (i < n)
+        for (k = offsets[v + i], kEnd = offsets[v + i + 1]; k != kEnd; ++k)
+          sum[i] = V4Add(sum[i], V4Load(nrm4 + dual[k] * 4u));
+    }
+    V4Transpose(sum[0], sum[1], sum[2], sum[3]);        // AoS --> SoA
+    V4 r = V4RNorm(V4Dot(sum[0], sum[1], sum[2], sum[0], sum[1], sum[2]));
+    V4Store(out + 0, V4Mul(sum[0], r));
+    V4Store(out + 4, V4Mul(sum[1], r));
+    V4Store(out + 8, V4Mul(sum[2], r));
+    for (i = 0; i < n; ++i)
+      normals[v + i] = glm::vec3(out[i], out[4 + i], out[8 + i]);
+  }
+}
+
+
+void GLMesh::updateDualOffsets() {
+  unsigned nv = unsigned(m_vertexFaceCount.size()), i;
+  if (nv != m_vertices.size() || m_dualOffsets.size() == size_t(nv) + 1)
+    return;
+  m_dualOffsets.resize(size_t(nv) + 1);
+  m_dualOffsets[0] = 0;
+  for (i = 0; i < nv; ++i)
+    m_dualOffsets[i + 1] = m_dualOffsets[i] + m_vertexFaceCount[i];
+}
+
+
+void GLMesh::syncFaceNormals() {
+  if (!m_faceNormalsStale) return;
+  const float *nrm4 = m_faceNormals4.data();
+  unsigned f, nf = unsigned(m_faceNormals.size());
+  for (f = 0; f < nf; ++f, nrm4 += 4)
+    m_faceNormals[f] = glm::vec3(nrm4[0], nrm4[1], nrm4[2]);
+  m_faceNormalsStale = false;
+}
+
+
+void GLMesh::computeFaceNormals(int weighted, WorkerPool *pool) {
+  unsigned nf = numFaces();
+  bool parallel = pool && pool->numThreads() && nf > kFacesPerChunk;
+
+  useFaceNormals(true);
+  if (0 == weighted && isTriMesh()) {                   // Fast path
+    m_faceNormals4.resize(size_t((nf + 3) & ~3u) * 4);
+    if (!parallel)
+      computeTriFaceNormals4(0, nf);
+    else
+      pool->parallelFor(0, nf, kFacesPerChunk, [this](size_t b, size_t e) {
+        computeTriFaceNormals4(unsigned(b), unsigned(e));
+      });
+    m_faceNormalsStale = true;                          // Assemble the AoS view only on demand
+    return;
+  }
+
+  m_faceNormalsStale = false;
+  assureConsistency();                                  // Size the arrays here, rather than in every worker
+  glm::vec3 *faceNormals = m_faceNormals.data();
+  if (!parallel) {
+    computeFaceNormals(faceNormals, 0, nf, 0, weighted);
+  }
+  else if (isTriMesh()) {                               // The indices of each chunk are found by multiplication
+    pool->parallelFor(0, nf, kFacesPerChunk, [this, faceNormals, weighted](size_t b, size_t e) {
+      computeFaceNormals(faceNormals, unsigned(b), unsigned(e), unsigned(b) * 3, weighted);
+    });
+  }
+  else {
+    std::vector<unsigned> starts;
+    ComputeChunkStarts(nf, m_faceVertexCount.data(), kFacesPerChunk, starts);
+    pool->parallelFor(0, nf, kFacesPerChunk, [this, faceNormals, weighted, &starts](size_t b, size_t e) {
+      computeFaceNormals(faceNormals, unsigned(b), unsigned(e), starts[b / kFacesPerChunk], weighted);
+    });
+  }
+}
+
+
+void GLMesh::computeVertexNormals(unsigned vertexBegin, unsigned vertexEnd) {
+  const glm::vec3 *faceNormals = m_faceNormals.data();
+  const unsigned short *ix, *ixEnd;
+  const unsigned *offsets = m_dualOffsets.data() + vertexBegin;
+  glm::vec3 *n, *nEnd, nrm;
+
+  for (nEnd = (n = m_normals.data() + vertexBegin) + (vertexEnd - vertexBegin); n != nEnd; ++n, ++offsets) {
+    for (ix = m_dualIndices.data() + offsets[0], ixEnd = m_dualIndices.data() + offsets[1], nrm = { 0.f, 0.f, 0.f };
+         ix != ixEnd; ++ix)
+      nrm += faceNormals[*ix];
+    *n = glm::normalize(nrm);
+  }
+}
 
-  computeFaceNormals(weighted);
+
+void GLMesh::computeVertexNormals(int weighted, WorkerPool *pool) {
+  unsigned nv = numVertices();
+  bool parallel = pool && pool->numThreads() && nv > kVerticesPerChunk;
+
+  computeFaceNormals(weighted, pool);
   if (m_normals.size() != m_vertices.size()) {
     m_normals.resize(m_vertices.size());
     m_normalIndices = m_vertexIndices;
   }
 
   if (m_vertexFaceCount.size() == m_vertices.size()) {  // We already have the dual topology
-    glm::vec3 *n, *nEnd;
-    unsigned short *numPolys, *ix, *ixEnd;
-    for (nEnd = (n = m_normals.data()) + m_vertexFaceCount.size(), numPolys = m_vertexFaceCount.data(), ix = m_dualIndices.data(); n != nEnd; ++n, ++numPolys) {
-      for (ixEnd = ix + *numPolys, nrm = { 0.f, 0.f, 0.f }; ix != ixEnd; ++ix)
-        nrm += m_faceNormals[*ix];
-      *n = glm::normalize(nrm);
+    updateDualOffsets();
+    if (m_faceNormalsStale) {                           // Fast path: the face normals are in m_faceNormals4
+      if (!parallel)
+        gatherVertexNormals4(0, nv);
+      else
+        pool->parallelFor(0, nv, kVerticesPerChunk, [this](size_t b, size_t e) {
+          gatherVertexNormals4(unsigned(b), unsigned(e));
+        });
+    }
+    else {
+      if (!parallel)
+        computeVertexNormals(0, nv);
+      else
+        pool->parallelFor(0, nv, kVerticesPerChunk, [this](size_t b, size_t e) {
+          computeVertexNormals(unsigned(b), unsigned(e));
+        });
     }
   }
 }
@@ -622,3 +904,87 @@ NvCV_Status GLMesh::append(const GLMesh& other, const glm::mat4x4 *M) {
 
   return NVCV_SUCCESS;
 }
+
+
+/********************************************************************************
+ * GL buffer objects
+ ********************************************************************************/
+
+// Vertex array objects are core in OpenGL 3.0, but the window context may be 2.x.
+static bool ContextHasVertexArrays() {
+  const char *version = (const char*)glGetString(GL_VERSION);
+  if (!version) return false;
+  for (; *version && !(*version >= '0' && *version <= '9'); ++version) {}  // Skip "OpenGL ES "
+  #ifdef _MSC_VER
+    if (!glGenVertexArrays) return false;   // GLAD did not load it
+  #endif // _MSC_VER
+  return *version >= '3';
+}
+
+
+NvCV_Status GLMesh::bindBuffers(unsigned *vtxBuf, unsigned *nrmOff, unsigned *indexBuf) {
+  GLBuffers& gb = m_buffers;
+  size_t posBytes = m_vertices.size() * sizeof(m_vertices[0]),
+         vtxBytes = posBytes + m_normals.size() * sizeof(m_normals[0]);
+
+  if (m_normals.size() != m_vertices.size())
+    return NVCV_ERR_MISMATCH;
+  if (!gb.vbo) {
+    if (!gb.noVAO && !gb.vao) {
+      if (ContextHasVertexArrays())   glGenVertexArrays(1, &gb.vao);
+      else                            gb.noVAO = true;
+    }
+    glGenBuffers(1, &gb.vbo);
+    glGenBuffers(1, &gb.ibo);
+    gb.topologyStale = true;
+    if (!gb.vbo || !gb.ibo) {
+      releaseBuffers();
+      return NVCV_ERR_OPENGL;
+    }
+  }
+  if (gb.vao)
+    glBindVertexArray(gb.vao);  // The index buffer binding is part of its state
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gb.ibo);
+  if (gb.topologyStale) {
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_vertexIndices.size() * sizeof(m_vertexIndices[0]), m_vertexIndices.data(),
+                 GL_STATIC_DRAW);
+    gb.topologyStale = false;
+  }
+
+  // Orphan the storage of the previous frame rather than overwriting it in place, which might wait for the GPU.
+  glBindBuffer(GL_ARRAY_BUFFER, gb.vbo);
+  glBufferData(GL_ARRAY_BUFFER, vtxBytes, nullptr, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, posBytes, m_vertices.data());
+  glBufferSubData(GL_ARRAY_BUFFER, posBytes, vtxBytes - posBytes, m_normals.data());
+
+  *vtxBuf   = gb.vbo;
+  *nrmOff   = unsigned(posBytes);
+  *indexBuf = gb.ibo;
+  return (GL_NO_ERROR == glGetError()) ? NVCV_SUCCESS : NVCV_ERR_OPENGL;
+}
+
+
+void GLMesh::unbindBuffers() {
+  if (m_buffers.vao)
+    glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+
+void GLMesh::releaseBuffers() {
+  GLBuffers& gb = m_buffers;
+  if (gb.vao) glDeleteVertexArrays(1, &gb.vao);
+  if (gb.vbo) glDeleteBuffers(1, &gb.vbo);
+  if (gb.ibo) glDeleteBuffers(1, &gb.ibo);
+  abandonBuffers();
+}
+
+
+void GLMesh::abandonBuffers() {
+  GLBuffers& gb = m_buffers;
+  gb.vao = gb.vbo = gb.ibo = 0;
+  gb.noVAO = false;
+  gb.topologyStale = true;
+}
@@ -30,6 +30,7 @@
 #include "glm/glm.hpp"
 #include "nvCVStatus.h"
 
+class WorkerPool;
 
 class GLMesh {
 public:
@@ -120,6 +121,14 @@ public:
   void                    resizeDualIndices(unsigned numIndices);
   void                    clear();
 
+  /// Exchange the vertices with those in another array, of the same size, without copying.
+  /// @param[in,out]  vertices  the vertices to be swapped in; the mesh's former vertices are swapped out.
+  void                    swapVertices(std::vector<glm::vec3>& vertices);
+
+  /// Exchange the vertex normals with those in another array, of the same size, without copying.
+  /// @param[in,out]  normals   the normals to be swapped in; the mesh's former normals are swapped out.
+  void                    swapNormals(std::vector<glm::vec3>& normals);
+
   glm::vec3*              getVertices();                  ///< Get the vertices. @return a pointer to the vertices.
   const glm::vec3*        getVertices()           const;  ///< Get the vertices. @return a pointer to the vertices.
   glm::vec2*              getTexCoords();                 ///< Get the texture coordinates. @return a pointer to the texture coordinates.
@@ -141,6 +150,11 @@ public:
   unsigned short*         getDualIndices();               ///< Get the face indices for each vertex: the dual topology. @return a pointer to the dual face indices.
   const unsigned short*   getDualIndices()        const;  ///< Get the face indices for each vertex: the dual topology. @return a pointer to the dual face indices.
 
+  /// Get the compressed sparse row offsets of the dual topology: the faces incident to vertex v are
+  /// getDualIndices()[offsets[v]] ... getDualIndices()[offsets[v+1]-1]. They are computed from the face counts on demand.
+  /// @return a pointer to numVertices() + 1 offsets, or NULL if there is no dual topology.
+  const unsigned*         getDualOffsets()        const;
+
   void                    addVertex(float x, float y, float z);
   void                    addTexCoord(float u, float v);
   void                    addNormal(float x, float y, float z);
@@ -156,18 +170,24 @@ public:
                               const unsigned short* textureIndices, const unsigned short* normalIndices);
 
   /// Compute the normals per face.
+  /// Unit normals of triangle meshes are computed with SIMD, 4 faces at a time, into an internal padded array,
+  /// from which getFaceNormals() assembles the array of vectors only when it is requested.
   /// @param[in]  specify the weighing for the normals. In all cases, the zero vector will
   ///             be returned for faces with zero area.
   ///             0:  unit vectors.
   ///             +1: vectors weighted by the area.
   ///             -1: vectors weighted by the reciprocal of the area.
-  void                    computeFaceNormals(int weighted = 0);
+  /// @param[in]  pool      if not NULL, the faces are split into chunks that are computed in parallel.
+  void                    computeFaceNormals(int weighted = 0, WorkerPool *pool = nullptr);
 
   /// Compute the vertex normals. The face normals will be computed in the process.
   /// @param[in]  weighted  Determines the weighting used to combine the face normals:
   ///                       0: all incident faces normals will have the same weight.
   ///                       -1: the normals will be weighted by inverse area of the face.
-  void                    computeVertexNormals(int weighted = 0);
+  /// @param[in]  pool      if not NULL, the faces and vertices are split into chunks that are computed in parallel.
+  ///                       Each vertex normal is gathered from its faces via the dual topology, so no two threads
+  ///                       write the same normal.
+  void                    computeVertexNormals(int weighted = 0, WorkerPool *pool = nullptr);
 
   void                    transform(const glm::mat4x4& M);
 
@@ -244,6 +264,28 @@ public:
   /// @param[in]  M       an optional affine transform
   NvCV_Status             append(const GLMesh& mesh, const glm::mat4x4* M = nullptr);
 
+  /// Update the OpenGL buffer objects of the mesh, and bind its vertex array object, if the context supports one.
+  /// The buffers are made on the first call. The vertex indices are uploaded only when the topology has changed since
+  /// the previous call, but the positions and normals are streamed every time, into an orphaned buffer, so that the
+  /// driver need not wait for draws still reading the previous frame. An OpenGL context must be current.
+  /// @param[out] vtxBuf    a place to store the vertex buffer, holding all positions, then all normals.
+  /// @param[out] nrmOff    a place to store the byte offset of the normals in the vertex buffer.
+  /// @param[out] indexBuf  a place to store the index buffer, holding the unsigned short vertex indices.
+  /// @return     NVCV_SUCCESS        if successful;
+  ///             NVCV_ERR_MISMATCH   if there is not one normal per vertex;
+  ///             NVCV_ERR_OPENGL     if the buffers could not be made.
+  NvCV_Status             bindBuffers(unsigned* vtxBuf, unsigned* nrmOff, unsigned* indexBuf);
+
+  /// Unbind the vertex array object bound by bindBuffers(), so that other draws do not change it.
+  void                    unbindBuffers();
+
+  /// Delete the OpenGL buffer objects. This is done upon destruction, too, but the context that made them must be
+  /// current either way.
+  void                    releaseBuffers();
+
+  /// Forget the OpenGL buffer objects without deleting them, when the context that made them cannot be made current.
+  void                    abandonBuffers();
+
   /// Bit vector components indicating non-renderability.
   enum {
     RENDERABLE        = 0x0,  ///< The PolyMesh is renderable.
@@ -257,6 +299,23 @@ private:
   static bool indicesMatch(const std::vector<unsigned short>& ivecA, const std::vector<unsigned short>& ivecB);
   void        assureConsistency();
   void        useFaceNormals(bool yes);
+  void        computeFaceNormals(glm::vec3 *faceNormals, unsigned faceBegin, unsigned faceEnd, unsigned indexBegin,
+                                 int weighted);
+  void        computeVertexNormals(unsigned vertexBegin, unsigned vertexEnd);
+  void        computeTriFaceNormals4(unsigned faceBegin, unsigned faceEnd);
+  void        gatherVertexNormals4(unsigned vertexBegin, unsigned vertexEnd);
+  void        updateDualOffsets();
+  void        syncFaceNormals();
+
+  /// The OpenGL objects of a mesh, which belong to its context, and are never copied with it.
+  struct GLBuffers {
+    unsigned  vao, vbo, ibo;        // GLuint
+    bool      noVAO;                // The context has no vertex array objects
+    bool      topologyStale;        // The indices need to be uploaded
+    GLBuffers() : vao(0), vbo(0), ibo(0), noVAO(false), topologyStale(true) {}
+    GLBuffers(const GLBuffers&) : GLBuffers() {}
+    GLBuffers& operator=(const GLBuffers&) { topologyStale = true; return *this; }
+  };
 
   std::vector<unsigned short> m_faceVertexCount;
 
@@ -275,6 +334,11 @@ private:
 
   std::vector<unsigned short> m_vertexFaceCount;  // the number of faces surrounding each vertex
   std::vector<unsigned short> m_dualIndices;      // the face indices for each vertex
+  std::vector<unsigned>       m_dualOffsets;      // the CSR offset of each vertex into m_dualIndices, plus the total
+
+  std::vector<float>          m_faceNormals4;     // the unit face normals of a TriMesh, as padded { x, y, z, 0 }
+  bool                        m_faceNormalsStale; // m_faceNormals needs to be assembled from m_faceNormals4
+  GLBuffers                   m_buffers;          // the vertices and indices, on the GPU
 };
 
 #endif // __GLMESH_H
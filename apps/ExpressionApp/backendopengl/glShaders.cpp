@@ -602,7 +602,7 @@ void LambertianRenderer::drawElements(GLsizei numVertices, const GLfloat *positi
  ********************************************************************************/
 
 void LambertianRenderer::drawElements(GLuint vtxBuf, unsigned posOff, unsigned nrmOff,
-    GLenum graphicsMode, GLsizei numIndices, unsigned indexSize, GLuint indexBuf,
+    GLenum graphicsMode, GLsizei numIndices, unsigned indexSize, GLuint indexBuf, unsigned firstIndex,
     const GLfloat M[4*4], const GLfloat VP[4*4], const float Ka[3], const float Kd[3]
 ) {
   GLenum  err;
@@ -628,5 +628,5 @@ void LambertianRenderer::drawElements(GLuint vtxBuf, unsigned posOff, unsigned n
     glVertexAttribPointer(_vtxNrmID, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(intptr_t)(posOff + 3 * sizeof(float)));
     err = glGetError(); if (err) printf("glVertexAttribPointer returns %d\n", err);
   }
-  glDrawElements(graphicsMode, numIndices, IndexTypeFromSize(indexSize), (void*)0);
+  glDrawElements(graphicsMode, numIndices, IndexTypeFromSize(indexSize), (void*)(intptr_t)(firstIndex * indexSize));
 }
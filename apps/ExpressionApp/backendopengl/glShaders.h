@@ -305,14 +305,16 @@ public:
    * @param[in]   numIndices  the number of indices.
    * @param[in]   indexBuf    the index buffer object identifier.
    * @param[in]   indexSize   the byte size of the indices: 1, 2, or 4.
+   * @param[in]   firstIndex  the index in the index buffer of the first index to draw, e.g. of a partition.
    * @param[in]   M           The      modeling      matrix. If NULL, the previous matrix will be used.
    * @param[in]   VP          The viewing+projection matrix. If NULL, the previous matrix will be used.
    * @param[in]   Ka          The ambient color {r, g, b}. If NULL, the previous ambient color will be used.
    * @param[in]   Kd          The diffuse color {r, g, b}. If NULL, the previous diffuse color will be used.
    */
-  void drawTriMesh(GLuint vtxBuf, unsigned xyzOff, unsigned rgbOff, unsigned numIndices, GLuint indexBuf, GLenum indexSize,
+  void drawTriMesh(GLuint vtxBuf, unsigned xyzOff, unsigned nrmOff, unsigned numIndices, GLuint indexBuf, GLenum indexSize,
+        unsigned firstIndex = 0,
         const float* M = nullptr, const float* VP = nullptr, const float* Ka = nullptr, const float* Kd = nullptr) {
-    drawElements(vtxBuf, xyzOff, rgbOff, GL_TRIANGLES, numIndices, indexSize, indexBuf, M, VP, Ka, Kd);
+    drawElements(vtxBuf, xyzOff, nrmOff, GL_TRIANGLES, numIndices, indexSize, indexBuf, firstIndex, M, VP, Ka, Kd);
   }
 
 private:
@@ -347,13 +349,14 @@ private:
    *                              from the vertices and graphics mode.
    * @param[in]   indexSize       The size of index { 1, 2, 4 } in bytes.
    * @param[in]   indexBuf        The ID of the GL buffer used to store the indices.
+   * @param[in]   firstIndex      The index of the first index to be drawn, in the index buffer.
    * @param[in]   M               The modeling matrix.
    * @param[in]   VP              The viewing+projection matrix.
    * @param[in]   Ka              The ambient color.
    * @param[in]   Kd              The diffuse color.
    */
   void drawElements(GLuint vtxBuf, unsigned posOff, unsigned nrmOff,
-        GLenum graphicsMode, GLsizei numIndices, unsigned indexSize, GLuint indexBuf,
+        GLenum graphicsMode, GLsizei numIndices, unsigned indexSize, GLuint indexBuf, unsigned firstIndex,
         const GLfloat M[4 * 4], const GLfloat VP[4 * 4], const float Ka[3], const float Kd[3]);
 
   GLuint              _programID;
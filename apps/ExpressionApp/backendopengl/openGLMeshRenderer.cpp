@@ -23,7 +23,9 @@
 
 #include "openGLMeshRenderer.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <string>
 #include <vector>
@@ -35,6 +37,14 @@
 #include <GLES3/gl3.h>
 #endif  // _MSC_VER
 
+#ifdef OPENGL_HEADLESS      // Offscreen rendering with EGL, without a display server; defined if EGL was found
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <map>
+#include <mutex>
+#endif  // OPENGL_HEADLESS
+
+#include "faceMesh.h"
 #include "faceIO.h"
 #include "GLFW/glfw3.h"
 #include "glm/glm.hpp"
@@ -49,6 +59,7 @@
 #include "nvCVOpenCV.h"
 #include "opencv2/highgui/highgui.hpp"
 #include "simpleFaceModel.h"
+#include "workerPool.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,14 +71,6 @@
 #define BAIL_IF_ERR(err)  do { if ((err) != 0)  { goto bail; } } while(0)
 #define BAIL(err, code)   do {     err = code;    goto bail;   } while(0)
 
-#ifndef __BYTE_ORDER__                  /* How bytes are packed into a 32 bit word */
-  #define __ORDER_LITTLE_ENDIAN__ 3210  /* First byte in the least significant position */
-  #define __ORDER_BIG_ENDIAN__    0123  /* First byte in the most  significant position */
-#if defined(__amd64__) || defined(__amd64) || defined(__x86_64__) || defined(__x86_64) || defined(_M_AMD64) || _MSC_VER
-  #define __BYTE_ORDER__ __ORDER_LITTLE_ENDIAN__
-  #endif /* _MSC_VER */
-#endif /* __BYTE_ORDER__ */
-
 
 /********************************************************************************
  * glfwErrorCallback
@@ -133,88 +136,153 @@ static void CloseGLContext(GLFWwindow *window) {
 }
 
 
+#ifdef OPENGL_HEADLESS
+
 /********************************************************************************
- * ComputeDualTopologyFromAdjacencies
+ * HeadlessGLContext
+ * An OpenGL context that has no window, and renders into a framebuffer object.
  ********************************************************************************/
 
-static NvCV_Status ComputeDualTopologyFromAdjacencies(const SimpleFaceModelAdapter *fma, GLMesh *mesh) {
-  union IVF {
-    unsigned i;
-    struct VF {
-      #if      __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-        unsigned short face, vertex;                  // Vertex in most significant position
-      #else // __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
-        unsigned short vertex, face;                  // Vertex in most significant position
-      #endif // __BYTE_ORDER__
-    } vf;
-    bool operator<( const IVF& other) { return i <  other.i; }
-    bool operator==(const IVF& other) { return i == other.i; }
-  };
-  std::vector<IVF> topo;
-
-  topo.reserve(mesh->numVertices() * 6 * 2);          // Assume valence-6, duplicated
-  const unsigned short *adjVertices = const_cast<SimpleFaceModelAdapter*>(fma)->getAdjacentVertices(0),
-                       *adjFaces    = const_cast<SimpleFaceModelAdapter*>(fma)->getAdjacentFaces(0);
-  unsigned n = fma->getAdjacentVerticesSize();
-  if (n != fma->getAdjacentFacesSize()) return NVCV_ERR_MISMATCH;
-  for (unsigned ej = 0; ej < n; ej += 2) {            // 2 adjacencies per edge
-    for (unsigned vx = 0; vx < 2; ++vx) {             // for every vertex on the edge
-      for (unsigned fc = 0; fc < 2; ++fc) {           // and every face on the edge
-        IVF vf;
-        vf.vf.vertex = adjVertices[ej + vx];
-        vf.vf.face = adjFaces[ej + fc];
-        if (vf.vf.vertex && vf.vf.face) {             // if a real vertex and a real face
-          --vf.vf.vertex;                             // convert from 1-based index ...
-          --vf.vf.face;                               // ... to 0-based index
-          topo.push_back(vf);
-        }
+struct HeadlessGLContext {
+  EGLDisplay  dpy;
+  EGLContext  ctx;
+  GLuint      fbo;
+  GLuint      rbo[2];   // Color and depth
+  HeadlessGLContext() : dpy(EGL_NO_DISPLAY), ctx(EGL_NO_CONTEXT), fbo(0), rbo{ 0, 0 } {}
+};
+
+
+/********************************************************************************
+ * InitializeHeadlessDisplay, ReleaseHeadlessDisplay
+ * An EGL display is shared by the whole process, and eglTerminate() invalidates every context on it,
+ * so it is reference-counted by the headless contexts, and terminated only when the last one is closed.
+ ********************************************************************************/
+
+static std::mutex                     headlessDisplayMutex;
+static std::map<EGLDisplay, unsigned> headlessDisplayRefs;
+
+static bool InitializeHeadlessDisplay(EGLDisplay dpy) {
+  std::lock_guard<std::mutex> lock(headlessDisplayMutex);
+  if (EGL_NO_DISPLAY == dpy || !eglInitialize(dpy, nullptr, nullptr))  // Does nothing if already initialized
+    return false;
+  ++headlessDisplayRefs[dpy];
+  return true;
+}
+
+static void ReleaseHeadlessDisplay(EGLDisplay dpy) {
+  std::lock_guard<std::mutex> lock(headlessDisplayMutex);
+  auto it = headlessDisplayRefs.find(dpy);
+  if (headlessDisplayRefs.end() == it || --it->second)
+    return;
+  headlessDisplayRefs.erase(it);
+  eglTerminate(dpy);
+}
+
+
+/********************************************************************************
+ * GetHeadlessDisplay
+ * Try, in order, the EGL devices (GPUs, or Mesa's software device), Mesa's surfaceless platform,
+ * and finally the default display, which needs a display server on most drivers.
+ ********************************************************************************/
+
+static EGLDisplay GetHeadlessDisplay() {
+  const char *exts = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS); // Client extensions; NULL if unsupported
+  PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+      (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+  EGLDisplay dpy;
+
+  if (exts && getPlatformDisplay) {
+    PFNEGLQUERYDEVICESEXTPROC queryDevices = (PFNEGLQUERYDEVICESEXTPROC)eglGetProcAddress("eglQueryDevicesEXT");
+    EGLDeviceEXT devices[8];
+    EGLint numDevices = 0;
+    if (strstr(exts, "EGL_EXT_platform_device") && queryDevices && queryDevices(8, devices, &numDevices)) {
+      for (EGLint i = 0; i < numDevices; ++i) {
+        dpy = getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, devices[i], nullptr);
+        if (InitializeHeadlessDisplay(dpy))
+          return dpy;
       }
     }
+    if (strstr(exts, "EGL_MESA_platform_surfaceless")) {
+      dpy = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+      if (InitializeHeadlessDisplay(dpy))
+        return dpy;
+    }
   }
-  std::sort(topo.begin(), topo.end());
-  topo.erase(std::unique(topo.begin(), topo.end()), topo.end());
-  mesh->resizeDualIndices(unsigned(topo.size()));
-  unsigned short *dual     = mesh->getDualIndices(),
-                 *numFaces = mesh->getVertexFaceCounts();
-  memset(numFaces, 0, mesh->numVertices() * sizeof(*numFaces));
-  for (unsigned i = 0; i < topo.size(); ++i) {
-    numFaces[topo[i].vf.vertex]++;
-    dual[i] = topo[i].vf.face;
-  }
-  return NVCV_SUCCESS;
+  dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  if (InitializeHeadlessDisplay(dpy))
+    return dpy;
+  return EGL_NO_DISPLAY;
 }
 
 
 /********************************************************************************
- * MakeMesh
+ * CloseHeadlessGLContext
  ********************************************************************************/
 
-NvCV_Status MakeMesh(const SimpleFaceModelAdapter *fma, GLMesh *mesh) {
-  mesh->clear();
-  mesh->addVertices(fma->getShapeMeanSize() / 3, const_cast<SimpleFaceModelAdapter*>(fma)->getShapeMean(0));
-  mesh->addFaces(fma->getTriangleListSize() / 3, 3, const_cast<SimpleFaceModelAdapter*>(fma)->getTriangleList(0), 0, 0);
-  NvCV_Status err = ComputeDualTopologyFromAdjacencies(fma, mesh); // This make vertex normal computation lightning fast
-  if (NVCV_SUCCESS != err) return err;
-  mesh->computeVertexNormals();
-  if (fma->fm.partitions.size()) {
-    std::vector<GLMesh::Partition> parts(fma->fm.partitions.size());
-    for (unsigned i = unsigned(parts.size()); i--;) {
-      const SimpleFaceModel::Partition& fr = fma->fm.partitions[i];
-      GLMesh::Partition& to = parts[fr.partitionIndex];
-      //to.partitionIndex = fr.partitionIndex;  // to doesn't have a partitionIndex
-      to.faceIndex = fr.faceIndex;
-      to.numFaces = fr.numFaces;
-      to.vertexIndex = fr.vertexIndex;
-      to.numVertexIndices = fr.numVertexIndices;
-      to.name = fr.name;
-      to.materialName = fr.materialName;
-      to.smooth = fr.smoothingGroup;
+static void CloseHeadlessGLContext(HeadlessGLContext *hc) {
+  if (EGL_NO_CONTEXT != hc->ctx) {
+    if (hc->fbo && eglMakeCurrent(hc->dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, hc->ctx)) {  // Not another's objects
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      glDeleteFramebuffers(1, &hc->fbo);
+      glDeleteRenderbuffers(2, hc->rbo);
     }
-    mesh->partitionMesh(unsigned(parts.size()), parts.data());
+    eglMakeCurrent(hc->dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(hc->dpy, hc->ctx);
+  }
+  if (EGL_NO_DISPLAY != hc->dpy)
+    ReleaseHeadlessDisplay(hc->dpy);  // Other renderers may still be using the display
+  *hc = HeadlessGLContext();
+}
+
+
+/********************************************************************************
+ * MakeHeadlessGLContext
+ * Make a surfaceless desktop OpenGL context, with a framebuffer object of the given size bound for rendering,
+ * so that neither a window nor a display server is needed. This works with GPU drivers as well as Mesa's llvmpipe.
+ ********************************************************************************/
+
+static NvCV_Status MakeHeadlessGLContext(int width, int height, HeadlessGLContext *hc) {
+  static const EGLint configAttribs[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+  NvCV_Status nvErr = NVCV_SUCCESS;
+  EGLConfig   config;
+  EGLint      numConfigs = 0;
+
+  if (EGL_NO_DISPLAY == (hc->dpy = GetHeadlessDisplay())) {
+    fprintf(stderr, "Unable to get an EGL display\n");
+    BAIL(nvErr, NVCV_ERR_INITIALIZATION);
+  }
+  if (!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(hc->dpy, configAttribs, &config, 1, &numConfigs) ||
+      numConfigs < 1) {
+    fprintf(stderr, "No EGL configuration supports OpenGL\n");
+    BAIL(nvErr, NVCV_ERR_INITIALIZATION);
+  }
+  if (EGL_NO_CONTEXT == (hc->ctx = eglCreateContext(hc->dpy, config, EGL_NO_CONTEXT, nullptr)) ||
+      !eglMakeCurrent(hc->dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, hc->ctx)) {
+    fprintf(stderr, "Unable to make a surfaceless EGL context: 0x%04X\n", eglGetError());
+    BAIL(nvErr, NVCV_ERR_INITIALIZATION);
+  }
+  glGenFramebuffers(1, &hc->fbo);
+  glGenRenderbuffers(2, hc->rbo);
+  glBindRenderbuffer(GL_RENDERBUFFER, hc->rbo[0]);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+  glBindRenderbuffer(GL_RENDERBUFFER, hc->rbo[1]);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+  glBindFramebuffer(GL_FRAMEBUFFER, hc->fbo);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, hc->rbo[0]);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,  GL_RENDERBUFFER, hc->rbo[1]);
+  if (GL_FRAMEBUFFER_COMPLETE != glCheckFramebufferStatus(GL_FRAMEBUFFER)) {
+    fprintf(stderr, "The offscreen framebuffer is incomplete\n");
+    BAIL(nvErr, NVCV_ERR_OPENGL);
   }
   return NVCV_SUCCESS;
+
+bail:
+  CloseHeadlessGLContext(hc);
+  return nvErr;
 }
 
+#endif // OPENGL_HEADLESS
+
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -227,14 +295,32 @@ NvCV_Status MakeMesh(const SimpleFaceModelAdapter *fma, GLMesh *mesh) {
 class RenderContext {
 public:
 
+  static const unsigned kNumReadbacks = 2;   ///< The number of frames that can be in flight asynchronously.
+
+  /// A pixel buffer object into which a frame is read back asynchronously.
+  struct Readback {
+    GLuint  pbo;
+    GLsync  fence;  ///< Signaled when the frame has been copied into the buffer.
+  };
+
   RenderContext() {
     m_win = nullptr;
+    m_canReadAsync = false;
+    m_numPending = 0;
+    m_nextPending = 0;
+    memset(m_readback, 0, sizeof(m_readback));
   }
 
   ~RenderContext() {
+    if (makeCurrent()) {  // Delete our own objects, rather than those of whatever other context is current
+      shutdownReadback();
+      m_lam.shutdown();
+      m_txr.shutdown();
+    }
     if (m_win) CloseGLContext(m_win);
-    m_lam.shutdown();
-    m_txr.shutdown();
+    #ifdef OPENGL_HEADLESS
+      CloseHeadlessGLContext(&m_headless);
+    #endif // OPENGL_HEADLESS
   }
 
   NvCV_Status init() {
@@ -242,9 +328,97 @@ public:
       return NVCV_ERR_OPENGL;
     if (0 != m_txr.startup())
       return NVCV_ERR_OPENGL;
+    initReadback();
+    return NVCV_SUCCESS;
+  }
+
+  /// Allocate the pixel buffers for asynchronous readback, if the context supports them.
+  /// Fences and mapping buffer ranges need OpenGL 3.0, which we may not get from a 2.0 context request.
+  void initReadback() {
+    const char *version = (const char*)glGetString(GL_VERSION);   // "4.5 (Compatibility Profile) Mesa", "OpenGL ES 3.2"
+    int major = 0;
+    shutdownReadback();
+    if (version) {
+      for (; *version && !(*version >= '0' && *version <= '9'); ++version) {}
+      major = atoi(version);
+    }
+    #ifdef _MSC_VER
+      if (!glFenceSync || !glMapBufferRange) major = 0;     // GLAD could not load them
+    #endif // _MSC_VER
+    if (major < 3)
+      return;
+    for (Readback& rb : m_readback) {
+      glGenBuffers(1, &rb.pbo);
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.pbo);
+      glBufferData(GL_PIXEL_PACK_BUFFER, GLsizeiptr(m_width) * m_height * 4, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_canReadAsync = (GL_NO_ERROR == glGetError());
+    if (!m_canReadAsync)
+      shutdownReadback();
+  }
+
+  /// Free the pixel buffers, abandoning any frames in flight.
+  void shutdownReadback() {
+    for (Readback& rb : m_readback) {
+      if (rb.fence) glDeleteSync(rb.fence);
+      if (rb.pbo)   glDeleteBuffers(1, &rb.pbo);
+      rb.fence = 0;
+      rb.pbo = 0;
+    }
+    m_canReadAsync = false;
+    m_numPending = 0;
+    m_nextPending = 0;
+  }
+
+  /// Start reading back the frame that was just rendered, into the next free pixel buffer.
+  /// @return NVCV_SUCCESS if successful, or NVCV_ERR_BUFFER if every buffer holds a frame that has not been collected.
+  NvCV_Status queueReadback() {
+    if (m_numPending >= kNumReadbacks)
+      return NVCV_ERR_BUFFER;
+    Readback& rb = m_readback[(m_nextPending + m_numPending) % kNumReadbacks];
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.pbo);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);  // Into the buffer, without waiting
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    rb.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();                                                                  // Get the GPU started on it
+    if (GL_NO_ERROR != glGetError() || !rb.fence) {
+      if (rb.fence) glDeleteSync(rb.fence);                                     // Leave the slot free
+      rb.fence = 0;
+      return NVCV_ERR_OPENGL;
+    }
+    ++m_numPending;
     return NVCV_SUCCESS;
   }
 
+  /// Copy the oldest frame that was read back into an image, waiting until it has arrived.
+  /// @return NVCV_SUCCESS if successful, or NVCV_ERR_NOTHINGRENDERED if no frames are in flight.
+  NvCV_Status collectReadback(NvCVImage *result) {
+    if (!m_numPending)
+      return NVCV_ERR_NOTHINGRENDERED;
+    Readback& rb = m_readback[m_nextPending];
+    m_nextPending = (m_nextPending + 1) % kNumReadbacks;
+    --m_numPending;
+
+    GLenum wait;
+    while (GL_TIMEOUT_EXPIRED == (wait = glClientWaitSync(rb.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000))) {}
+    glDeleteSync(rb.fence);
+    rb.fence = 0;
+    if (GL_WAIT_FAILED == wait)
+      return NVCV_ERR_OPENGL;
+    size_t rowBytes = size_t(m_width) * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.pbo);
+    const unsigned char *src = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                                                      GLsizeiptr(rowBytes * m_height), GL_MAP_READ_BIT);
+    if (src) {
+      for (unsigned y = 0; y < result->height; ++y, src += rowBytes)
+        memcpy((unsigned char*)result->pixels + y * result->pitch, src, result->width * 4);
+      glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return src ? NVCV_SUCCESS : NVCV_ERR_OPENGL;
+  }
+
   void setClearColor(float r, float g, float b, float a = 1.f) { glClearColor(r, g, b, a); }
 
   void setClearColor(unsigned char r, unsigned char g, unsigned char b) {
@@ -254,23 +428,52 @@ public:
   NvCV_Status makeWindowContext(int wd, int ht, const char *title, bool visible = true) {
     NvCV_Status err = MakeGLContext(wd, ht, title, &m_win, visible);
     if (NVCV_SUCCESS == err) {
-      m_width = wd;
-      m_height = ht;
       glfwMakeContextCurrent(m_win);
-      glViewport(0, 0, wd, ht);
-      glEnable(GL_DEPTH_TEST);
-      glClearColor(0.f, 0.f, 0.f, 1.f);
-      if (/*FLAG_orientation*/0) {
-        glEnable(GL_CULL_FACE);
-        glCullFace((/*FLAG_orientation*/0 > 0) ? GL_BACK : GL_FRONT);
-      }
-      else {
-        glDisable(GL_CULL_FACE);
-      }
+      initViewport(wd, ht);
     }
     return err;
   }
 
+  /// Make this context current on the calling thread, as each renderer has its own.
+  /// @return true if successful; false if there is no context yet, or it could not be made current.
+  bool makeCurrent() {
+    #ifdef OPENGL_HEADLESS
+      if (EGL_NO_CONTEXT != m_headless.ctx)
+        return EGL_TRUE == eglMakeCurrent(m_headless.dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, m_headless.ctx);
+    #endif // OPENGL_HEADLESS
+    if (!m_win)
+      return false;
+    glfwMakeContextCurrent(m_win);
+    return true;
+  }
+
+  NvCV_Status makeHeadlessContext(int wd, int ht) {
+    #ifdef OPENGL_HEADLESS
+      NvCV_Status err = MakeHeadlessGLContext(wd, ht, &m_headless);
+      if (NVCV_SUCCESS == err)
+        initViewport(wd, ht);
+      return err;
+    #else // !OPENGL_HEADLESS
+      (void)wd; (void)ht;
+      return NVCV_ERR_UNIMPLEMENTED;
+    #endif // !OPENGL_HEADLESS
+  }
+
+  void initViewport(int wd, int ht) {
+    m_width = wd;
+    m_height = ht;
+    glViewport(0, 0, wd, ht);
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.f, 0.f, 0.f, 1.f);
+    if (/*FLAG_orientation*/0) {
+      glEnable(GL_CULL_FACE);
+      glCullFace((/*FLAG_orientation*/0 > 0) ? GL_BACK : GL_FRONT);
+    }
+    else {
+      glDisable(GL_CULL_FACE);
+    }
+  }
+
   void computeInverseViewMatrix() {
     #if 0
       Vinv = glm::inverse(V);
@@ -336,43 +539,17 @@ public:
 
   void setViewOfBound(const GLMesh::BoundingBox& bbox, const glm::vec3& lookAt, const glm::vec3& up, float vfov,
                       float fracFill, float yDir = 1.f, float yOff = 0.f, float z_near = 0.0f, float z_far = 0.0f) {
-    glm::vec3 boxSize     = bbox.max() - bbox.min();
-    glm::vec3 boxCenter   = bbox.center();
-    float     borderFrac  = ((1.f - fracFill) / fracFill),
-              dx          = boxSize.x * (1.f + borderFrac),       // border on left and right
-              dy          = boxSize.y * (1.f + borderFrac) * (1.f - fabsf(yOff)),
-              r           = ((dx > dy) ? dx : dy),                // radius of bounding sphere
-              aspectGeom  = dx / dy,
-              aspectWind  = (float)m_width / (float)m_height,
-              signZ       = -yDir,
-              dist;
-
-    if (vfov > 0) {  // Perspective
-      dist = r * .5f / tanf(vfov * .5f);
-      if (z_near == 0.0f && z_far == 0.0f) {
-        // If z_near and z_far are both 0, use default values
-        z_near = dist - r;
-        z_far = dist + r;
-      }
-      m_P = glm::perspective(vfov, aspectWind, z_near, z_far);
-    } else {  // Orthographic
-      if (aspectGeom > aspectWind) dy *= aspectGeom / aspectWind;
-      else                         dx *= aspectWind / aspectGeom;
-      dist = r * 2.f;
-      dx *= .5f;
-      dy *= .5f;
-      m_P = glm::orthoLH_NO(-dx, +dx, -dy, +dy, (dist - r) * signZ, (dist + r) * signZ);
-    }
-    boxCenter.y += boxSize.y * yOff;
-    m_V = glm::lookAt(boxCenter - glm::normalize(lookAt) * dist, boxCenter, up);
+    FrameBoundingBox(bbox, lookAt, up, vfov, fracFill, (float)m_width / (float)m_height, yDir, yOff, z_near, z_far,
+                     &m_V, &m_P);
     computeInverseViewMatrix();
   }
 
-  NvCV_Status renderPolyMesh(const GLMesh& mesh, const glm::mat4x4& M, const char *materialOverride = nullptr) {
+  NvCV_Status renderPolyMesh(GLMesh& mesh, const glm::mat4x4& M, const char *materialOverride = nullptr) {
     NvCV_Status         nvErr = NVCV_SUCCESS;
+    GLuint              vtxBuf = 0, indexBuf = 0;
+    unsigned            nrmOff = 0;
+    bool                useBuffers;
     glm::mat4x4         VP = m_P * m_V;
-    const GLSpectrum3f  defaultDiffuse = { 0.77f, 0.63f, 0.55f },
-                        defaultAmbient = defaultDiffuse * 0.3f;
 
     #ifdef DEBUG_RENDERING
       unsigned why = mesh.notRenderable(0);
@@ -389,6 +566,9 @@ public:
     // Set lights for all shaders
       m_lam.setLights(&m_lightLoc[0].x, m_lightColor[0].data());    // TODO: set this elsewhere
 
+    // Stream the vertices to the GPU once for all partitions, falling back to client memory if that fails
+    useBuffers = mesh.numNormals() && NVCV_SUCCESS == mesh.bindBuffers(&vtxBuf, &nrmOff, &indexBuf);
+
     for (unsigned ix = 0, numPartitions = mesh.numPartitions(); ix < numPartitions; ++ix) {
       GLMesh::Partition pt;
       nvErr = mesh.getPartition(ix, pt);
@@ -402,21 +582,30 @@ public:
           ambColor = &mtl->ambientColor;
         }
         else {
-          difColor = &defaultDiffuse;
-          ambColor = &defaultAmbient;
+          difColor = &kFaceMeshDiffuse;
+          ambColor = &kFaceMeshAmbient;
         }
-        m_lam.drawTriMesh(mesh.numVertices(), &mesh.getVertices()->x, &mesh.getNormals()->x,
-            pt.numVertexIndices, mesh.getVertexIndices() + pt.vertexIndex, &M[0][0], &VP[0][0],
-            ambColor->data(), difColor->data());
+        if (useBuffers)
+          m_lam.drawTriMesh(vtxBuf, 0, nrmOff, pt.numVertexIndices, indexBuf, sizeof(unsigned short), pt.vertexIndex,
+              &M[0][0], &VP[0][0], ambColor->data(), difColor->data());
+        else
+          m_lam.drawTriMesh(mesh.numVertices(), &mesh.getVertices()->x, &mesh.getNormals()->x,
+              pt.numVertexIndices, static_cast<const GLMesh&>(mesh).getVertexIndices() + pt.vertexIndex,
+              &M[0][0], &VP[0][0], ambColor->data(), difColor->data());
       }
     }
 
   bail:
+    if (useBuffers)
+      mesh.unbindBuffers();
     return nvErr;
   }
 
   unsigned            m_width, m_height;                    ///< The dimensions of the viewport.
   GLFWwindow          *m_win;                               ///< The window context.
+  #ifdef OPENGL_HEADLESS
+    HeadlessGLContext m_headless;                           ///< The offscreen context, used instead of the window.
+  #endif // OPENGL_HEADLESS
   GLMaterialLibrary   m_mtlLib;                             ///< The material library.
   glm::mat4x4         m_V, m_Vinv;                          ///< The viewing matrix and its inverse.
   glm::mat4x4         m_P;                                  ///< The projection matrix.
@@ -424,6 +613,10 @@ public:
   GLSpectrum3f        m_lightColor[LAMBERTIAN_NUM_LIGHTS];  ///< The light colors.
   LambertianRenderer  m_lam;                                ///< The Lambertian renderer.
   TextureRenderer     m_txr;                                ///< The texture renderer.
+  Readback            m_readback[kNumReadbacks];            ///< The ring of asynchronous readback buffers.
+  bool                m_canReadAsync;                       ///< Whether the readback buffers are available.
+  unsigned            m_numPending;                         ///< The number of frames in flight.
+  unsigned            m_nextPending;                        ///< The index of the oldest frame in flight.
 };
 
 
@@ -439,14 +632,32 @@ public:
   ~OpenGLMeshRenderer();
 
   static NvCV_Status initDispatch(MeshRenderer::Dispatch *dispatch);
+  static NvCV_Status initHeadlessDispatch(MeshRenderer::Dispatch *dispatch);
   static NvCV_Status unload();
+  static NvCV_Status setSparseEpsilon(float epsilon);
+  static NvCV_Status setIncrementalDeformation(float threshold, unsigned rebuildInterval);
+  static NvCV_Status setNumThreads(unsigned numThreads);
+  NvCV_Status        getDeformStats(OpenGLMeshRendererDeformStats *stats) const;
 
 private:
-  OpenGLMeshRenderer();
+  OpenGLMeshRenderer(bool headless = false);
+  bool                    _headless;        // Render offscreen, without a window
   SimpleFaceModelAdapter  _sfma;
   RenderContext           _ctx;
   GLMesh                  _mesh;
   glm::vec3               _ctrRot;
+  DeformState             _deform;
+  WorkerPool              _pool;
+
+  struct InstanceState {                      // The deformation of one head of a batch, carried between batches
+    std::vector<glm::vec3>  vertices, normals;
+    DeformState             deform;
+  };
+  std::vector<InstanceState> _instances;
+  static float            _sparseEpsilon;   // Blend shape deltas no larger than this are treated as zero
+  static float            _deformThreshold; // Coefficient changes no larger than this are not applied
+  static unsigned         _rebuildInterval; // The maximum number of incremental frames between full rebuilds
+  static unsigned         _numThreads;      // The number of worker threads for deformation and normals
 
   // C-style object-oriented member functions that are usually loaded from DLL, although in this implementation
   // the OpenGLMeshRenderer is compiled directly into the ExpressionApp, and the MeshRendererBroker is
@@ -455,64 +666,69 @@ private:
   static void        destroy(MeshRenderer *han);
   static NvCV_Status name(const char **str);
   static NvCV_Status info(const char **str);
+  static NvCV_Status createHeadless(MeshRenderer **han);
+  static NvCV_Status nameHeadless(const char **str);
+  static NvCV_Status infoHeadless(const char **str);
   static NvCV_Status read(MeshRenderer *han, const char *modelFile);
   static NvCV_Status init(MeshRenderer *han, unsigned width, unsigned height, const char *windowName, bool visible);
   static NvCV_Status setCamera(MeshRenderer *han, const float locPt[3], const float lookVec[3], const float upVec[3],
                                float vfov, float near_z = 0.0f, float far_z = 0.0f);
   static NvCV_Status render(MeshRenderer *han,
                       const float exprs[53], const float qrot[4], const float tran[3], NvCVImage *result);
+  static NvCV_Status submit(MeshRenderer *han, const float exprs[53], const float qrot[4], const float tran[3]);
+  static NvCV_Status collect(MeshRenderer *han, NvCVImage *result);
+  static NvCV_Status renderBatch(MeshRenderer *han, unsigned numInstances, const MeshRenderer::Instance *instances,
+                                 NvCVImage *result);
   NvCV_Status        setFOV(float radians, float near_z = 0.0, float far_z = 0.0f);
+  NvCV_Status        draw(const float exprs[53], const float qrot[4], const float trans[3]);
+  void               swapInstance(unsigned i);
+  void               sizePool();
 };
 
 NvCV_Status OpenGLMeshRenderer_InitDispatch(MeshRenderer::Dispatch *dispatch) {
   return OpenGLMeshRenderer::initDispatch(dispatch);
 }
 
+NvCV_Status OpenGLHeadlessMeshRenderer_InitDispatch(MeshRenderer::Dispatch *dispatch) {
+  return OpenGLMeshRenderer::initHeadlessDispatch(dispatch);
+}
+
 NvCV_Status OpenGLMeshRenderer_Unload() {
   return OpenGLMeshRenderer::unload();
 }
 
+NvCV_Status OpenGLMeshRenderer_SetSparseEpsilon(float epsilon) {
+  return OpenGLMeshRenderer::setSparseEpsilon(epsilon);
+}
+
+NvCV_Status OpenGLMeshRenderer_SetIncrementalDeformation(float threshold, unsigned rebuildInterval) {
+  return OpenGLMeshRenderer::setIncrementalDeformation(threshold, rebuildInterval);
+}
 
-/********************************************************************************
- * DeformModel
- ********************************************************************************/
+NvCV_Status OpenGLMeshRenderer_GetDeformStats(const MeshRenderer *han, OpenGLMeshRendererDeformStats *stats) {
+  if (!han || !stats) return NVCV_ERR_PARAMETER;
+  return static_cast<const OpenGLMeshRenderer*>(han)->getDeformStats(stats);
+}
 
-static NvCV_Status DeformModel(const SimpleFaceModel& model, const float *identCoeffs, const float *exprCoeffs, GLMesh *mesh) {
-  unsigned    size = unsigned(model.shapeMean.size()) * 3,    // the number of floats in the mesh vector
-              numCoeffs, i;
-  float       *const dst0 = &mesh->getVertices()->x,          // begin
-              *const dst1 = dst0 + size;                      // end
-  float const *src;
-  float       *dst, c;
-
-  memcpy(dst0, model.shapeMean.data(), size * sizeof(*dst0)); // Initialize
-  if (identCoeffs) {
-    for (i = 0, numCoeffs = unsigned(model.shapeEigenValues.size()), src = model.shapeModes.data()->vec; i < numCoeffs; ++i, ++identCoeffs) {
-      if ((c = *identCoeffs) != 0.f) {
-        for (dst = dst0; dst != dst1;)
-          *dst++ += *src++ * c;
-      }
-      else {
-        src += size;
-      }
-    }
-  }
-  for (i = 0, numCoeffs = unsigned(model.blendShapes.size()); i < numCoeffs; ++i, ++exprCoeffs) {
-    if ((c = *exprCoeffs) != 0.f) {
-      for (dst = dst0, src = model.blendShapes[i].shape.data()->vec; dst != dst1;)
-        *dst++ += *src++ * c;
-    }
-  }
-  mesh->computeVertexNormals();
-  return NVCV_SUCCESS;
+NvCV_Status OpenGLMeshRenderer_SetNumThreads(unsigned numThreads) {
+  return OpenGLMeshRenderer::setNumThreads(numThreads);
 }
 
+float     OpenGLMeshRenderer::_sparseEpsilon    = kFaceMeshSparseEpsilon;
+float     OpenGLMeshRenderer::_deformThreshold  = kFaceMeshDeformThreshold;
+unsigned  OpenGLMeshRenderer::_rebuildInterval  = kFaceMeshRebuildInterval;
+unsigned  OpenGLMeshRenderer::_numThreads       = ~0u;  // Default
+
 
-OpenGLMeshRenderer::OpenGLMeshRenderer() {
-  /*NvCV_Status err =*/ (void)initDispatch(&this->m_dispatch);
+OpenGLMeshRenderer::OpenGLMeshRenderer(bool headless) : _headless(headless) {
+  /*NvCV_Status err =*/ (void)(headless ? initHeadlessDispatch(&this->m_dispatch) : initDispatch(&this->m_dispatch));
 }
 
 OpenGLMeshRenderer::~OpenGLMeshRenderer() {
+  if (_ctx.makeCurrent())
+    _mesh.releaseBuffers();   // From this renderer's context, before it is closed, rather than another's
+  else
+    _mesh.abandonBuffers();   // Rather than let ~GLMesh() delete them from whatever context is current
 }
 
 NvCV_Status OpenGLMeshRenderer::name(const char **str) {
@@ -532,6 +748,23 @@ NvCV_Status OpenGLMeshRenderer::create(MeshRenderer **han) {
   return NVCV_SUCCESS;
 }
 
+NvCV_Status OpenGLMeshRenderer::nameHeadless(const char **str) {
+  static const char name[] = "OpenGLHeadless";
+  *str = name;
+  return NVCV_SUCCESS;
+}
+
+NvCV_Status OpenGLMeshRenderer::infoHeadless(const char **str) {
+  static const char info[] = "Offscreen OpenGL renderer using local illumination, needing no display server";
+  *str = info;
+  return NVCV_SUCCESS;
+}
+
+NvCV_Status OpenGLMeshRenderer::createHeadless(MeshRenderer **han) {
+  *han = new OpenGLMeshRenderer(true);
+  return NVCV_SUCCESS;
+}
+
 void OpenGLMeshRenderer::destroy(MeshRenderer* han) {
   OpenGLMeshRenderer *ren = static_cast<OpenGLMeshRenderer*>(han);
   delete ren;
@@ -542,7 +775,9 @@ NvCV_Status OpenGLMeshRenderer::read(MeshRenderer *han, const char *modelFile) {
   size_t z = strlen(modelFile);
   if (z < 5) return NVCV_ERR_FILE;
   if (!strcasecmp(".nvf", modelFile + z - 4)) {
-    FaceIOErr ioErr = ReadNVFFaceModel(modelFile, &ren->_sfma);  // TODO clear _sfma first
+    FaceIOErr ioErr = ReadNVFFaceModelMapped(modelFile, &ren->_sfma,
+                                             kIOSectionModel | kIOSectionBlendShapes |  // The identity shape modes
+                                             kIOSectionTopology | kIOSectionPartitions); // are never used here
     if (kIOErrNone != ioErr) {
       printf("Error: \"%s\": %s\n", modelFile, FaceIOErrorStringFromCode(ioErr));
       return NVCV_ERR_READ;
@@ -550,6 +785,9 @@ NvCV_Status OpenGLMeshRenderer::read(MeshRenderer *han, const char *modelFile) {
     NvCV_Status nvErr;
     nvErr = MakeMesh(&ren->_sfma, &ren->_mesh);
     if (NVCV_SUCCESS != nvErr) return nvErr;
+    ren->_sfma.fm.sparsify(_sparseEpsilon);
+    ren->_deform.invalidate();
+    ren->_instances.clear();
 
     std::string mtlFile;
     mtlFile.assign(modelFile, 0, strlen(modelFile) - 3);
@@ -575,28 +813,29 @@ NvCV_Status OpenGLMeshRenderer::read(MeshRenderer *han, const char *modelFile) {
 NvCV_Status OpenGLMeshRenderer::init(MeshRenderer *han,
     unsigned width, unsigned height, const char *windowName, bool visible) {
   OpenGLMeshRenderer        *ren = static_cast<OpenGLMeshRenderer*>(han);
-  static const GLSpectrum3f lightColor[LAMBERTIAN_NUM_LIGHTS] = { { 1.f, 1.f, 1.f }, { .8f, .1f, .1f } };
-  static const glm::vec4    lightLoc[LAMBERTIAN_NUM_LIGHTS] = { { 0, 0, +1000, 0}, { 100, -200, -500, 0 } };
   NvCV_Status               nvErr;
+  static_assert(LAMBERTIAN_NUM_LIGHTS == kFaceMeshNumLights, "The renderers must agree on the lights");
 
-  nvErr = ren->_ctx.makeWindowContext(width, height, windowName, visible);
+  if (ren->_headless) {
+    nvErr = ren->_ctx.makeHeadlessContext(width, height);
+    if (NVCV_SUCCESS != nvErr) return nvErr;
+  }
+  else {
+    nvErr = ren->_ctx.makeWindowContext(width, height, windowName, visible);
+  }
   nvErr = ren->_ctx.init();
-  ren->_ctx.setClearColor(0.2f, 0.2f, 0.2f, 1.f);
-  ren->_ctx.setLights(lightLoc, lightColor);
+  ren->_ctx.setClearColor(kFaceMeshClearColor.r, kFaceMeshClearColor.g, kFaceMeshClearColor.b, 1.f);
+  ren->_ctx.setLights(kFaceMeshLightLoc, kFaceMeshLightColor);
   ren->setFOV(0.f); // Default orthographic
   return NVCV_SUCCESS;
 }
 
 NvCV_Status OpenGLMeshRenderer::setFOV(float fov, float near_z, float far_z) {
-  if (0 == _mesh.numVertices())
-    return NVCV_ERR_MODEL;
-  GLMesh::BoundingBox bbox;
-  _mesh.getBoundingBox(&bbox);
-  _ctrRot = bbox.center();
-  _ctrRot.y = bbox.min().y;  // Assume that assets are designed with Y-up.
-  float vShift = (_mesh.numVertices() > 10000) ? 0.15f : 0.0f;  // Heuristic to determine whether there is a neck
-  _ctx.setViewOfBound(bbox, glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, +1.f, 0.f), fov, .7f, +1, vShift, near_z, far_z);
-  return NVCV_SUCCESS;
+  NvCV_Status nvErr = FrameFaceMesh(_mesh, fov, (float)_ctx.m_width / (float)_ctx.m_height, near_z, far_z, &_ctrRot,
+                                    &_ctx.m_V, &_ctx.m_P);
+  if (NVCV_SUCCESS == nvErr)
+    _ctx.computeInverseViewMatrix();
+  return nvErr;
 }
 
 NvCV_Status OpenGLMeshRenderer::setCamera(MeshRenderer *han, const float locPt[3], const float lookVec[3],
@@ -613,31 +852,33 @@ NvCV_Status OpenGLMeshRenderer::setCamera(MeshRenderer *han, const float locPt[3
   return static_cast<OpenGLMeshRenderer *>(han)->setFOV(vfov, near_z, far_z);
 }
 
+void OpenGLMeshRenderer::sizePool() {
+  unsigned numThreads = FaceMeshNumThreads(_numThreads);
+  if (_pool.numThreads() != numThreads)
+    _pool.setNumThreads(numThreads);
+}
+
+NvCV_Status OpenGLMeshRenderer::draw(const float exprs[53], const float qrot[4], const float* trans) {
+  NvCV_Status nvErr;
+  glm::mat4x4 M = FaceModelMatrix(qrot, trans, _ctrRot);
+
+  sizePool();
+  nvErr = DeformModel(_sfma.fm, nullptr, exprs, &_mesh, &_deform, _deformThreshold, _rebuildInterval, &_pool);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  nvErr = _ctx.renderPolyMesh(_mesh, M, NULL);
+  return nvErr;
+}
+
 NvCV_Status OpenGLMeshRenderer::render(MeshRenderer *han,
     const float exprs[53], const float qrot[4], const float* trans, NvCVImage *result) {
   OpenGLMeshRenderer *ren = static_cast<OpenGLMeshRenderer*>(han);
-  NvCV_Status nvErr;
-  glm::mat4x4 M;
-  glm::quat q;  // Convert quaternion from {x,y,z,w} --> GLM's {w,x,y,z}
 
   if (NVCV_RGBA != result->pixelFormat)
     return NVCV_ERR_PIXELFORMAT;
+  if (!ren->_ctx.makeCurrent())
+    return NVCV_ERR_OPENGL;
 
-  if (qrot) { q.x = qrot[0]; q.y = qrot[1]; q.z = qrot[2]; q.w = qrot[3]; }
-  else      { q.x = 0.0f;    q.y = 0.0f;    q.z = 0.0f;    q.w = 1.0f;    }
-
-  M = glm::mat4_cast(q);
-  if (trans) {
-    M = glm::translate(glm::mat4x4(1.f), *((const glm::vec3 *)(trans))) * M;
-  } else {
-    M = glm::translate(glm::mat4x4(1.f), -ren->_ctrRot);
-    M = glm::mat4_cast(q) * M;
-    M = glm::translate(M, ren->_ctrRot);
-  }
-
-  nvErr = DeformModel(ren->_sfma.fm, nullptr, exprs, &ren->_mesh);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  nvErr = ren->_ctx.renderPolyMesh(ren->_mesh, M, NULL);
+  (void)ren->draw(exprs, qrot, trans);
   glReadPixels(0, 0, result->width, result->height, GL_RGBA, GL_UNSIGNED_BYTE, result->pixels);
   GLenum glErr = glGetError();
   if (glErr)
@@ -647,6 +888,101 @@ NvCV_Status OpenGLMeshRenderer::render(MeshRenderer *han,
 
 }
 
+NvCV_Status OpenGLMeshRenderer::submit(MeshRenderer *han,
+    const float exprs[53], const float qrot[4], const float* trans) {
+  OpenGLMeshRenderer *ren = static_cast<OpenGLMeshRenderer*>(han);
+
+  if (!ren->_ctx.m_canReadAsync)
+    return NVCV_ERR_UNIMPLEMENTED;
+  if (ren->_ctx.m_numPending >= RenderContext::kNumReadbacks)
+    return NVCV_ERR_BUFFER;           // Check before drawing, so that the deformation state is not advanced
+  if (!ren->_ctx.makeCurrent())
+    return NVCV_ERR_OPENGL;
+  (void)ren->draw(exprs, qrot, trans);
+  return ren->_ctx.queueReadback();   // Frame N is read back by DMA while frame N+1 is being drawn
+}
+
+NvCV_Status OpenGLMeshRenderer::collect(MeshRenderer *han, NvCVImage *result) {
+  OpenGLMeshRenderer *ren = static_cast<OpenGLMeshRenderer*>(han);
+
+  if (!ren->_ctx.m_canReadAsync)
+    return NVCV_ERR_UNIMPLEMENTED;
+  if (NVCV_RGBA != result->pixelFormat || NVCV_U8 != result->componentType)
+    return NVCV_ERR_PIXELFORMAT;
+  if (result->width > ren->_ctx.m_width || result->height > ren->_ctx.m_height)
+    return NVCV_ERR_MISMATCH;
+  if (!ren->_ctx.makeCurrent())
+    return NVCV_ERR_OPENGL;
+  return ren->_ctx.collectReadback(result);
+}
+
+// The mesh is shared by all instances, so each one's vertices and normals are swapped into it around its
+// deformation and rendering, which can then be incremental, as with a single head, without copying the arrays.
+void OpenGLMeshRenderer::swapInstance(unsigned i) {
+  InstanceState& inst = _instances[i];
+
+  if (inst.vertices.size() != _mesh.numVertices() || inst.normals.size() != _mesh.numVertices()) {
+    inst.vertices.resize(_mesh.numVertices());  // A new instance, or a new model: deform it from scratch
+    inst.normals.resize(_mesh.numVertices());
+    inst.deform.invalidate();
+  }
+  _mesh.swapVertices(inst.vertices);
+  _mesh.swapNormals(inst.normals);
+}
+
+NvCV_Status OpenGLMeshRenderer::renderBatch(MeshRenderer *han, unsigned numInstances,
+    const MeshRenderer::Instance *instances, NvCVImage *result) {
+  OpenGLMeshRenderer  *ren = static_cast<OpenGLMeshRenderer*>(han);
+  RenderContext&      ctx  = ren->_ctx;
+  NvCV_Status         nvErr = NVCV_SUCCESS;
+  const glm::mat4x4   P = ctx.m_P;
+  float               aspect = (float)ctx.m_width / (float)ctx.m_height;
+  unsigned            i;
+
+  if (NVCV_RGBA != result->pixelFormat)
+    return NVCV_ERR_PIXELFORMAT;
+  if (result->width > ctx.m_width || result->height > ctx.m_height)
+    return NVCV_ERR_MISMATCH;
+  for (i = 0; i < numInstances; ++i) {
+    const MeshRenderer::Instance& in = instances[i];
+    if (!in.exprs || !in.qrot || !in.width || !in.height ||
+        in.x > result->width || in.width > result->width - in.x ||
+        in.y > result->height || in.height > result->height - in.y)
+      return NVCV_ERR_PARAMETER;
+  }
+  if (!ctx.makeCurrent())
+    return NVCV_ERR_OPENGL;
+  if (ren->_instances.size() < numInstances)
+    ren->_instances.resize(numInstances);
+
+  ren->sizePool();
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  glEnable(GL_SCISSOR_TEST);
+  for (i = 0; i < numInstances; ++i) {
+    const MeshRenderer::Instance& in = instances[i];
+    GLint y = GLint(result->height - in.y - in.height);  // GL counts rows from the bottom
+    glViewport(in.x, y, in.width, in.height);
+    glScissor(in.x, y, in.width, in.height);
+    glClear(GL_DEPTH_BUFFER_BIT);                         // Overlapping tiles are drawn over each other
+    ctx.m_P = FitProjectionToAspect(P, aspect, (float)in.width / (float)in.height);
+    ren->swapInstance(i);                                 // Swap its vertices and normals into the mesh,
+    (void)DeformModel(ren->_sfma.fm, nullptr, in.exprs, &ren->_mesh, &ren->_instances[i].deform,
+                      _deformThreshold, _rebuildInterval, &ren->_pool);
+    nvErr = ctx.renderPolyMesh(ren->_mesh, FaceModelMatrix(in.qrot, in.trans, ren->_ctrRot), NULL);
+    ren->swapInstance(i);                                 // and back out again
+    if (NVCV_SUCCESS != nvErr)
+      break;
+  }
+  glDisable(GL_SCISSOR_TEST);
+  glViewport(0, 0, ctx.m_width, ctx.m_height);
+  ctx.m_P = P;
+  if (NVCV_SUCCESS != nvErr)
+    return nvErr;
+
+  glReadPixels(0, 0, result->width, result->height, GL_RGBA, GL_UNSIGNED_BYTE, result->pixels);
+  return glGetError() ? NVCV_ERR_OPENGL : NVCV_SUCCESS;
+}
+
 NvCV_Status OpenGLMeshRenderer::initDispatch(MeshRenderer::Dispatch *dispatch) {
   dispatch->name      = &OpenGLMeshRenderer::name;
   dispatch->info      = &OpenGLMeshRenderer::info;
@@ -656,9 +992,47 @@ NvCV_Status OpenGLMeshRenderer::initDispatch(MeshRenderer::Dispatch *dispatch) {
   dispatch->init      = &OpenGLMeshRenderer::init;
   dispatch->setCamera = &OpenGLMeshRenderer::setCamera;
   dispatch->render    = &OpenGLMeshRenderer::render;
+  dispatch->submit    = &OpenGLMeshRenderer::submit;
+  dispatch->collect   = &OpenGLMeshRenderer::collect;
+  dispatch->renderBatch = &OpenGLMeshRenderer::renderBatch;
   return NVCV_SUCCESS;
 }
 
+NvCV_Status OpenGLMeshRenderer::initHeadlessDispatch(MeshRenderer::Dispatch *dispatch) {
+  #ifdef OPENGL_HEADLESS
+    (void)initDispatch(dispatch);
+    dispatch->name      = &OpenGLMeshRenderer::nameHeadless;
+    dispatch->info      = &OpenGLMeshRenderer::infoHeadless;
+    dispatch->create    = &OpenGLMeshRenderer::createHeadless;
+    return NVCV_SUCCESS;
+  #else // !OPENGL_HEADLESS
+    (void)dispatch;
+    return NVCV_ERR_UNIMPLEMENTED;
+  #endif // !OPENGL_HEADLESS
+}
+
 NvCV_Status OpenGLMeshRenderer::unload() {
   return NVCV_SUCCESS;
 }
+
+NvCV_Status OpenGLMeshRenderer::setSparseEpsilon(float epsilon) {
+  _sparseEpsilon = epsilon;
+  return NVCV_SUCCESS;
+}
+
+NvCV_Status OpenGLMeshRenderer::setIncrementalDeformation(float threshold, unsigned rebuildInterval) {
+  if (threshold < 0.f) return NVCV_ERR_PARAMETER;
+  _deformThreshold = threshold;
+  _rebuildInterval = rebuildInterval;
+  return NVCV_SUCCESS;
+}
+
+NvCV_Status OpenGLMeshRenderer::setNumThreads(unsigned numThreads) {
+  _numThreads = numThreads;
+  return NVCV_SUCCESS;
+}
+
+NvCV_Status OpenGLMeshRenderer::getDeformStats(OpenGLMeshRendererDeformStats *stats) const {
+  *stats = _deform.stats;
+  return NVCV_SUCCESS;
+}
@@ -32,10 +32,57 @@
 /// @return NVCV_SUCCESS if successful.
 NvCV_Status OpenGLMeshRenderer_InitDispatch(MeshRenderer::Dispatch *dispatch);
 
+/// Initialize the dispatch table of the headless OpenGL renderer, "OpenGLHeadless".
+/// It renders with the same shaders into an offscreen framebuffer, using an EGL context that needs neither a window
+/// nor a display server, so that it can run in containers, or on machines without a GPU via Mesa's llvmpipe.
+/// The windowName and visible arguments of init() are ignored.
+/// @param[out] dispatch the dispatch table.
+/// @return NVCV_SUCCESS if successful, or NVCV_ERR_UNIMPLEMENTED unless built with EGL, i.e. OPENGL_HEADLESS defined.
+NvCV_Status OpenGLHeadlessMeshRenderer_InitDispatch(MeshRenderer::Dispatch *dispatch);
+
 /// Unload the OpenGL Mesh Renderer from memory.
 /// @note Any previously initialized dispatch tables will be invalid.
 /// @return NVCV_SUCCESS if successful.
 NvCV_Status OpenGLMeshRenderer_Unload();
 
+/// Set the threshold below which blend shape deltas are treated as zero, in models read subsequently.
+/// Blend shapes that move few vertices are then applied sparsely, touching only the vertices that move.
+/// @param[in] epsilon  the largest magnitude of a delta component that is considered to be zero.
+///                     Negative values disable sparse blend shapes. The default is 1.0e-5.
+/// @return NVCV_SUCCESS if successful.
+NvCV_Status OpenGLMeshRenderer_SetSparseEpsilon(float epsilon);
+
+/// Control the incremental deformation of the mesh.
+/// Rather than rebuilding the mesh from the mean shape on every frame, only the expression coefficients that have
+/// changed since the previous frame are applied, as deltas. Changes no larger than the threshold are deferred until
+/// they accumulate beyond it, so the rendered expression lags by at most the threshold in each coefficient.
+/// @param[in] threshold        the largest change in a coefficient that is not applied. The default is 1.0e-4.
+/// @param[in] rebuildInterval  the mesh is rebuilt from the mean shape after this many incremental frames, to bound
+///                             floating-point drift. 0 rebuilds on every frame. The default is 300.
+/// @return NVCV_SUCCESS if successful, or NVCV_ERR_PARAMETER if the threshold is negative.
+NvCV_Status OpenGLMeshRenderer_SetIncrementalDeformation(float threshold, unsigned rebuildInterval);
+
+/// Set the number of worker threads used to deform the mesh and compute its normals, in addition to the rendering
+/// thread. Vertices and faces are split into cache-sized chunks, so small meshes are still processed on one thread.
+/// @param[in] numThreads the number of worker threads; 0 does all of the work on the rendering thread.
+///                       The default is one less than the number of hardware threads, up to 15.
+/// @return NVCV_SUCCESS if successful.
+NvCV_Status OpenGLMeshRenderer_SetNumThreads(unsigned numThreads);
+
+/// Performance counters for the deformation of the mesh.
+struct OpenGLMeshRendererDeformStats {
+  unsigned long long  frames;             ///< The number of frames rendered.
+  unsigned long long  fullRebuilds;       ///< The number of frames on which the mesh was rebuilt from the mean shape.
+  unsigned long long  skippedFrames;      ///< The number of frames on which no coefficient changed enough to apply.
+  unsigned long long  shapesTouched;      ///< The number of shapes applied, summed over all frames.
+  unsigned            lastShapesTouched;  ///< The number of shapes applied on the most recent frame.
+};
+
+/// Get the deformation performance counters of an OpenGL renderer.
+/// @param[in]  han   the renderer, which must have been created by the OpenGL dispatch table.
+/// @param[out] stats the place to store the counters.
+/// @return NVCV_SUCCESS if successful, or NVCV_ERR_PARAMETER if either pointer is NULL.
+NvCV_Status OpenGLMeshRenderer_GetDeformStats(const MeshRenderer *han, OpenGLMeshRendererDeformStats *stats);
+
 
 #endif // __OPENGL_MESH_RENDERER__
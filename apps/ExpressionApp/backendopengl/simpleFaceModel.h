@@ -24,8 +24,10 @@
 #ifndef __SIMPLE_FACE_MODEL__
 #define __SIMPLE_FACE_MODEL__
 
+#include <math.h>
 #include <stdint.h>
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -40,11 +42,33 @@
 struct SimpleFaceModel {
   std::vector<NvAR_Point3f>    shapeMean;
   std::vector<NvAR_Vector3f>   shapeModes;  /* shapeMean.size() * numModes */
+  const NvAR_Vector3f*         shapeModesView = nullptr;  /* If not NULL, the shape modes reside in a mapped file, ... */
+  size_t                       shapeModesViewSize = 0;    /* ... and shapeModes is empty */
+  std::vector<int16_t>         qShapeModes;               /* If quantized, the shape modes are either here, ... */
+  const int16_t*               qShapeModesView = nullptr; /* ... or in a mapped file, of size shapeModesViewSize */
+  std::vector<FaceIOQuantization> shapeModesQuant;        /* One per mode, if quantized */
   std::vector<float>           shapeEigenValues;
   std::vector<NvAR_Vector3u16> triangles;
   struct BlendShape {
     std::string                name;
     std::vector<NvAR_Vector3f> shape;
+    const NvAR_Vector3f*       view = nullptr;            /* If not NULL, the shape resides in a mapped file, ... */
+    size_t                     viewSize = 0;              /* ... and shape is empty */
+    std::vector<int16_t>       qshape;                    /* If quantized, the shape is either here, ... */
+    const int16_t*             qview = nullptr;           /* ... or in a mapped file, of size viewSize */
+    FaceIOQuantization         quant = { 0.f, 0.f };
+    bool                       sparse = false;            /* If true, only these vertices are moved by the shape, ... */
+    std::vector<uint32_t>      sparseIndices;             /* ... in ascending order, ... */
+    std::vector<NvAR_Vector3f> sparseDeltas;              /* ... by these deltas (see sparsify()) */
+    const NvAR_Vector3f* data() const { return view ? view : shape.data(); }
+    const int16_t*       qdata() const { return qview ? qview : qshape.data(); }
+    bool                 quantized() const { return qview || !qshape.empty(); }
+    size_t               size() const { return (view || qview) ? viewSize : !qshape.empty() ? qshape.size() / 3
+                                                                                            : shape.size(); }
+    void                 unview()     { view = nullptr; qview = nullptr; viewSize = 0; }
+    void                 clear()      { shape.clear(); qshape.clear(); unview(); unsparsify(); }
+    void                 unsparsify() { sparse = false; sparseIndices.clear(); sparseDeltas.clear(); }
+    void                 dequantize(float* v) const { FaceIODequantize(qdata(), size() * 3, quant, v); }
   };
   std::vector<BlendShape>      blendShapes;
   struct Partition {
@@ -87,7 +111,104 @@ struct SimpleFaceModel {
   std::vector<unsigned short>  nvlmRightContour;
   std::vector<unsigned short>  nvlmLeftContour;
 
+  const NvAR_Vector3f* getShapeModes() const { return shapeModesView ? shapeModesView : shapeModes.data(); }
+  const int16_t*       getQuantizedShapeModes() const { return qShapeModesView ? qShapeModesView : qShapeModes.data(); }
+  bool                 shapeModesQuantized() const { return qShapeModesView || !qShapeModes.empty(); }
+  size_t               shapeModesSize() const {
+                         return (shapeModesView || qShapeModesView) ? shapeModesViewSize
+                              : !qShapeModes.empty() ? qShapeModes.size() / 3 : shapeModes.size(); }
+  void                 clearShapeModes() {
+                         shapeModes.clear(); qShapeModes.clear(); shapeModesQuant.clear();
+                         shapeModesView = nullptr; qShapeModesView = nullptr; shapeModesViewSize = 0; }
+
+  /* Expand the quantized shape modes into v, which has room for shapeModesSize() vectors. */
+  void dequantizeShapeModes(float* v) const {
+    size_t numModes = shapeModesQuant.size(),
+           modeSize = numModes ? shapeModesSize() * 3 / numModes : 0;
+    for (size_t i = 0; i < numModes; ++i)
+      FaceIODequantize(getQuantizedShapeModes() + i * modeSize, modeSize, shapeModesQuant[i], v + i * modeSize);
+  }
+
+  /* Remove everything but the constant ibug contours. */
+  void clear() {
+    shapeMean.clear();
+    clearShapeModes();
+    shapeEigenValues.clear();
+    triangles.clear();
+    blendShapes.clear();
+    partitions.clear();
+    ibugLandmarkMappings.clear();
+    modelRightContour.clear();
+    modelLeftContour.clear();
+    adjacentFaces.clear();
+    adjacentVertices.clear();
+    nvlmLandmarks.clear();
+    nvlmRightContour.clear();
+    nvlmLeftContour.clear();
+  }
+
+  /* Copy any data referenced in a mapped file into the model, so that the mapping may be released. */
+  void unview() {
+    if (shapeModesView) {
+      shapeModes.assign(shapeModesView, shapeModesView + shapeModesViewSize);
+      shapeModesView = nullptr;
+      shapeModesViewSize = 0;
+    }
+    if (qShapeModesView) {
+      qShapeModes.assign(qShapeModesView, qShapeModesView + shapeModesViewSize * 3);
+      qShapeModesView = nullptr;
+      shapeModesViewSize = 0;
+    }
+    for (BlendShape& bs : blendShapes) {
+      if (bs.view)
+        bs.shape.assign(bs.view, bs.view + bs.viewSize);
+      if (bs.qview)
+        bs.qshape.assign(bs.qview, bs.qview + bs.viewSize * 3);
+      bs.unview();
+    }
+  }
+
+  /* Build the sparse form of each blend shape that moves no more than maxDensity of the vertices, where a vertex is
+   * considered to be moved if any component of its delta exceeds epsilon in magnitude. The dense form is retained.
+   * A negative epsilon removes the sparse forms. */
+  void sparsify(float epsilon, float maxDensity = 0.25f) {
+    std::vector<float> dense;
+    for (BlendShape& bs : blendShapes) {
+      bs.unsparsify();
+      if (epsilon < 0.f)
+        continue;
+      size_t n = bs.size(), count = 0, i;
+      const float* v = bs.data()->vec;
+      if (bs.quantized()) {
+        dense.resize(n * 3);
+        bs.dequantize(dense.data());
+        v = dense.data();
+      }
+      for (i = 0; i < n; ++i)
+        count += (fabsf(v[3 * i + 0]) > epsilon || fabsf(v[3 * i + 1]) > epsilon || fabsf(v[3 * i + 2]) > epsilon);
+      if (count > maxDensity * n)
+        continue;                               // Dense is faster
+      bs.sparseIndices.reserve(count);
+      bs.sparseDeltas.reserve(count);
+      for (i = 0; i < n; ++i) {
+        const float* d = v + 3 * i;
+        if (fabsf(d[0]) > epsilon || fabsf(d[1]) > epsilon || fabsf(d[2]) > epsilon) {
+          bs.sparseIndices.push_back(uint32_t(i));
+          bs.sparseDeltas.push_back({{ d[0], d[1], d[2] }});
+        }
+      }
+      bs.sparse = true;
+    }
+  }
+
   void appendMode(const NvAR_Point3f* pts) {
+    if (shapeModesQuantized()) {                // New modes are appended as floats
+      std::vector<NvAR_Vector3f> modes(shapeModesSize());
+      dequantizeShapeModes(modes.data()->vec);
+      clearShapeModes();
+      shapeModes.swap(modes);
+    }
+    unview();
     size_t  n = shapeMean.size(),
       off = shapeModes.size();
     shapeModes.resize(off + n);
@@ -101,6 +222,7 @@ struct SimpleFaceModel {
   void setBlendShape(unsigned i, const std::string& name, const NvAR_Point3f* pts) {
     size_t n = shapeMean.size();
     blendShapes[i].name = name;
+    blendShapes[i].clear();
     blendShapes[i].shape.resize(n);
     float       *to = blendShapes[i].shape.data()->vec; // Delta mode vector
     const float *fr = &pts->x;                          // Blendshape points
@@ -118,15 +240,33 @@ struct SimpleFaceModel {
 class SimpleFaceModelAdapter : public FaceIOAdapter {
 public:
   SimpleFaceModel fm;
+  std::vector<std::unique_ptr<FaceIOMapping>> mappings;  /* Back any views in fm; copy-on-write, so views are writable */
+  std::vector<float> dequantizedModes;                /* Float copies of quantized shapes, filled on first access, */
+  std::vector<std::vector<float>> dequantizedShapes;  /* and valid until that shape is replaced or cleared */
+
+  void      clear() override { fm.clear(); mappings.clear(); dequantizedModes.clear(); dequantizedShapes.clear(); }
+  float*    dequantizedShapeModes() {
+              if (dequantizedModes.empty()) { dequantizedModes.resize(fm.shapeModesSize() * 3);
+                                              fm.dequantizeShapeModes(dequantizedModes.data()); }
+              return dequantizedModes.data(); }
+  float*    dequantizedBlendShape(uint32_t i) {
+              if (dequantizedShapes.size() < fm.blendShapes.size()) dequantizedShapes.resize(fm.blendShapes.size());
+              std::vector<float>& d = dequantizedShapes[i];
+              if (d.empty()) { d.resize(fm.blendShapes[i].size() * 3); fm.blendShapes[i].dequantize(d.data()); }
+              return d.data(); }
+  void      invalidateBlendShape(uint32_t i) { if (i < dequantizedShapes.size()) dequantizedShapes[i].clear(); }
 
   uint32_t  getShapeMeanSize() const override { return unsigned(fm.shapeMean.size()) * 3; }
-  uint32_t  getShapeModesSize() const override { return unsigned(fm.shapeModes.size()) * 3; }
-  uint32_t  getShapeNumModes() const override { return unsigned(fm.shapeModes.size() / fm.shapeMean.size()); }
+  uint32_t  getShapeModesSize() const override { return unsigned(fm.shapeModesSize()) * 3; }
+  uint32_t  getShapeNumModes() const override { return unsigned(fm.shapeModesSize() / fm.shapeMean.size()); }
   uint32_t  getShapeEigenvaluesSize()const override { return unsigned(fm.shapeEigenValues.size()); }
   float*    getShapeMean(uint32_t size) override { if (size) fm.shapeMean.resize(size / 3);
                 return &fm.shapeMean.data()->x; };
   float*    getShapeModes(uint32_t modeSize, uint32_t numModes) override {
-                if (modeSize) fm.shapeModes.resize(modeSize / 3 * numModes); return fm.shapeModes.data()->vec; }
+                if (modeSize) { fm.clearShapeModes(); fm.shapeModes.resize(modeSize / 3 * numModes);
+                                dequantizedModes.clear(); }
+                if (fm.shapeModesQuantized()) return dequantizedShapeModes();
+                return const_cast<float*>(fm.getShapeModes()->vec); }
   float*    getShapeEigenvalues(uint32_t numModes) override { if (numModes) fm.shapeEigenValues.resize(numModes);
                 return fm.shapeEigenValues.data(); }
 
@@ -147,13 +287,30 @@ public:
   uint32_t  getTextureCoordinatesSize() const override { return 0; }
   float*    getTextureCoordinates(uint32_t /*size*/) override { return nullptr; }
 
-  void      setNumBlendShapes(uint32_t n) override { fm.blendShapes.resize(n); }
+  void      setNumBlendShapes(uint32_t n) override { fm.blendShapes.resize(n);
+                if (dequantizedShapes.size() > n) dequantizedShapes.resize(n); }
   void      setBlendShapeName(uint32_t i, const char* name) override { fm.blendShapes[i].name = name; }
   uint32_t  getNumBlendShapes() const override { return unsigned(fm.blendShapes.size()); }
   const char* getBlendShapeName(uint32_t i) const override { return fm.blendShapes[i].name.c_str(); }
-  uint32_t  getBlendShapeSize(uint32_t i) const override { return unsigned((fm.blendShapes[i].shape.size()) * 3); }
-  float*    getBlendShape(uint32_t i, uint32_t size) override { if (size) fm.blendShapes[i].shape.resize(size / 3);
-                return fm.blendShapes[i].shape.data()->vec; }
+  uint32_t  getBlendShapeSize(uint32_t i) const override { return unsigned((fm.blendShapes[i].size()) * 3); }
+  float*    getBlendShape(uint32_t i, uint32_t size) override {
+                SimpleFaceModel::BlendShape& bs = fm.blendShapes[i];
+                if (size) { bs.clear(); bs.shape.resize(size / 3); invalidateBlendShape(i); }
+                if (bs.quantized()) return dequantizedBlendShape(i);
+                return const_cast<float*>(bs.data()->vec); }
+
+  int16_t*  getQuantizedShapeModes(uint32_t modeSize, uint32_t numModes) override {
+                if (modeSize) { fm.clearShapeModes(); fm.qShapeModes.resize(modeSize * numModes);
+                                fm.shapeModesQuant.resize(numModes); dequantizedModes.clear(); }
+                return fm.shapeModesQuantized() ? const_cast<int16_t*>(fm.getQuantizedShapeModes()) : nullptr; }
+  FaceIOQuantization* getShapeModesQuantization() override {
+                return fm.shapeModesQuantized() ? fm.shapeModesQuant.data() : nullptr; }
+  int16_t*  getQuantizedBlendShape(uint32_t i, uint32_t size) override {
+                SimpleFaceModel::BlendShape& bs = fm.blendShapes[i];
+                if (size) { bs.clear(); bs.qshape.resize(size); invalidateBlendShape(i); }
+                return bs.quantized() ? const_cast<int16_t*>(bs.qdata()) : nullptr; }
+  FaceIOQuantization* getBlendShapeQuantization(uint32_t i) override {
+                return fm.blendShapes[i].quantized() ? &fm.blendShapes[i].quant : nullptr; }
 
   void      setIbugLandmarkMappingsSize(uint32_t n) override { fm.ibugLandmarkMappings.resize(n); }
   uint32_t  getIbugLandmarkMappingsSize() const override { return unsigned(fm.ibugLandmarkMappings.size()); }
@@ -241,6 +398,49 @@ public:
                 if (smoothingGroup) *smoothingGroup = pt.smoothingGroup;
                 return (int16_t)pt.partitionIndex;
               }
+
+  bool      adoptMapping(FaceIOMapping* map) override {
+              mappings.emplace_back(map);         // Earlier mappings may still back sections adopted since clear()
+              return true;
+            }
+  bool      adoptShapeModes(const float* modes, uint32_t modeSize, uint32_t numModes) override {
+              if (!modes || mappings.empty()) return false;
+              fm.clearShapeModes();
+              dequantizedModes.clear();
+              fm.shapeModesView = reinterpret_cast<const NvAR_Vector3f*>(modes);
+              fm.shapeModesViewSize = modeSize / 3 * numModes;
+              return true;
+            }
+  bool      adoptBlendShape(uint32_t i, const float* shape, uint32_t size) override {
+              if (!shape || mappings.empty()) return false;
+              SimpleFaceModel::BlendShape& bs = fm.blendShapes.at(i);
+              bs.clear();
+              invalidateBlendShape(i);
+              bs.view = reinterpret_cast<const NvAR_Vector3f*>(shape);
+              bs.viewSize = size / 3;
+              return true;
+            }
+  bool      adoptQuantizedShapeModes(const int16_t* modes, const FaceIOQuantization* quant, uint32_t modeSize,
+                                     uint32_t numModes) override {
+              if (!modes || mappings.empty()) return false;
+              fm.clearShapeModes();
+              dequantizedModes.clear();
+              fm.qShapeModesView = modes;
+              fm.shapeModesViewSize = modeSize / 3 * numModes;
+              fm.shapeModesQuant.assign(quant, quant + numModes);  // Small, so copied
+              return true;
+            }
+  bool      adoptQuantizedBlendShape(uint32_t i, const int16_t* shape, const FaceIOQuantization* quant,
+                                     uint32_t size) override {
+              if (!shape || mappings.empty()) return false;
+              SimpleFaceModel::BlendShape& bs = fm.blendShapes.at(i);
+              bs.clear();
+              invalidateBlendShape(i);
+              bs.qview = shape;
+              bs.viewSize = size / 3;
+              bs.quant = *quant;
+              return true;
+            }
 };
 
 #endif // __SIMPLE_FACE_MODEL__
@@ -0,0 +1,106 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "workerPool.h"
+
+
+WorkerPool::WorkerPool(unsigned numThreads)
+  : m_generation(0), m_busy(0), m_quit(false), m_proc(nullptr), m_context(nullptr), m_begin(0), m_end(0), m_chunk(1),
+    m_next(0) {
+  setNumThreads(numThreads);
+}
+
+WorkerPool::~WorkerPool() {
+  setNumThreads(0);
+}
+
+unsigned WorkerPool::defaultNumThreads() {
+  unsigned n = std::thread::hardware_concurrency();
+  return n > 1 ? n - 1 : 0;
+}
+
+void WorkerPool::setNumThreads(unsigned numThreads) {
+  if (numThreads == m_threads.size()) return;
+  if (!m_threads.empty()) {       // Join all and start afresh; this is rare
+    { std::lock_guard<std::mutex> lock(m_mutex);
+      m_quit = true;
+    }
+    m_start.notify_all();
+    for (std::thread& th : m_threads)
+      th.join();
+    m_threads.clear();
+    m_quit = false;
+  }
+  m_threads.reserve(numThreads);
+  for (unsigned i = 0; i < numThreads; ++i)
+    m_threads.emplace_back(&WorkerPool::WorkerProc, this, m_generation);  // Wait for the next job
+}
+
+void WorkerPool::WorkerProc(WorkerPool *pool, unsigned generation) {
+  pool->work(generation);
+}
+
+void WorkerPool::runChunks() {
+  size_t b;
+  while ((b = m_begin + m_next.fetch_add(1, std::memory_order_relaxed) * m_chunk) < m_end) {
+    size_t e = m_end - b > m_chunk ? b + m_chunk : m_end;
+    m_proc(m_context, b, e);
+  }
+}
+
+void WorkerPool::work(unsigned generation) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_start.wait(lock, [&] { return m_quit || m_generation != generation; });
+    if (m_quit) break;
+    generation = m_generation;
+    lock.unlock();
+    runChunks();
+    lock.lock();
+    if (0 == --m_busy)
+      m_done.notify_one();
+  }
+}
+
+void WorkerPool::parallelFor(size_t begin, size_t end, size_t chunk, RangeProc proc, void *context) {
+  if (begin >= end) return;
+  if (!chunk) chunk = 1;
+  if (m_threads.empty() || end - begin <= chunk) {  // Not worth waking anyone
+    proc(context, begin, end);
+    return;
+  }
+  { std::lock_guard<std::mutex> lock(m_mutex);
+    m_proc    = proc;
+    m_context = context;
+    m_begin   = begin;
+    m_end     = end;
+    m_chunk   = chunk;
+    m_next.store(0, std::memory_order_relaxed);
+    m_busy    = unsigned(m_threads.size());
+    ++m_generation;
+  }
+  m_start.notify_all();
+  runChunks();
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done.wait(lock, [&] { return 0 == m_busy; });
+}
@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __WORKER_POOL_H
+#define __WORKER_POOL_H
+
+#include <stddef.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/********************************************************************************
+ * WorkerPool
+ * A small pool of persistent threads that split a range of work into chunks.
+ * The calling thread takes chunks too, so a pool with N threads uses N+1 cores.
+ * Only one parallelFor() may be active at a time.
+ ********************************************************************************/
+
+class WorkerPool {
+public:
+  /// The function called for each chunk [begin, end) of a range.
+  typedef void (*RangeProc)(void *context, size_t begin, size_t end);
+
+  /// Construct a pool.
+  /// @param[in]  numThreads  the number of worker threads, in addition to the calling thread.
+  ///                         0 creates none, so that all work is done by the caller.
+  explicit WorkerPool(unsigned numThreads = 0);
+  ~WorkerPool();
+
+  /// Change the number of worker threads, joining or spawning as needed.
+  /// @param[in]  numThreads  the number of worker threads, in addition to the calling thread.
+  void      setNumThreads(unsigned numThreads);
+
+  /// Get the number of worker threads, excluding the calling thread.
+  /// @return the number of worker threads.
+  unsigned  numThreads() const { return unsigned(m_threads.size()); }
+
+  /// Get the default number of worker threads for this machine, i.e. one less than the number of hardware threads.
+  /// @return the default number of worker threads.
+  static unsigned defaultNumThreads();
+
+  /// Call proc() on chunks of [begin, end), in parallel, and return when all chunks are done.
+  /// @param[in]  begin     the start of the range.
+  /// @param[in]  end       one past the end of the range.
+  /// @param[in]  chunk     the size of each chunk; the last one may be smaller. Chunks start at begin + k * chunk.
+  /// @param[in]  proc      the function to call for each chunk.
+  /// @param[in]  context   the context passed to proc().
+  void      parallelFor(size_t begin, size_t end, size_t chunk, RangeProc proc, void *context);
+
+  /// Call fn(begin, end) on chunks of [begin, end), in parallel; fn may be a lambda.
+  template <class Fn>
+  void      parallelFor(size_t begin, size_t end, size_t chunk, const Fn& fn) {
+              parallelFor(begin, end, chunk, &CallRange<Fn>, const_cast<Fn*>(&fn));
+            }
+
+private:
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  template <class Fn>
+  static void CallRange(void *context, size_t begin, size_t end) { (*static_cast<const Fn*>(context))(begin, end); }
+  static void WorkerProc(WorkerPool *pool, unsigned generation);
+  void        work(unsigned generation);
+  void        runChunks();
+
+  std::vector<std::thread>  m_threads;      ///< The worker threads.
+  std::mutex                m_mutex;        ///< Guards the job description and the counters below.
+  std::condition_variable   m_start;        ///< Signals the workers that a job is ready, or that they should quit.
+  std::condition_variable   m_done;         ///< Signals the caller that the last worker has left the job.
+  unsigned                  m_generation;   ///< Incremented for every job, so workers can tell a new one.
+  unsigned                  m_busy;         ///< The number of workers still engaged with the current job.
+  bool                      m_quit;         ///< Tells the workers to exit.
+  RangeProc                 m_proc;         ///< The function of the current job.
+  void                      *m_context;     ///< The context of the current job.
+  size_t                    m_begin, m_end, m_chunk;  ///< The range of the current job.
+  std::atomic<size_t>       m_next;         ///< The index of the next chunk to be taken.
+};
+
+#endif // __WORKER_POOL_H
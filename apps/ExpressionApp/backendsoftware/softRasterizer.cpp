@@ -0,0 +1,572 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "softRasterizer.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "faceMesh.h"
+#include "workerPool.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define SOFTRAST_SSE 1
+  #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+  #define SOFTRAST_NEON 1
+  #include <arm_neon.h>
+#endif
+
+static const unsigned kVerticesPerChunk  = 2048;  // Vertices lit and projected per task
+static const unsigned kTrianglesPerChunk = 1024;  // Triangles set up and binned per task
+static const unsigned kTileSize          = SoftRasterizer::kTileSize;
+static const unsigned kNumLights         = SoftRasterizer::kNumLights;
+
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/////                            4-WIDE VECTORS                            /////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// Four pixels of a row are rasterized at once. Colors are rounded by truncating c * 255 + 0.5 on every path,
+// so that the images are the same on every architecture.
+
+#if defined(SOFTRAST_SSE)
+  typedef __m128 V4;
+  typedef __m128 M4;
+  static inline V4 V4Set1(float a) { return _mm_set1_ps(a); }
+  static inline V4 V4Set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+  static inline V4 V4Add(V4 a, V4 b) { return _mm_add_ps(a, b); }
+  static inline V4 V4Mul(V4 a, V4 b) { return _mm_mul_ps(a, b); }
+  static inline V4 V4Div(V4 a, V4 b) { return _mm_div_ps(a, b); }
+  static inline V4 V4Clamp01(V4 a) { return _mm_min_ps(_mm_max_ps(a, _mm_setzero_ps()), _mm_set1_ps(1.f)); }
+  static inline V4 V4Load(const float *p) { return _mm_load_ps(p); }
+  static inline void V4Store(float *p, V4 a) { _mm_store_ps(p, a); }
+  static inline M4 M4Bool(bool b) { return _mm_castsi128_ps(_mm_set1_epi32(b ? -1 : 0)); }
+  static inline M4 V4Lt(V4 a, V4 b) { return _mm_cmplt_ps(a, b); }
+  static inline M4 V4Gt(V4 a, V4 b) { return _mm_cmpgt_ps(a, b); }
+  static inline M4 V4Eq(V4 a, V4 b) { return _mm_cmpeq_ps(a, b); }
+  static inline M4 M4And(M4 a, M4 b) { return _mm_and_ps(a, b); }
+  static inline M4 M4Or(M4 a, M4 b) { return _mm_or_ps(a, b); }
+  static inline bool M4Any(M4 m) { return 0 != _mm_movemask_ps(m); }
+  static inline V4 V4Select(M4 m, V4 a, V4 b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+  static inline void V4StorePixels(uint32_t *dst, M4 m, V4 r, V4 g, V4 b, uint32_t alpha) {
+    const V4 k = _mm_set1_ps(255.f), h = _mm_set1_ps(.5f);
+    __m128i ir = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(V4Clamp01(r), k), h)),
+            ig = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(V4Clamp01(g), k), h)),
+            ib = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(V4Clamp01(b), k), h)),
+            px = _mm_or_si128(_mm_or_si128(ir, _mm_slli_epi32(ig, 8)),
+                              _mm_or_si128(_mm_slli_epi32(ib, 16), _mm_set1_epi32(int(alpha << 24)))),
+            mi = _mm_castps_si128(m),
+            old = _mm_load_si128((const __m128i*)dst);
+    _mm_store_si128((__m128i*)dst, _mm_or_si128(_mm_and_si128(mi, px), _mm_andnot_si128(mi, old)));
+  }
+#elif defined(SOFTRAST_NEON)
+  typedef float32x4_t V4;
+  typedef uint32x4_t  M4;
+  static inline V4 V4Set1(float a) { return vdupq_n_f32(a); }
+  static inline V4 V4Set(float a, float b, float c, float d) { const float v[4] = { a, b, c, d }; return vld1q_f32(v); }
+  static inline V4 V4Add(V4 a, V4 b) { return vaddq_f32(a, b); }
+  static inline V4 V4Mul(V4 a, V4 b) { return vmulq_f32(a, b); }
+  static inline V4 V4Div(V4 a, V4 b) { return vdivq_f32(a, b); }
+  static inline V4 V4Clamp01(V4 a) { return vminq_f32(vmaxq_f32(a, vdupq_n_f32(0.f)), vdupq_n_f32(1.f)); }
+  static inline V4 V4Load(const float *p) { return vld1q_f32(p); }
+  static inline void V4Store(float *p, V4 a) { vst1q_f32(p, a); }
+  static inline M4 M4Bool(bool b) { return vdupq_n_u32(b ? ~0u : 0u); }
+  static inline M4 V4Lt(V4 a, V4 b) { return vcltq_f32(a, b); }
+  static inline M4 V4Gt(V4 a, V4 b) { return vcgtq_f32(a, b); }
+  static inline M4 V4Eq(V4 a, V4 b) { return vceqq_f32(a, b); }
+  static inline M4 M4And(M4 a, M4 b) { return vandq_u32(a, b); }
+  static inline M4 M4Or(M4 a, M4 b) { return vorrq_u32(a, b); }
+  static inline bool M4Any(M4 m) { return 0 != vmaxvq_u32(m); }
+  static inline V4 V4Select(M4 m, V4 a, V4 b) { return vbslq_f32(m, a, b); }
+  static inline void V4StorePixels(uint32_t *dst, M4 m, V4 r, V4 g, V4 b, uint32_t alpha) {
+    const V4 k = vdupq_n_f32(255.f), h = vdupq_n_f32(.5f);
+    uint32x4_t ir = vcvtq_u32_f32(vaddq_f32(vmulq_f32(V4Clamp01(r), k), h)),
+               ig = vcvtq_u32_f32(vaddq_f32(vmulq_f32(V4Clamp01(g), k), h)),
+               ib = vcvtq_u32_f32(vaddq_f32(vmulq_f32(V4Clamp01(b), k), h)),
+               px = vorrq_u32(vorrq_u32(ir, vshlq_n_u32(ig, 8)), vorrq_u32(vshlq_n_u32(ib, 16), vdupq_n_u32(alpha << 24)));
+    vst1q_u32(dst, vbslq_u32(m, px, vld1q_u32(dst)));
+  }
+#else
+  struct V4 { float v[4]; };
+  struct M4 { bool v[4]; };
+  static inline V4 V4Set1(float a) { V4 r = { { a, a, a, a } }; return r; }
+  static inline V4 V4Set(float a, float b, float c, float d) { V4 r = { { a, b, c, d } }; return r; }
+  static inline V4 V4Add(V4 a, V4 b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+  static inline V4 V4Mul(V4 a, V4 b) { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+  static inline V4 V4Div(V4 a, V4 b) { for (int i = 0; i < 4; ++i) a.v[i] /= b.v[i]; return a; }
+  static inline V4 V4Clamp01(V4 a) { for (int i = 0; i < 4; ++i) a.v[i] = std::min(std::max(a.v[i], 0.f), 1.f); return a; }
+  static inline V4 V4Load(const float *p) { V4 r; memcpy(r.v, p, sizeof(r.v)); return r; }
+  static inline void V4Store(float *p, V4 a) { memcpy(p, a.v, sizeof(a.v)); }
+  static inline M4 M4Bool(bool b) { M4 m = { { b, b, b, b } }; return m; }
+  static inline M4 V4Lt(V4 a, V4 b) { M4 m; for (int i = 0; i < 4; ++i) m.v[i] = a.v[i] <  b.v[i]; return m; }
+  static inline M4 V4Gt(V4 a, V4 b) { M4 m; for (int i = 0; i < 4; ++i) m.v[i] = a.v[i] >  b.v[i]; return m; }
+  static inline M4 V4Eq(V4 a, V4 b) { M4 m; for (int i = 0; i < 4; ++i) m.v[i] = a.v[i] == b.v[i]; return m; }
+  static inline M4 M4And(M4 a, M4 b) { for (int i = 0; i < 4; ++i) a.v[i] = a.v[i] && b.v[i]; return a; }
+  static inline M4 M4Or(M4 a, M4 b) { for (int i = 0; i < 4; ++i) a.v[i] = a.v[i] || b.v[i]; return a; }
+  static inline bool M4Any(M4 m) { return m.v[0] || m.v[1] || m.v[2] || m.v[3]; }
+  static inline V4 V4Select(M4 m, V4 a, V4 b) { for (int i = 0; i < 4; ++i) if (!m.v[i]) a.v[i] = b.v[i]; return a; }
+  static inline void V4StorePixels(uint32_t *dst, M4 m, V4 r, V4 g, V4 b, uint32_t alpha) {
+    r = V4Clamp01(r); g = V4Clamp01(g); b = V4Clamp01(b);
+    for (int i = 0; i < 4; ++i)
+      if (m.v[i])
+        dst[i] = uint32_t(r.v[i] * 255.f + .5f) | (uint32_t(g.v[i] * 255.f + .5f) << 8) |
+                 (uint32_t(b.v[i] * 255.f + .5f) << 16) | (alpha << 24);
+  }
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/////                              PRIMITIVES                              /////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/// A vertex in clip space, with the Lambertian factor of each light.
+struct ClipVertex {
+  glm::vec4 clip;                   ///< The location in clip space.
+  float     diffuse[kNumLights];    ///< max(0, N.L) for each light.
+};
+
+/// A vertex in clip space, with its color, as it passes through the clipper.
+struct ColorVertex {
+  glm::vec4 clip;                   ///< The location in clip space.
+  glm::vec3 color;                  ///< The Gouraud color.
+};
+
+/// A triangle set up for rasterization in window coordinates, where pixel centers are at half-integers.
+/// Every quantity is a plane in x and y, {a, b, c}, evaluated as a * x + (b * y + c), so that an edge shared by two
+/// triangles evaluates to exactly the negated value in each, and no pixel on it is drawn twice or missed.
+/// The row term b * y + c of the edges is computed in double precision, so that the edges are accurate to a small
+/// fraction of a pixel anywhere in the viewport.
+struct SetupTriangle {
+  int       x0, y0, x1, y1;         ///< The bounding box of the covered pixels, [x0, x1) x [y0, y1).
+  unsigned  topLeft;                ///< A bit for each edge that owns the pixels exactly on it.
+  float     edgeA[3], edgeB[3];     ///< The edge functions, which are positive inside ...
+  double    edgeC[3];               ///< ... and their constant terms.
+  float     attr[5][3];             ///< Depth, 1/w, and r/w, g/w, b/w, for perspective-correct colors.
+};
+
+enum { ATTR_Z, ATTR_Q, ATTR_R, ATTR_G, ATTR_B, NUM_ATTRS };
+
+
+/********************************************************************************
+ * PackPixel
+ ********************************************************************************/
+
+static uint32_t PackPixel(const float rgba[4]) {
+  uint32_t px = 0;
+  for (unsigned i = 0; i < 4; ++i)
+    px |= uint32_t(std::min(std::max(rgba[i], 0.f), 1.f) * 255.f + .5f) << (8 * i);
+  return px;
+}
+
+
+/********************************************************************************
+ * SetUpTriangle
+ * Project a triangle, wholly in front of the near plane, to the window, and compute its edges and attribute planes.
+ * @return false if it is degenerate or covers no pixel centers.
+ ********************************************************************************/
+
+static bool SetUpTriangle(const ColorVertex *v0, const ColorVertex *v1, const ColorVertex *v2,
+                          unsigned width, unsigned height, SetupTriangle *tri) {
+  const ColorVertex *v[3] = { v0, v1, v2 };
+  float X[3], Y[3], A[NUM_ATTRS][3];
+
+  for (unsigned i = 0; i < 3; ++i) {
+    float q = 1.f / v[i]->clip.w;
+    X[i] = (v[i]->clip.x * q + 1.f) * .5f * width;
+    Y[i] = (v[i]->clip.y * q + 1.f) * .5f * height;
+    A[ATTR_Z][i] = v[i]->clip.z * q * .5f + .5f;
+    A[ATTR_Q][i] = q;
+    A[ATTR_R][i] = v[i]->color.r * q;
+    A[ATTR_G][i] = v[i]->color.g * q;
+    A[ATTR_B][i] = v[i]->color.b * q;
+  }
+  float area2 = (X[1] - X[0]) * (Y[2] - Y[0]) - (X[2] - X[0]) * (Y[1] - Y[0]);
+  if (!(area2 != 0.f) || !std::isfinite(area2))      // Degenerate, or NaN
+    return false;
+  if (area2 < 0.f) {                                  // Both windings are drawn, as culling is disabled
+    std::swap(X[1], X[2]);
+    std::swap(Y[1], Y[2]);
+    for (unsigned a = 0; a < NUM_ATTRS; ++a)
+      std::swap(A[a][1], A[a][2]);
+    area2 = -area2;
+  }
+
+  // Bound the pixel centers, clamping before conversion so that distant vertices do not overflow.
+  // The box has a margin of a fraction of a pixel, so that the edge functions alone decide the pixels on its sides.
+  float xMin = std::max(std::min(std::min(X[0], X[1]), X[2]), -1.f),
+        xMax = std::min(std::max(std::max(X[0], X[1]), X[2]), width + 1.f),
+        yMin = std::max(std::min(std::min(Y[0], Y[1]), Y[2]), -1.f),
+        yMax = std::min(std::max(std::max(Y[0], Y[1]), Y[2]), height + 1.f);
+  const float margin = 1.f / 64;
+  tri->x0 = std::max(int(ceilf(xMin - .5f - margin)), 0);
+  tri->x1 = std::min(int(floorf(xMax - .5f + margin)) + 1, int(width));
+  tri->y0 = std::max(int(ceilf(yMin - .5f - margin)), 0);
+  tri->y1 = std::min(int(floorf(yMax - .5f + margin)) + 1, int(height));
+  if (tri->x0 >= tri->x1 || tri->y0 >= tri->y1)
+    return false;
+
+  // Edge k is opposite vertex k, from vertex i to vertex j, and is area2 at vertex k
+  tri->topLeft = 0;
+  for (unsigned k = 0; k < 3; ++k) {
+    unsigned i = (k + 1) % 3, j = (k + 2) % 3;
+    float dx = X[j] - X[i], dy = Y[j] - Y[i];
+    tri->edgeA[k] = -dy;
+    tri->edgeB[k] = dx;
+    tri->edgeC[k] = double(X[i]) * Y[j] - double(X[j]) * Y[i];  // Exact products, even if fused
+    if (dy < 0.f || (dy == 0.f && dx < 0.f))          // Left edges go down, top edges go left, counterclockwise
+      tri->topLeft |= 1u << k;
+  }
+
+  // The barycentric coordinates are the edges divided by area2
+  const float edge[3][3] = { { tri->edgeA[0], tri->edgeB[0], float(tri->edgeC[0]) },
+                             { tri->edgeA[1], tri->edgeB[1], float(tri->edgeC[1]) },
+                             { tri->edgeA[2], tri->edgeB[2], float(tri->edgeC[2]) } };
+  float inv = 1.f / area2;
+  for (unsigned a = 0; a < NUM_ATTRS; ++a)
+    for (unsigned c = 0; c < 3; ++c)
+      tri->attr[a][c] = (edge[0][c] * A[a][0] + edge[1][c] * A[a][1] + edge[2][c] * A[a][2]) * inv;
+  return true;
+}
+
+
+/********************************************************************************
+ * ClipToNearPlane
+ * Clip a polygon in clip space to z >= -w.
+ * @return the number of output vertices: 0, or 3 or 4 for a triangle.
+ ********************************************************************************/
+
+static unsigned ClipToNearPlane(const ColorVertex in[3], ColorVertex out[4]) {
+  unsigned n = 0;
+  for (unsigned i = 0; i < 3; ++i) {
+    const ColorVertex &a = in[i], &b = in[(i + 1) % 3];
+    float da = a.clip.z + a.clip.w, db = b.clip.z + b.clip.w;
+    if (da >= 0.f)
+      out[n++] = a;
+    if ((da >= 0.f) != (db >= 0.f)) {
+      float t = da / (da - db);
+      out[n].clip  = a.clip  + (b.clip  - a.clip)  * t;
+      out[n].color = a.color + (b.color - a.color) * t;
+      ++n;
+    }
+  }
+  return n;
+}
+
+
+/********************************************************************************
+ * RasterizeTriangle
+ * Rasterize the part of a triangle in one tile, four pixels at a time.
+ ********************************************************************************/
+
+static void RasterizeTriangle(const SetupTriangle& tri, int tileX, int tileY, float *depth, uint32_t *color) {
+  int x0 = (std::max(tri.x0, tileX) - tileX) & ~3,  // Blocks of 4 are aligned in the tile
+      x1 =  std::min(tri.x1, tileX + int(kTileSize)) - tileX,
+      y0 =  std::max(tri.y0, tileY) - tileY,
+      y1 =  std::min(tri.y1, tileY + int(kTileSize)) - tileY;
+  if (x0 >= x1 || y0 >= y1)
+    return;
+
+  const V4 lane = V4Set(.5f, 1.5f, 2.5f, 3.5f);
+  V4  ea[3], ez = V4Set1(tri.attr[ATTR_Z][0]), eq = V4Set1(tri.attr[ATTR_Q][0]),
+      er = V4Set1(tri.attr[ATTR_R][0]), eg = V4Set1(tri.attr[ATTR_G][0]), eb = V4Set1(tri.attr[ATTR_B][0]);
+  M4  tl[3];
+  for (unsigned k = 0; k < 3; ++k) {
+    ea[k] = V4Set1(tri.edgeA[k]);
+    tl[k] = M4Bool(0 != (tri.topLeft & (1u << k)));
+  }
+  const V4 zero = V4Set1(0.f);
+
+  for (int y = y0; y < y1; ++y) {
+    float py = float(tileY + y) + .5f;
+    V4 row[3], rz, rq, rr, rg, rb;
+    for (unsigned k = 0; k < 3; ++k)
+      row[k] = V4Set1(float(double(tri.edgeB[k]) * py + tri.edgeC[k]));
+    rz = V4Set1(tri.attr[ATTR_Z][1] * py + tri.attr[ATTR_Z][2]);
+    rq = V4Set1(tri.attr[ATTR_Q][1] * py + tri.attr[ATTR_Q][2]);
+    rr = V4Set1(tri.attr[ATTR_R][1] * py + tri.attr[ATTR_R][2]);
+    rg = V4Set1(tri.attr[ATTR_G][1] * py + tri.attr[ATTR_G][2]);
+    rb = V4Set1(tri.attr[ATTR_B][1] * py + tri.attr[ATTR_B][2]);
+    float    *zRow = depth + y * kTileSize;
+    uint32_t *cRow = color + y * kTileSize;
+
+    for (int x = x0; x < x1; x += 4) {
+      V4 px = V4Add(V4Set1(float(tileX + x)), lane);
+      M4 inside = M4Bool(true);
+      for (unsigned k = 0; k < 3; ++k) {
+        V4 e = V4Add(V4Mul(ea[k], px), row[k]);
+        inside = M4And(inside, M4Or(V4Gt(e, zero), M4And(V4Eq(e, zero), tl[k])));
+      }
+      if (!M4Any(inside))
+        continue;
+      V4 z = V4Add(V4Mul(ez, px), rz), zOld = V4Load(zRow + x);
+      M4 pass = M4And(inside, V4Lt(z, zOld));             // GL_LESS
+      if (!M4Any(pass))
+        continue;
+      V4Store(zRow + x, V4Select(pass, z, zOld));
+      V4 w = V4Div(V4Set1(1.f), V4Add(V4Mul(eq, px), rq));
+      V4StorePixels(cRow + x, pass, V4Mul(V4Add(V4Mul(er, px), rr), w), V4Mul(V4Add(V4Mul(eg, px), rg), w),
+                    V4Mul(V4Add(V4Mul(eb, px), rb), w), 0xFF);
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/////                            SOFT RASTERIZER                           /////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class SoftRasterizer::Impl {
+public:
+  Impl() : width(0), height(0), tilesX(0), tilesY(0), clearPixel(0xFF000000) {}
+
+  /// Call fn(begin, end) on chunks of [0, n) that start at multiples of chunk, in parallel if there is a pool.
+  template <class Fn>
+  static void forChunks(WorkerPool *pool, size_t n, size_t chunk, const Fn& fn) {
+    if (pool) {
+      pool->parallelFor(0, n, chunk, fn);
+    }
+    else {
+      for (size_t b = 0; b < n; b += chunk)
+        fn(b, std::min(b + chunk, n));
+    }
+  }
+
+  void transformVertices(size_t begin, size_t end, const glm::vec3 *xyz, const glm::vec3 *nrm,
+                         const glm::mat4x4& M, const glm::mat4x4& VP);
+  void setUpTriangles(size_t begin, size_t end, const DrawCall *draws);
+  void rasterizeTile(unsigned tile, NvCVImage *result) const;
+
+  unsigned                                  width, height;  ///< The size of the viewport.
+  unsigned                                  tilesX, tilesY; ///< The number of tiles across and down the viewport.
+  uint32_t                                  clearPixel;     ///< The clear color, packed as RGBA.
+  glm::vec4                                 lightLoc[kNumLights];
+  GLSpectrum3f                              lightColor[kNumLights];
+  std::vector<ClipVertex>                   vertices;       ///< The vertices of this frame, lit and projected.
+  std::vector<unsigned>                     drawStarts;     ///< The index of the first triangle of each draw call.
+  std::vector<std::vector<SetupTriangle> >  triangles;      ///< The triangles, set up by each chunk.
+  std::vector<std::vector<unsigned> >       bins;           ///< The triangles of each chunk in each tile.
+};
+
+
+/********************************************************************************
+ * transformVertices
+ ********************************************************************************/
+
+void SoftRasterizer::Impl::transformVertices(size_t begin, size_t end, const glm::vec3 *xyz, const glm::vec3 *nrm,
+                                             const glm::mat4x4& M, const glm::mat4x4& VP) {
+  glm::mat3x3 N(M);
+  for (size_t i = begin; i < end; ++i) {
+    glm::vec4 loc = M * glm::vec4(xyz[i], 1.f);         // As in the LambertianRenderer vertex shader
+    glm::vec3 n   = glm::normalize(N * nrm[i]);
+    ClipVertex& v = vertices[i];
+    v.clip = VP * loc;
+    for (unsigned j = 0; j < kNumLights; ++j) {
+      glm::vec3 L = glm::normalize(glm::vec3(lightLoc[j]) - lightLoc[j].w * glm::vec3(loc));
+      v.diffuse[j] = std::max(glm::dot(L, n), 0.f);
+    }
+  }
+}
+
+
+/********************************************************************************
+ * setUpTriangles
+ * Clip, set up and bin the triangles [begin, end) of the concatenated draw calls, as one chunk.
+ ********************************************************************************/
+
+void SoftRasterizer::Impl::setUpTriangles(size_t begin, size_t end, const DrawCall *draws) {
+  const size_t                numTiles = size_t(tilesX) * tilesY, chunk = begin / kTrianglesPerChunk;
+  std::vector<SetupTriangle>& tris = triangles[chunk];
+  std::vector<unsigned>       *chunkBins = &bins[chunk * numTiles];
+  unsigned                    d = unsigned(std::upper_bound(drawStarts.begin(), drawStarts.end(), unsigned(begin)) -
+                                           drawStarts.begin()) - 1;
+  glm::vec3                   ambient, diffuse[kNumLights];
+  SetupTriangle               tri;
+
+  tris.clear();
+  for (size_t t = 0; t < numTiles; ++t)
+    chunkBins[t].clear();
+
+  for (size_t t = begin; t < end; ++t) {
+    if (t == begin || t == drawStarts[d + 1]) {
+      while (t == drawStarts[d + 1]) ++d;               // Skip empty draw calls
+      ambient = glm::vec3(draws[d].ambient.r, draws[d].ambient.g, draws[d].ambient.b);
+      for (unsigned j = 0; j < kNumLights; ++j) {
+        GLSpectrum3f k = lightColor[j] * draws[d].diffuse;
+        diffuse[j] = glm::vec3(k.r, k.g, k.b);
+      }
+    }
+    const unsigned short *ix = draws[d].indices + 3 * (t - drawStarts[d]);
+    const ClipVertex     *cv[3] = { &vertices[ix[0]], &vertices[ix[1]], &vertices[ix[2]] };
+
+    // Trivially reject triangles wholly outside of one plane of the frustum
+    bool out = false;
+    for (unsigned c = 0; c < 3 && !out; ++c)
+      out = (cv[0]->clip[c] >  cv[0]->clip.w && cv[1]->clip[c] >  cv[1]->clip.w && cv[2]->clip[c] >  cv[2]->clip.w) ||
+            (cv[0]->clip[c] < -cv[0]->clip.w && cv[1]->clip[c] < -cv[1]->clip.w && cv[2]->clip[c] < -cv[2]->clip.w);
+    if (out)
+      continue;
+
+    ColorVertex poly[4], in[3];
+    unsigned    n;
+    for (unsigned i = 0; i < 3; ++i) {
+      in[i].clip  = cv[i]->clip;
+      in[i].color = ambient;
+      for (unsigned j = 0; j < kNumLights; ++j)
+        in[i].color += cv[i]->diffuse[j] * diffuse[j];
+    }
+    if (in[0].clip.z + in[0].clip.w >= 0.f && in[1].clip.z + in[1].clip.w >= 0.f &&
+        in[2].clip.z + in[2].clip.w >= 0.f) {
+      memcpy(poly, in, sizeof(in));
+      n = 3;
+    }
+    else {
+      n = ClipToNearPlane(in, poly);
+    }
+
+    for (unsigned i = 2; i < n; ++i) {                  // Fan
+      if (!SetUpTriangle(&poly[0], &poly[i - 1], &poly[i], width, height, &tri))
+        continue;
+      unsigned index = unsigned(tris.size());
+      tris.push_back(tri);
+      for (unsigned ty = unsigned(tri.y0) / kTileSize, ty1 = unsigned(tri.y1 - 1) / kTileSize; ty <= ty1; ++ty)
+        for (unsigned tx = unsigned(tri.x0) / kTileSize, tx1 = unsigned(tri.x1 - 1) / kTileSize; tx <= tx1; ++tx)
+          chunkBins[ty * tilesX + tx].push_back(index);
+    }
+  }
+}
+
+
+/********************************************************************************
+ * rasterizeTile
+ ********************************************************************************/
+
+void SoftRasterizer::Impl::rasterizeTile(unsigned tile, NvCVImage *result) const {
+  alignas(16) float     depth[kTileSize * kTileSize];
+  alignas(16) uint32_t  color[kTileSize * kTileSize];
+  const size_t          numTiles = size_t(tilesX) * tilesY;
+  int                   tileX = int(tile % tilesX * kTileSize),
+                        tileY = int(tile / tilesX * kTileSize);
+
+  std::fill(depth, depth + kTileSize * kTileSize, 1.f);
+  std::fill(color, color + kTileSize * kTileSize, clearPixel);
+  for (size_t c = 0; c < triangles.size(); ++c)         // In the order submitted
+    for (unsigned i : bins[c * numTiles + tile])
+      RasterizeTriangle(triangles[c][i], tileX, tileY, depth, color);
+
+  if (unsigned(tileX) >= result->width || unsigned(tileY) >= result->height)
+    return;
+  unsigned wd = std::min(kTileSize, result->width  - tileX),
+           ht = std::min(kTileSize, result->height - tileY);
+  for (unsigned y = 0; y < ht; ++y)
+    memcpy((unsigned char*)result->pixels + (ptrdiff_t)(tileY + y) * result->pitch + tileX * sizeof(uint32_t),
+           color + y * kTileSize, wd * sizeof(uint32_t));
+}
+
+
+/********************************************************************************
+ * API
+ ********************************************************************************/
+
+const unsigned SoftRasterizer::kNumLights;
+const unsigned SoftRasterizer::kTileSize;
+
+SoftRasterizer::SoftRasterizer() {
+  static_assert(kNumLights == kFaceMeshNumLights, "The renderers must agree on the lights");
+  m_impl = new Impl;
+  setLights(kFaceMeshLightLoc, kFaceMeshLightColor);
+}
+
+SoftRasterizer::~SoftRasterizer() {
+  delete m_impl;
+}
+
+NvCV_Status SoftRasterizer::setViewport(unsigned width, unsigned height) {
+  if (!width || !height)
+    return NVCV_ERR_PARAMETER;
+  m_impl->width  = width;
+  m_impl->height = height;
+  m_impl->tilesX = (width  + kTileSize - 1) / kTileSize;
+  m_impl->tilesY = (height + kTileSize - 1) / kTileSize;
+  m_impl->bins.clear();                                 // Resized for the number of chunks on the next frame
+  return NVCV_SUCCESS;
+}
+
+void SoftRasterizer::setClearColor(float r, float g, float b, float a) {
+  const float rgba[4] = { r, g, b, a };
+  m_impl->clearPixel = PackPixel(rgba);
+}
+
+void SoftRasterizer::setLights(const glm::vec4 locXYZW[kNumLights], const GLSpectrum3f colorRGB[kNumLights]) {
+  for (unsigned i = 0; i < kNumLights; ++i) {
+    m_impl->lightLoc[i]   = locXYZW[i];
+    m_impl->lightColor[i] = colorRGB[i];
+  }
+}
+
+NvCV_Status SoftRasterizer::drawTriMeshes(unsigned numPts, const glm::vec3 *xyz, const glm::vec3 *nrm,
+                                          unsigned numDraws, const DrawCall *draws, const glm::mat4x4& M,
+                                          const glm::mat4x4& VP, NvCVImage *result, WorkerPool *pool) {
+  Impl *impl = m_impl;
+
+  if (NVCV_RGBA != result->pixelFormat || NVCV_U8 != result->componentType ||
+      !(NVCV_CPU == result->gpuMem || NVCV_CPU_PINNED == result->gpuMem))
+    return NVCV_ERR_PIXELFORMAT;
+  if (result->width > impl->width || result->height > impl->height)
+    return NVCV_ERR_MISMATCH;
+
+  impl->drawStarts.resize(numDraws + 1);
+  impl->drawStarts[0] = 0;
+  for (unsigned d = 0; d < numDraws; ++d)
+    impl->drawStarts[d + 1] = impl->drawStarts[d] + draws[d].numIndices / 3;
+  size_t numTris = impl->drawStarts[numDraws],
+         numChunks = (numTris + kTrianglesPerChunk - 1) / kTrianglesPerChunk,
+         numTiles = size_t(impl->tilesX) * impl->tilesY;
+  if (impl->triangles.size() != numChunks) {
+    impl->triangles.resize(numChunks);
+    impl->bins.clear();
+  }
+  impl->bins.resize(numChunks * numTiles);              // Keeps the capacity of the bins from frame to frame
+  impl->vertices.resize(numPts);
+
+  Impl::forChunks(pool, numPts, kVerticesPerChunk, [=, &M, &VP](size_t b, size_t e) {
+    impl->transformVertices(b, e, xyz, nrm, M, VP);
+  });
+  Impl::forChunks(pool, numTris, kTrianglesPerChunk, [=](size_t b, size_t e) {
+    impl->setUpTriangles(b, e, draws);
+  });
+  Impl::forChunks(pool, numTiles, 1, [=](size_t b, size_t e) {
+    for (size_t t = b; t < e; ++t)
+      impl->rasterizeTile(unsigned(t), result);
+  });
+  return NVCV_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __SOFT_RASTERIZER_H
+#define __SOFT_RASTERIZER_H
+
+#include "glm/glm.hpp"
+#include "glSpectrum.h"
+#include "nvCVImage.h"
+
+class WorkerPool;
+
+
+/********************************************************************************
+ * SoftRasterizer
+ * A tile-based triangle rasterizer on the CPU, with the same Gouraud-shaded Lambertian illumination by two lights as
+ * the LambertianRenderer shader. Vertices are lit and projected, triangles are clipped to the near plane, set up and
+ * sorted into bins of screen tiles, and then each tile is rasterized, with a depth test, into its own color and
+ * depth buffers, before being copied into the result. Each phase is split across the worker pool; since every tile
+ * is rasterized by one thread in the order in which the triangles were submitted, the image does not depend on the
+ * number of threads.
+ * The image is stored bottom-up, as glReadPixels() does, so that it can be substituted for the OpenGL renderer.
+ ********************************************************************************/
+
+class SoftRasterizer {
+public:
+  static const unsigned kNumLights  = 2;    ///< The number of lights, as in LAMBERTIAN_NUM_LIGHTS.
+  static const unsigned kTileSize   = 64;   ///< The width and height of a tile, in pixels.
+
+  /// A list of triangles sharing a material.
+  struct DrawCall {
+    const unsigned short  *indices;     ///< The vertex indices, three per triangle.
+    unsigned              numIndices;   ///< The number of indices.
+    GLSpectrum3f          ambient;      ///< The ambient color.
+    GLSpectrum3f          diffuse;      ///< The diffuse color.
+  };
+
+  SoftRasterizer();
+  ~SoftRasterizer();
+
+  /// Set the size of the viewport, allocating the tiles.
+  /// @param[in]  width   the width  of the viewport, in pixels.
+  /// @param[in]  height  the height of the viewport, in pixels.
+  /// @return NVCV_SUCCESS if successful, or NVCV_ERR_PARAMETER if either dimension is 0.
+  NvCV_Status setViewport(unsigned width, unsigned height);
+
+  /// Set the color to which the viewport is cleared before each frame.
+  void setClearColor(float r, float g, float b, float a = 1.f);
+
+  /// Set all lights, as LambertianRenderer::setLights() does.
+  /// @param[in]  locXYZW   the locations of the lights, in world space; W=0 for directional lights, W=1 for point lights.
+  /// @param[in]  colorRGB  the colors of the lights.
+  void setLights(const glm::vec4 locXYZW[kNumLights], const GLSpectrum3f colorRGB[kNumLights]);
+
+  /// Clear the viewport and render triangle meshes that share their vertices into an image.
+  /// @param[in]  numPts    the number of vertices.
+  /// @param[in]  xyz       the vertex positions.
+  /// @param[in]  nrm       the vertex normals.
+  /// @param[in]  numDraws  the number of draw calls.
+  /// @param[in]  draws     the draw calls, rendered in order.
+  /// @param[in]  M         the modeling matrix; its upper-left 3x3 must be orthogonal.
+  /// @param[in]  VP        the viewing and projection matrix.
+  /// @param[out] result    a CPU RGBA U8 image no larger than the viewport, stored bottom-up.
+  /// @param[in]  pool      the worker threads to share the work with, or NULL.
+  /// @return NVCV_SUCCESS            if successful,
+  ///         NVCV_ERR_PIXELFORMAT    if the result is not RGBA U8 in CPU memory,
+  ///         NVCV_ERR_MISMATCH       if the result is larger than the viewport.
+  NvCV_Status drawTriMeshes(unsigned numPts, const glm::vec3 *xyz, const glm::vec3 *nrm,
+                            unsigned numDraws, const DrawCall *draws, const glm::mat4x4& M, const glm::mat4x4& VP,
+                            NvCVImage *result, WorkerPool *pool = nullptr);
+
+private:
+  SoftRasterizer(const SoftRasterizer&) = delete;
+  SoftRasterizer& operator=(const SoftRasterizer&) = delete;
+
+  class Impl;
+  Impl *m_impl;
+};
+
+
+#endif // __SOFT_RASTERIZER_H
@@ -0,0 +1,283 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "softwareMeshRenderer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+  #define strcasecmp _stricmp
+#endif // _MSC_VER
+
+#include "faceIO.h"
+#include "faceMesh.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+#include "glMaterial.h"
+#include "glMesh.h"
+#include "glSpectrum.h"
+#include "simpleFaceModel.h"
+#include "softRasterizer.h"
+#include "workerPool.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/////                        SOFTWARE MESH RENDERER                        /////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+
+class SoftwareMeshRenderer : public MeshRenderer {
+public:
+  ~SoftwareMeshRenderer();
+
+  static NvCV_Status initDispatch(MeshRenderer::Dispatch *dispatch);
+  static NvCV_Status unload();
+  static NvCV_Status setNumThreads(unsigned numThreads);
+  static NvCV_Status setSparseEpsilon(float epsilon);
+
+private:
+  SoftwareMeshRenderer();
+  SimpleFaceModelAdapter                _sfma;
+  GLMesh                                _mesh;
+  GLMaterialLibrary                     _mtlLib;
+  SoftRasterizer                        _raster;
+  std::vector<SoftRasterizer::DrawCall> _draws;     // One per partition
+  unsigned                              _width, _height;
+  glm::mat4x4                           _V, _P;
+  glm::vec3                             _ctrRot;
+  WorkerPool                            _pool;
+  static unsigned                       _numThreads;    // The number of worker threads
+  static float                          _sparseEpsilon; // Blend shape deltas no larger than this are treated as zero
+
+  // C-style object-oriented member functions, as in the OpenGLMeshRenderer.
+  static NvCV_Status create(MeshRenderer **han);
+  static void        destroy(MeshRenderer *han);
+  static NvCV_Status name(const char **str);
+  static NvCV_Status info(const char **str);
+  static NvCV_Status read(MeshRenderer *han, const char *modelFile);
+  static NvCV_Status init(MeshRenderer *han, unsigned width, unsigned height, const char *windowName, bool visible);
+  static NvCV_Status setCamera(MeshRenderer *han, const float locPt[3], const float lookVec[3], const float upVec[3],
+                               float vfov, float near_z = 0.0f, float far_z = 0.0f);
+  static NvCV_Status render(MeshRenderer *han,
+                      const float exprs[53], const float qrot[4], const float tran[3], NvCVImage *result);
+  NvCV_Status        setFOV(float radians, float near_z = 0.0, float far_z = 0.0f);
+  void               makeDrawCalls();
+};
+
+NvCV_Status SoftwareMeshRenderer_InitDispatch(MeshRenderer::Dispatch *dispatch) {
+  return SoftwareMeshRenderer::initDispatch(dispatch);
+}
+
+NvCV_Status SoftwareMeshRenderer_Unload() {
+  return SoftwareMeshRenderer::unload();
+}
+
+NvCV_Status SoftwareMeshRenderer_SetNumThreads(unsigned numThreads) {
+  return SoftwareMeshRenderer::setNumThreads(numThreads);
+}
+
+NvCV_Status SoftwareMeshRenderer_SetSparseEpsilon(float epsilon) {
+  return SoftwareMeshRenderer::setSparseEpsilon(epsilon);
+}
+
+unsigned SoftwareMeshRenderer::_numThreads    = ~0u;  // Default
+float    SoftwareMeshRenderer::_sparseEpsilon = kFaceMeshSparseEpsilon;
+
+
+SoftwareMeshRenderer::SoftwareMeshRenderer() : _width(0), _height(0), _V(1.f), _P(1.f), _ctrRot(0.f) {
+  /*NvCV_Status err =*/ (void)initDispatch(&this->m_dispatch);
+}
+
+SoftwareMeshRenderer::~SoftwareMeshRenderer() {
+}
+
+NvCV_Status SoftwareMeshRenderer::name(const char **str) {
+  static const char name[] = "Software";
+  *str = name;
+  return NVCV_SUCCESS;
+}
+
+NvCV_Status SoftwareMeshRenderer::info(const char **str) {
+  static const char info[] = "Tile-based CPU renderer using local illumination, needing neither GPU nor display";
+  *str = info;
+  return NVCV_SUCCESS;
+}
+
+NvCV_Status SoftwareMeshRenderer::create(MeshRenderer **han) {
+  *han = new SoftwareMeshRenderer();
+  return NVCV_SUCCESS;
+}
+
+void SoftwareMeshRenderer::destroy(MeshRenderer* han) {
+  SoftwareMeshRenderer *ren = static_cast<SoftwareMeshRenderer*>(han);
+  delete ren;
+}
+
+/// Make one draw call for each partition, with the colors of its material, as the OpenGL RenderContext does.
+void SoftwareMeshRenderer::makeDrawCalls() {
+  _draws.clear();
+  if (!_mesh.numNormals())
+    return;
+  for (unsigned ix = 0, numPartitions = _mesh.numPartitions(); ix < numPartitions; ++ix) {
+    GLMesh::Partition pt;
+    if (NVCV_SUCCESS != _mesh.getPartition(ix, pt))
+      continue;
+    const GLMaterial *mtl = _mtlLib.getMaterial(pt.materialName.c_str());
+    SoftRasterizer::DrawCall draw;
+    draw.indices    = _mesh.getVertexIndices() + pt.vertexIndex;
+    draw.numIndices = pt.numVertexIndices;
+    draw.ambient    = mtl ? mtl->ambientColor : kFaceMeshAmbient;
+    draw.diffuse    = mtl ? mtl->diffuseColor : kFaceMeshDiffuse;
+    _draws.push_back(draw);
+  }
+}
+
+NvCV_Status SoftwareMeshRenderer::read(MeshRenderer *han, const char *modelFile) {
+  SoftwareMeshRenderer *ren = static_cast<SoftwareMeshRenderer*>(han);
+  size_t z = strlen(modelFile);
+  if (z < 5) return NVCV_ERR_FILE;
+  if (!strcasecmp(".nvf", modelFile + z - 4)) {
+    FaceIOErr ioErr = ReadNVFFaceModelMapped(modelFile, &ren->_sfma,
+                                             kIOSectionModel | kIOSectionBlendShapes |
+                                             kIOSectionTopology | kIOSectionPartitions);
+    if (kIOErrNone != ioErr) {
+      printf("Error: \"%s\": %s\n", modelFile, FaceIOErrorStringFromCode(ioErr));
+      return NVCV_ERR_READ;
+    }
+    NvCV_Status nvErr;
+    nvErr = MakeMesh(&ren->_sfma, &ren->_mesh);
+    if (NVCV_SUCCESS != nvErr) return nvErr;
+    ren->_sfma.fm.sparsify(_sparseEpsilon);
+
+    std::string mtlFile;
+    mtlFile.assign(modelFile, 0, strlen(modelFile) - 3);
+    mtlFile += "mtl";
+    nvErr = ren->_mtlLib.read(mtlFile.c_str());
+    unsigned why = ren->_mesh.notRenderable(0);
+    if (why) {
+      printf("Mesh \"%s\" is not renderable: %s: %s\n", modelFile,
+        ((why & GLMesh::NOT_TRIMESH) ? "not a TriMesh" : ""),
+        ((why & GLMesh::COMPLEX_TOPOLOGY) ? "complex topology" : "")
+      );
+      return NVCV_ERR_MISMATCH;
+    }
+    ren->makeDrawCalls();
+    return NVCV_SUCCESS;
+  }
+  else {
+    return NVCV_ERR_FILE;
+  }
+}
+
+NvCV_Status SoftwareMeshRenderer::init(MeshRenderer *han,
+    unsigned width, unsigned height, const char * /*windowName*/, bool /*visible*/) {
+  SoftwareMeshRenderer      *ren = static_cast<SoftwareMeshRenderer*>(han);
+  NvCV_Status               nvErr;
+
+  nvErr = ren->_raster.setViewport(width, height);
+  if (NVCV_SUCCESS != nvErr) return nvErr;
+  ren->_width  = width;
+  ren->_height = height;
+  ren->_raster.setClearColor(kFaceMeshClearColor.r, kFaceMeshClearColor.g, kFaceMeshClearColor.b, 1.f);
+  ren->_raster.setLights(kFaceMeshLightLoc, kFaceMeshLightColor);
+  ren->setFOV(0.f); // Default orthographic
+  return NVCV_SUCCESS;
+}
+
+NvCV_Status SoftwareMeshRenderer::setFOV(float fov, float near_z, float far_z) {
+  if (!_height) return NVCV_ERR_INITIALIZATION;
+  return FrameFaceMesh(_mesh, fov, (float)_width / (float)_height, near_z, far_z, &_ctrRot, &_V, &_P);
+}
+
+NvCV_Status SoftwareMeshRenderer::setCamera(MeshRenderer *han, const float locPt[3], const float lookVec[3],
+                                            const float upVec[3], float vfov, float near_z, float far_z) {
+  SoftwareMeshRenderer *ren = static_cast<SoftwareMeshRenderer*>(han);
+  if (locPt || lookVec || upVec) {
+    if (!locPt || !lookVec || !upVec || vfov <= 0.0f || (near_z == 0.0f && far_z == 0.0f)) return NVCV_ERR_PARAMETER;
+    if (!ren->_height) return NVCV_ERR_INITIALIZATION;
+    const float aspect = static_cast<float>(ren->_width) / static_cast<float>(ren->_height);
+    ren->_P = glm::perspective(vfov, aspect, near_z, far_z);
+    ren->_V = glm::lookAt(glm::make_vec3(locPt), glm::make_vec3(lookVec), glm::make_vec3(upVec));
+    return NVCV_SUCCESS;
+  }
+  // Default to camera based on bounding box if not enough input arguments are provided
+  return ren->setFOV(vfov, near_z, far_z);
+}
+
+NvCV_Status SoftwareMeshRenderer::render(MeshRenderer *han,
+    const float exprs[53], const float qrot[4], const float* trans, NvCVImage *result) {
+  SoftwareMeshRenderer *ren = static_cast<SoftwareMeshRenderer*>(han);
+  NvCV_Status nvErr;
+
+  if (NVCV_RGBA != result->pixelFormat)
+    return NVCV_ERR_PIXELFORMAT;
+
+  glm::mat4x4 M  = FaceModelMatrix(qrot, trans, ren->_ctrRot),
+              VP = ren->_P * ren->_V;
+
+  unsigned numThreads = FaceMeshNumThreads(_numThreads);
+  if (ren->_pool.numThreads() != numThreads)
+    ren->_pool.setNumThreads(numThreads);
+  // Every frame is rebuilt from the mean shape, so that the image does not depend on the previous frames
+  nvErr = DeformModel(ren->_sfma.fm, nullptr, exprs, &ren->_mesh, nullptr, 0.f, 0, &ren->_pool);
+  if (NVCV_SUCCESS != nvErr) return nvErr;
+  // The image is upside-down, as from the OpenGL renderer, so the caller can flip it with NvCVImage_FlipY
+  return ren->_raster.drawTriMeshes(ren->_mesh.numVertices(), ren->_mesh.getVertices(), ren->_mesh.getNormals(),
+                                    unsigned(ren->_draws.size()), ren->_draws.data(), M, VP, result, &ren->_pool);
+}
+
+NvCV_Status SoftwareMeshRenderer::initDispatch(MeshRenderer::Dispatch *dispatch) {
+  dispatch->name      = &SoftwareMeshRenderer::name;
+  dispatch->info      = &SoftwareMeshRenderer::info;
+  dispatch->create    = &SoftwareMeshRenderer::create;
+  dispatch->destroy   = &SoftwareMeshRenderer::destroy;
+  dispatch->read      = &SoftwareMeshRenderer::read;
+  dispatch->init      = &SoftwareMeshRenderer::init;
+  dispatch->setCamera = &SoftwareMeshRenderer::setCamera;
+  dispatch->render    = &SoftwareMeshRenderer::render;
+  dispatch->submit    = nullptr;  // The image is finished when render() returns, so there is nothing to overlap
+  dispatch->collect   = nullptr;
+  dispatch->renderBatch = nullptr;  // SoftRasterizer always renders the whole viewport
+  return NVCV_SUCCESS;
+}
+
+NvCV_Status SoftwareMeshRenderer::unload() {
+  return NVCV_SUCCESS;
+}
+
+NvCV_Status SoftwareMeshRenderer::setNumThreads(unsigned numThreads) {
+  _numThreads = numThreads;
+  return NVCV_SUCCESS;
+}
+
+NvCV_Status SoftwareMeshRenderer::setSparseEpsilon(float epsilon) {
+  _sparseEpsilon = epsilon;
+  return NVCV_SUCCESS;
+}
@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __SOFTWARE_MESH_RENDERER__
+#define __SOFTWARE_MESH_RENDERER__
+
+#include "meshRenderer.h"
+
+
+/// Initialize the dispatch table of the software renderer, "Software".
+/// It renders on the CPU, with the same illumination as the OpenGL renderer, directly into the result image, so it
+/// needs neither a GPU nor a display. The image depends only on the model, the camera and the arguments of render(),
+/// and not on the number of threads or on the previous frames, so it is suitable for golden-image tests.
+/// The windowName and visible arguments of init() are ignored.
+/// @param[out] dispatch the dispatch table.
+/// @return NVCV_SUCCESS if successful.
+NvCV_Status SoftwareMeshRenderer_InitDispatch(MeshRenderer::Dispatch *dispatch);
+
+/// Unload the Software Mesh Renderer from memory.
+/// @note Any previously initialized dispatch tables will be invalid.
+/// @return NVCV_SUCCESS if successful.
+NvCV_Status SoftwareMeshRenderer_Unload();
+
+/// Set the number of worker threads used to deform, light and rasterize the mesh, in addition to the rendering thread.
+/// @param[in] numThreads the number of worker threads; 0 does all of the work on the rendering thread.
+///                       The default is one less than the number of hardware threads, up to 15.
+/// @return NVCV_SUCCESS if successful.
+NvCV_Status SoftwareMeshRenderer_SetNumThreads(unsigned numThreads);
+
+/// Set the threshold below which blend shape deltas are treated as zero, in models read subsequently,
+/// as OpenGLMeshRenderer_SetSparseEpsilon() does for the OpenGL renderers.
+/// @param[in] epsilon  the largest magnitude of a delta component that is considered to be zero.
+///                     Negative values disable sparse blend shapes. The default is 1.0e-5.
+/// @return NVCV_SUCCESS if successful.
+NvCV_Status SoftwareMeshRenderer_SetSparseEpsilon(float epsilon);
+
+
+#endif // __SOFTWARE_MESH_RENDERER__
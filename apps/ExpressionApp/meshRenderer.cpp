@@ -35,6 +35,7 @@
 #include "meshRenderer.h"
 #include "directoryIterator.h"
 #include "openGLMeshRenderer.h" // Eventually this will be discoverable
+#include "softwareMeshRenderer.h"
 #include <string.h>
 #include <string>
 #include <vector>
@@ -114,6 +115,24 @@ NvCV_Status MeshRenderer::render(const float exprs[53], const float qrot[4], con
 }
 
 
+NvCV_Status MeshRenderer::submit(const float exprs[53], const float qrot[4], const float trans[3]) {
+  if (!m_dispatch.submit) return NVCV_ERR_UNIMPLEMENTED;
+  return m_dispatch.submit(this, exprs, qrot, trans);
+}
+
+
+NvCV_Status MeshRenderer::collect(NvCVImage *result) {
+  if (!m_dispatch.collect) return NVCV_ERR_UNIMPLEMENTED;
+  return m_dispatch.collect(this, result);
+}
+
+
+NvCV_Status MeshRenderer::renderBatch(unsigned numInstances, const Instance *instances, NvCVImage *result) {
+  if (!m_dispatch.renderBatch) return NVCV_ERR_UNIMPLEMENTED;
+  return m_dispatch.renderBatch(this, numInstances, instances, result);
+}
+
+
 MeshRenderer::Dispatch::Dispatch() {
   memset(this, 0, sizeof(*this));
 }
@@ -139,7 +158,8 @@ public:
 
 class MeshRendererBroker::Impl {
 public:
-  static const char nameStr[], infoStr[], createStr[], destroyStr[], readStr[], initStr[], setCameraStr[], renderStr[];
+  static const char nameStr[], infoStr[], createStr[], destroyStr[], readStr[], initStr[], setCameraStr[], renderStr[],
+                    submitStr[], collectStr[], renderBatchStr[];
 
   std::string rendererDirectory;
   std::vector<RendererInfo> renderers;
@@ -161,6 +181,9 @@ const char MeshRendererBroker::Impl::readStr[]      = "RendererReadModel";
 const char MeshRendererBroker::Impl::initStr[]      = "RendererInit";
 const char MeshRendererBroker::Impl::setCameraStr[] = "RendererSetCamera";
 const char MeshRendererBroker::Impl::renderStr[]    = "RendererRender";
+const char MeshRendererBroker::Impl::submitStr[]    = "RendererSubmit";
+const char MeshRendererBroker::Impl::collectStr[]   = "RendererCollect";
+const char MeshRendererBroker::Impl::renderBatchStr[] = "RendererRenderBatch";
 
 
 static bool HasDLLSuffix(const char *name) {
@@ -235,6 +258,9 @@ NvCV_Status MeshRendererBroker::Impl::LoadRenderer(const char *name) {
         *((void**)&ri.dispatch.init)      = nvGetProcAddress(ri.module, initStr);
         *((void**)&ri.dispatch.setCamera) = nvGetProcAddress(ri.module, setCameraStr);
         *((void**)&ri.dispatch.render)    = nvGetProcAddress(ri.module, renderStr);
+        *((void**)&ri.dispatch.submit)    = nvGetProcAddress(ri.module, submitStr);   // Optional
+        *((void**)&ri.dispatch.collect)   = nvGetProcAddress(ri.module, collectStr);  // Optional
+        *((void**)&ri.dispatch.renderBatch) = nvGetProcAddress(ri.module, renderBatchStr);  // Optional
       }
       return NVCV_SUCCESS;
     }
@@ -261,10 +287,16 @@ MeshRendererBroker::MeshRendererBroker() {
   NvCV_Status err;
   m_impl = new Impl;
 
-  // Automatically register the OpenGL Renderer
+  // Automatically register the OpenGL and Software Renderers
   MeshRenderer::Dispatch disp;
   if (NVCV_SUCCESS == (err = OpenGLMeshRenderer_InitDispatch(&disp)))
     MeshRendererBroker::addRenderer(&disp);
+#ifdef OPENGL_HEADLESS  // Only when built with EGL
+  if (NVCV_SUCCESS == (err = OpenGLHeadlessMeshRenderer_InitDispatch(&disp)))
+    MeshRendererBroker::addRenderer(&disp);
+#endif  // OPENGL_HEADLESS
+  if (NVCV_SUCCESS == (err = SoftwareMeshRenderer_InitDispatch(&disp)))
+    MeshRendererBroker::addRenderer(&disp);
 }
 
 
@@ -32,6 +32,16 @@
 /// Abstract class to provide methods and hide the implementation.
 class MeshRenderer {
 public:
+  /// One of the heads rendered together by renderBatch().
+  struct Instance {
+    const float *exprs;   ///< The expression signals (53 of them).
+    const float *qrot;    ///< The rotation    of the model as an xyzw quaternion.
+    const float *trans;   ///< The translation of the model as an xyz  vector, or NULL.
+    unsigned    x, y;     ///< The upper-left corner of the tile in which to render the head, in the upright image.
+    unsigned    width;    ///< The width  of the tile.
+    unsigned    height;   ///< The height of the tile.
+  };
+
   struct Dispatch {
     // We get these procs from the DLL
     NvCV_Status (*name)(const char **str);
@@ -44,6 +54,10 @@ public:
                              float vfov, float near_z, float far_z);
     NvCV_Status (*render)(MeshRenderer *han,
                           const float exprs[53], const float qrot[4], const float trans[3], NvCVImage *result);
+    // These are optional, and may be NULL
+    NvCV_Status (*submit)(MeshRenderer *han, const float exprs[53], const float qrot[4], const float trans[3]);
+    NvCV_Status (*collect)(MeshRenderer *han, NvCVImage *result);
+    NvCV_Status (*renderBatch)(MeshRenderer *han, unsigned numInstances, const Instance *instances, NvCVImage *result);
     Dispatch();
     ~Dispatch() {}
   };
@@ -99,6 +113,42 @@ public:
   /// @note: This will appear upside-down.
   NvCV_Status render(const float exprs[53], const float qrot[4], const float trans[3], NvCVImage *result);
 
+  /// Submit a frame to be rendered asynchronously, returning before its image is available.
+  /// Frames are collected in the order in which they were submitted, and a renderer may only have a few frames in
+  /// flight: typically a frame is submitted, then the previous one collected, so that the readback of one frame
+  /// overlaps the rendering of the next and the work of the caller.
+  /// @param[in]  exprs   the expression signals (53 of them).
+  /// @param[in]  qrot    the rotation    of the model as an xyzw quaternion.
+  /// @param[in]  trans   the translation of the model as an xyz  vector.
+  /// @return     NVCV_SUCCESS            if the frame was submitted;
+  ///             NVCV_ERR_BUFFER         if too many frames are in flight, and one must be collected first;
+  ///             NVCV_ERR_UNIMPLEMENTED  if the renderer cannot render asynchronously; use render() instead.
+  NvCV_Status submit(const float exprs[53], const float qrot[4], const float trans[3]);
+
+  /// Collect the oldest frame that was submitted, waiting until it has been rendered.
+  /// @param[out] result  the resultant rendered image, no larger than the size given to init().
+  /// @return     NVCV_SUCCESS              if the image was collected;
+  ///             NVCV_ERR_NOTHINGRENDERED  if no frames are in flight;
+  ///             NVCV_ERR_UNIMPLEMENTED    if the renderer cannot render asynchronously.
+  /// @note: This will appear upside-down, as with render().
+  NvCV_Status collect(NvCVImage *result);
+
+  /// Render several heads, each in its own tile of one image, with a single readback.
+  /// The model is deformed separately for each instance, and its deformation is carried from one batch to the next
+  /// by the position of the instance in the array, so that heads keep their identities from frame to frame.
+  /// The camera is that of setCamera(), with its projection fit to each tile, preserving whichever of the horizontal
+  /// or vertical field of view of the whole image is the tighter. The image is cleared to the background first;
+  /// where tiles overlap, later instances are drawn over earlier ones.
+  /// @param[in]  numInstances  the number of heads.
+  /// @param[in]  instances     the expression, pose and tile of each head.
+  /// @param[out] result        the resultant rendered image, no larger than the size given to init().
+  /// @return     NVCV_SUCCESS            if the heads were rendered;
+  ///             NVCV_ERR_PARAMETER      if a tile lies outside of the image, or an instance lacks expressions or
+  ///                                     rotation;
+  ///             NVCV_ERR_UNIMPLEMENTED  if the renderer cannot render batches.
+  /// @note: This will appear upside-down, as with render().
+  NvCV_Status renderBatch(unsigned numInstances, const Instance *instances, NvCVImage *result);
+
 protected:
   MeshRenderer()  {}   ///< Never create a member of this class
   ~MeshRenderer() {}   ///< Instantiations are always subclasses
@@ -36,6 +36,7 @@
 #include <iostream>
 #include <memory>
 
+#include "audioWindowProvider.h"
 #include "nvAR.h"
 #include "nvARLipSync.h"
 #include "nvAR_defs.h"
@@ -547,12 +548,20 @@ App::Err App::Run(void) {
   RETURN_APPERR_IF_NVERR(
       err = NvAR_GetU32(m_lipSyncHandle, NvAR_Parameter_Config(NumInitialFrames), &init_latency_frame_cnt), errSDK);
 
-  // Read audio file
-  std::vector<float>* input_wav_samples;
-  unsigned int input_num_samples = 0;
-  // read the input audio file
-  if (!ReadWavFile(FLAG_inAudio.c_str(), input_sample_rate, num_channels, &input_wav_samples, &input_num_samples,
-                   nullptr, /* align_samples */ -1, FLAG_debug || FLAG_verbose)) {
+  // Open the input audio file; each video frame's window of audio is converted from it as it is needed.
+  std::unique_ptr<CWaveFileStream> input_wav;
+  if (!OpenWavFileStream(FLAG_inAudio, input_sample_rate, num_channels, &input_wav, FLAG_debug || FLAG_verbose)) {
+    std::cerr << "Unable to read wav file: " << FLAG_inAudio << std::endl;
+    return errAudioFile;
+  }
+
+  // Each video frame's window of audio comes from a ring buffer that is filled from the file a chunk at a time.
+  CAudioWindowProvider audio_windows;
+  uint32_t fps_num, fps_den;
+  CAudioWindowProvider::FrameRateToRational(m_fps, &fps_num, &fps_den);
+  if (!audio_windows.Init(input_wav.get(), fps_num, fps_den,
+                          FLAG_extendAudio == kExtendAudioSilence ? CAudioWindowProvider::kExtendSilence
+                                                                  : CAudioWindowProvider::kExtendNone)) {
     std::cerr << "Unable to read wav file: " << FLAG_inAudio << std::endl;
     return errAudioFile;
   }
@@ -571,9 +580,6 @@ App::Err App::Run(void) {
   RETURN_APPERR_IF_NVERR(err = NvAR_SetU32Array(m_lipSyncHandle, NvAR_Parameter_Output(Ready), &output_ready, 1),
                          errSDK);
 
-  const unsigned int samples_per_second = input_sample_rate;  // 16000 Hz
-  unsigned int last_audio_end_sample = 0;
-  float estimated_video_frame_duration = 1.0f / m_fps;
   cv::Mat img;
 
   bool audio_finished = false;
@@ -598,17 +604,6 @@ App::Err App::Run(void) {
       }
     }
 
-    // Get timestamp from video frame in seconds
-    double frame_timestamp = input_frame_index * estimated_video_frame_duration;
-
-    // Calculate audio window based on video timestamp
-    const unsigned int audio_start_sample = last_audio_end_sample;
-    const unsigned int audio_end_sample =
-        static_cast<unsigned int>((frame_timestamp + estimated_video_frame_duration) * samples_per_second);
-    const unsigned audio_frame_length = audio_end_sample - audio_start_sample;
-    // Store end sample for next frame.
-    last_audio_end_sample = audio_end_sample;
-
     if (FLAG_debug) std::cerr << "Processing frame index: " << input_frame_index << std::endl;
 
     if (!video_finished && !got_video_frame) {
@@ -649,29 +644,17 @@ App::Err App::Run(void) {
       }
     }
 
-    // Create audio frame initialized to zero.
-    // Generates silence if audio file has finished
-    std::vector<float> audio_frame(audio_frame_length, 0.0f);
-    // Copy valid audio into the frame.
-    const size_t valid_audio_start_sample = std::min<size_t>(audio_start_sample, input_wav_samples->size());
-    const size_t valid_audio_end_sample = std::min<size_t>(audio_end_sample, input_wav_samples->size());
-    std::copy(input_wav_samples->begin() + valid_audio_start_sample,
-              input_wav_samples->begin() + valid_audio_end_sample, audio_frame.begin());
-
-    // Check if we have more audio to read.
-    bool got_audio_frame = audio_start_sample < input_wav_samples->size();
+    // Get the window of audio that goes with the video frame.
+    // It is silence if the audio has finished, and we only get one then if the audio is extended with silence.
+    float* audio_frame;
+    uint32_t audio_frame_size;
+    bool got_audio_frame = audio_windows.NextFrame(&audio_frame, &audio_frame_size);
 
-    if (!audio_finished && !got_audio_frame) {
-      // The first time we fail to read a frame, it's the end of the audio.
+    if (!audio_finished && audio_windows.WindowIsPastEnd()) {
+      // The first time the window is past the end of the audio, the audio has finished.
       audio_finished = true;
     }
 
-    if (audio_finished && !got_audio_frame) {
-      if (FLAG_extendAudio == kExtendAudioSilence) {
-        got_audio_frame = true;
-      }
-    }
-
     // Check if we should stop processing.
     const bool should_stop = (video_finished && audio_finished) || !got_video_frame || !got_audio_frame;
     // Only update `end_frame_index` once, the first time `should_stop` is true.
@@ -685,8 +668,8 @@ App::Err App::Run(void) {
 
     if (FLAG_bypassFactor != 0 || (roi.width > 0 && roi.height > 0)) {
       NvAR_SpeakerData speaker_data{};
-      speaker_data.audio_frame_data = audio_frame.data();
-      speaker_data.audio_frame_size = audio_frame.size();
+      speaker_data.audio_frame_data = audio_frame;
+      speaker_data.audio_frame_size = audio_frame_size;
       speaker_data.bypass = FLAG_bypassFactor;
       speaker_data.region_type = static_cast<int>(FLAG_roiSkipFaceDetect);
       speaker_data.region = roi;
@@ -696,7 +679,7 @@ App::Err App::Run(void) {
     } else {
       // Set Audio Frame
       RETURN_APPERR_IF_NVERR(err = NvAR_SetF32Array(m_lipSyncHandle, NvAR_Parameter_Input(AudioFrameBuffer),
-                                                    audio_frame.data(), audio_frame.size()),
+                                                    audio_frame, audio_frame_size),
                              errSDK);
     }
 
@@ -29,6 +29,7 @@
 #include <memory>
 #include <string>
 
+#include "audioWindowProvider.h"
 #include "batchUtilities.h"
 #include "nvAR.h"
 #include "nvARLipSync.h"
@@ -403,7 +404,8 @@ NvCV_Status BatchProcessVideos() {
   NvCVImage nv_img;
   unsigned src_video_width = 0, src_video_height = 0;
   unsigned int init_latency_frame_count = 0;
-  std::vector<std::vector<float>*> list_of_audio(num_streams);
+  std::vector<std::unique_ptr<CWaveFileStream>> list_of_audio(num_streams);
+  std::vector<CAudioWindowProvider> audio_windows(num_streams);  // The window of audio for each frame of each stream
   std::vector<cv::Mat> frames(num_streams), frames_t_1(num_streams);
   std::vector<unsigned> audio_nr_chunks(num_streams);
   std::vector<cv::Mat> src_img_buffer(num_streams);
@@ -416,11 +418,6 @@ NvCV_Status BatchProcessVideos() {
   unsigned batchsize = 0;
   unsigned frame_count = 0;
   double fps;
-  unsigned input_num_samples = 0;
-  const unsigned int samples_per_second = LipsyncConstants::kInputSampleRate;  // 16000 Hz
-  unsigned int last_audio_end_sample = 0;
-  float estimated_video_frame_duration = 1.0f / LipsyncConstants::kFPS;
-  std::vector<double> frame_timestamp(num_streams);
   std::vector<bool> audio_finished(num_streams, false);
   std::vector<int> flush_frames_remaining;
   float* activation = nullptr;
@@ -460,14 +457,19 @@ NvCV_Status BatchProcessVideos() {
     list_of_captures[i].set(cv::CAP_PROP_POS_FRAMES, 0);
   }
 
-  // Read audio
+  // Open audio; each video frame's window of audio comes from a ring buffer, filled from the file a chunk at a time.
+  // Streams are padded with silence once their audio has finished, while the pipeline is flushed.
+  uint32_t fps_num, fps_den;
+  CAudioWindowProvider::FrameRateToRational(LipsyncConstants::kFPS, &fps_num, &fps_den);
   for (int i = 0; i < num_streams; i++) {
-    if (!ReadWavFile(FLAG_srcAudioFiles[i], LipsyncConstants::kInputSampleRate, LipsyncConstants::kAudioNumChannels,
-                     &list_of_audio[i], &input_num_samples, nullptr, -1, FLAG_verbose)) {
+    if (!OpenWavFileStream(FLAG_srcAudioFiles[i], LipsyncConstants::kInputSampleRate,
+                           LipsyncConstants::kAudioNumChannels, &list_of_audio[i], FLAG_verbose) ||
+        !audio_windows[i].Init(list_of_audio[i].get(), fps_num, fps_den, CAudioWindowProvider::kExtendSilence)) {
       printf("Unable to read wav file: %s\n", FLAG_srcAudioFiles[i].c_str());
       return NVCV_ERR_READ;
     }
   }
+  audio_frame_batched.reserve(size_t(num_streams) * audio_windows[0].GetMaxWindowSize());
 
   BAIL_IF_ERR(err = app->Init(num_streams));                                                // Init effect
   BAIL_IF_ERR(err = app->AllocateBuffers(src_video_width, src_video_height, num_streams));  // Allocate buffers
@@ -504,7 +506,6 @@ NvCV_Status BatchProcessVideos() {
     batchsize = 0;  // batchsize = number of active videos
 
     for (unsigned i = 0; i < num_streams; i++) {
-      frame_timestamp[i] += 1.0f / static_cast<double>(LipsyncConstants::kFPS);
       if (list_of_captures[i].isOpened()) {
         list_of_captures[i] >> frames_t_1[i];  // Reading the next frame to know if the video has ended
                                                // as it is not possible to know if current frame is last
@@ -543,32 +544,19 @@ NvCV_Status BatchProcessVideos() {
         NVWrapperForCVMat(&frames[i], &nv_img);
         BAIL_IF_ERR(err = TransferToNthImage(batchsize, &nv_img, &app->m_srcVid, 1, app->m_cudaStream, &app->m_tmpImg));
       }
-      std::vector<float> audio_frame;
-      unsigned int audio_start_sample = last_audio_end_sample;
-      unsigned requested_audio_end_sample = static_cast<unsigned int>(frame_timestamp[i] * samples_per_second);
-      unsigned int audio_end_sample =
-          std::min(static_cast<size_t>(requested_audio_end_sample), list_of_audio[i]->size());
-      // Store end sample for next frame.
-      last_audio_end_sample = requested_audio_end_sample;
-      // Pad with zeros for when audio is finished
-      if (audio_finished[i]) {
-        audio_frame.insert(audio_frame.end(), requested_audio_end_sample - audio_start_sample, 0.0f);
-      } else {
-        audio_frame.insert(audio_frame.end(), list_of_audio[i]->begin() + audio_start_sample,
-                           list_of_audio[i]->begin() + audio_end_sample);
-        // If we need padding, insert the required number of zeros and set audio_finished to true
-        if (requested_audio_end_sample >= list_of_audio[i]->size()) {
-          unsigned int num_padding = requested_audio_end_sample - audio_end_sample;
-          if (FLAG_verbose) {
-            printf("Audio Stream %d ending at frame %d\n", i, frame_count);
-          }
-          audio_finished[i] = true;
-          audio_frame.insert(audio_frame.end(), num_padding, 0.0f);
+      // Append the window of audio to the batch; it is silence when the audio is finished
+      float* audio_frame;
+      uint32_t audio_frame_length;
+      audio_windows[i].NextFrame(&audio_frame, &audio_frame_length);
+      audio_frame_batched.insert(audio_frame_batched.end(), audio_frame, audio_frame + audio_frame_length);
+      if (!audio_finished[i] && audio_windows[i].WindowReachesEnd()) {
+        if (FLAG_verbose) {
+          printf("Audio Stream %d ending at frame %d\n", i, frame_count);
         }
+        audio_finished[i] = true;
       }
 
-      audio_frame_batched.insert(audio_frame_batched.end(), audio_frame.begin(), audio_frame.end());
-      audio_frame_num_samples[batchsize] = audio_frame.size();
+      audio_frame_num_samples[batchsize] = audio_frame_length;
       batch_indices[batchsize] = i;  // storing video indices for creating output videos
       batchsize++;                   // counting the number of active videos
     }
@@ -606,7 +594,6 @@ NvCV_Status BatchProcessVideos() {
     }
     frame_count++;
     audio_frame_batched.clear();
-    audio_frame_num_samples.clear();
   }
 bail:
   for (auto& writer : list_of_writers) writer.release();
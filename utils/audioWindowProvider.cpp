@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "audioWindowProvider.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "waveReadWrite.h"
+
+const uint32_t CAudioWindowProvider::kChunkSamples;
+
+bool CAudioWindowProvider::Init(ReadProc source, uint32_t sampleRate, uint32_t fpsNum, uint32_t fpsDen,
+                                ExtendMode extend) {
+  if (!source || !sampleRate || !fpsNum || !fpsDen) return false;
+
+  m_source = std::move(source);
+  m_extend = extend;
+  m_sampleRate = sampleRate;
+  m_fpsNum = fpsNum;
+  m_fpsDen = fpsDen;
+
+  // Windows are at most ceil(R / F) samples, and the ring holds a chunk of read-ahead on top of a window
+  m_maxWindow = static_cast<uint32_t>((m_sampleRate * m_fpsDen + m_fpsNum - 1) / m_fpsNum) + 1;
+  m_capacity = kChunkSamples + 2 * m_maxWindow;
+  m_ring.assign(size_t(m_capacity) + m_maxWindow, 0.f);
+
+  m_writePos = 0;
+  m_sourceEnded = false;
+  m_sourceEnd = 0;
+  m_frameIndex = 0;
+  m_windowStart = m_windowEnd = 0;
+  m_started = false;
+  return true;
+}
+
+bool CAudioWindowProvider::Init(const CWaveFileStream* stream, uint32_t fpsNum, uint32_t fpsDen, ExtendMode extend) {
+  if (!stream || !stream->isValid()) return false;
+  stream->Reserve(kChunkSamples);  // So that reading it allocates no memory after this
+  uint64_t pos = 0;
+  auto read = [stream, pos](float* dst, uint32_t count) mutable -> uint32_t {
+    uint32_t n = stream->ReadFloat(pos, count, dst);
+    pos += n;
+    return n;
+  };
+  return Init(read, stream->GetSampleRate(), fpsNum, fpsDen, extend);
+}
+
+void CAudioWindowProvider::FrameRateToRational(double fps, uint32_t* num, uint32_t* den) {
+  const uint32_t kDenominators[] = {1, 1001, 1000};
+  for (uint32_t d : kDenominators) {
+    const double n = std::round(fps * d);
+    if (n >= 1 && (std::fabs(n / d - fps) <= fps * 1e-5 || d == 1000)) {
+      *num = static_cast<uint32_t>(n);
+      *den = d;
+      return;
+    }
+  }
+  *num = 1;  // Less than 1 frame in 1000 seconds
+  *den = 1000;
+}
+
+// Put the samples up to end into the ring, reading from the source a chunk at a time, or silence once it has ended.
+void CAudioWindowProvider::fill(uint64_t end) {
+  while (m_writePos < end) {
+    const uint32_t offset = static_cast<uint32_t>(m_writePos % m_capacity);
+    // Stop at the end of the ring, and never overwrite the current window
+    const uint32_t n = static_cast<uint32_t>(std::min<uint64_t>(
+        std::min<uint32_t>(kChunkSamples, m_capacity - offset), m_capacity - (m_writePos - m_windowStart)));
+    float* dst = m_ring.data() + offset;
+    uint32_t got = 0;
+    if (!m_sourceEnded) {
+      got = m_source(dst, n);
+      if (got < n) {
+        m_sourceEnded = true;
+        m_sourceEnd = m_writePos + got;
+      }
+    }
+    if (got < n) memset(dst + got, 0, (n - got) * sizeof(float));
+    // Mirror the start of the ring after its end, so that a window that wraps around is contiguous
+    if (offset < m_maxWindow) memcpy(dst + m_capacity, dst, std::min(n, m_maxWindow - offset) * sizeof(float));
+    m_writePos += n;
+  }
+}
+
+bool CAudioWindowProvider::NextFrame(float** samples, uint32_t* numSamples) {
+  if (m_started) ++m_frameIndex;
+  m_started = true;
+  m_windowStart = m_frameIndex ? frameEnd(m_frameIndex - 1) : 0;
+  m_windowEnd = frameEnd(m_frameIndex);
+
+  // Read one sample past the window, so that whether the window reaches the end of the source is known
+  fill(m_windowEnd + 1);
+  *samples = m_ring.data() + m_windowStart % m_capacity;
+  *numSamples = static_cast<uint32_t>(m_windowEnd - m_windowStart);
+  return !WindowIsPastEnd() || m_extend == kExtendSilence;
+}
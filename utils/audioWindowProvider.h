@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <vector>
+
+class CWaveFileStream;
+
+// Hands out the window of audio that goes with each video frame, from a source that is read sequentially, in
+// chunks, into a ring buffer. The window of frame n is the samples [floor(n * R / F), floor((n + 1) * R / F)), for
+// the sample rate R and the rational frame rate F, so no error accumulates from floating-point timestamps. Windows
+// follow the output frame count, not the position in the video, so they stay continuous when the video is looped
+// forwards or backwards to match the length of the audio.
+// Once the source ends, windows are filled with silence; whether they are handed out is up to the extend mode.
+// No memory is allocated after Init().
+class CAudioWindowProvider {
+ public:
+  // What to do once the audio has ended.
+  enum ExtendMode {
+    kExtendNone,     // Stop handing out windows
+    kExtendSilence,  // Keep handing out windows of silence
+  };
+
+  // Read up to count consecutive samples into dst, returning the number read; fewer means the source has ended.
+  typedef std::function<uint32_t(float* dst, uint32_t count)> ReadProc;
+
+  CAudioWindowProvider() = default;
+
+  // Start providing windows from a source, at the given frame rate, numerator / denominator frames per second.
+  // Returns false if a rate is 0.
+  bool Init(ReadProc source, uint32_t sampleRate, uint32_t fpsNum, uint32_t fpsDen, ExtendMode extend);
+  // Start providing windows from a WAV file stream, already in the expected format.
+  bool Init(const CWaveFileStream* stream, uint32_t fpsNum, uint32_t fpsDen, ExtendMode extend);
+
+  // Express a frame rate as a fraction: integer rates over 1, NTSC rates over 1001, and anything else over 1000.
+  static void FrameRateToRational(double fps, uint32_t* num, uint32_t* den);
+
+  // Advance to the window of the next frame. The samples remain valid until the next call.
+  // Returns false once the window lies beyond the end of the audio, unless the audio is extended with silence.
+  bool NextFrame(float** samples, uint32_t* numSamples);
+
+  // Whether the current window lies wholly beyond the end of the audio.
+  bool WindowIsPastEnd() const { return m_sourceEnded && m_windowStart >= m_sourceEnd; }
+  // Whether the current window reaches the end of the audio, or beyond.
+  bool WindowReachesEnd() const { return m_sourceEnded && m_windowEnd >= m_sourceEnd; }
+
+  uint64_t GetFrameIndex() const { return m_frameIndex; }  // Of the current window, once NextFrame() has been called
+  uint64_t GetWindowStart() const { return m_windowStart; }
+  uint32_t GetMaxWindowSize() const { return m_maxWindow; }
+
+ private:
+  uint64_t frameEnd(uint64_t frame) const { return (frame + 1) * m_sampleRate * m_fpsDen / m_fpsNum; }
+  void fill(uint64_t end);
+
+  static const uint32_t kChunkSamples = 4096;  // Read from the source at a time
+
+  ReadProc m_source;
+  ExtendMode m_extend = kExtendNone;
+  uint64_t m_sampleRate = 0, m_fpsNum = 0, m_fpsDen = 0;
+  uint32_t m_maxWindow = 0;
+  uint32_t m_capacity = 0;       // Of the ring, not counting its mirror
+  std::vector<float> m_ring;     // m_capacity samples, followed by a copy of the first m_maxWindow
+  uint64_t m_writePos = 0;       // The number of samples put into the ring
+  bool m_sourceEnded = false;
+  uint64_t m_sourceEnd = 0;      // The number of samples in the source, once it has ended
+  uint64_t m_frameIndex = 0;
+  uint64_t m_windowStart = 0, m_windowEnd = 0;
+  bool m_started = false;
+};
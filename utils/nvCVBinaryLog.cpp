@@ -0,0 +1,386 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "nvCVBinaryLog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#ifdef _ENABLE_LOG_COMPRESSION
+#include <zlib.h>
+#endif  // _ENABLE_LOG_COMPRESSION
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// The binary log format.                                                                       ///
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const char BinaryLog::kMagic[8] = {'N', 'V', 'C', 'V', 'B', 'L', 'O', 'G'};
+const uint32_t BinaryLog::kVersion;
+const uint32_t BinaryLog::kByteOrderMark;
+const size_t BinaryLog::kHeaderSize;
+const size_t BinaryLog::kRecordHeaderSize;
+const unsigned BinaryLog::kLevelNone;
+
+template <typename T>
+static void Put(std::string* buf, T value) {
+  buf->append((const char*)&value, sizeof(value));
+}
+
+template <typename T>
+static T Get(const char*& p) {
+  T value;
+  memcpy(&value, p, sizeof(value));
+  p += sizeof(value);
+  return value;
+}
+
+static bool IsDigit(char c) { return '0' <= c && c <= '9'; }
+
+bool BinaryLog::ParseFormat(const char* fmt, std::vector<Conversion>* conv) {
+  conv->clear();
+  for (const char* s = fmt; *s; ++s) {
+    if ('%' != *s) continue;
+    Conversion c;
+    c.begin = s - fmt;
+    c.numStars = 0;
+    c.precision = -1;
+    if ('%' == *++s) continue;                     // "%%" is a literal '%'
+    while (*s && strchr("-+ #0'", *s)) ++s;        // Flags
+    if ('*' == *s) {                               // Width from an argument
+      ++c.numStars;
+      ++s;
+    } else {
+      while (IsDigit(*s)) ++s;                     // Width
+      if ('$' == *s) return false;                 // Positional arguments cannot be fetched in order
+    }
+    if ('.' == *s) {                               // Precision
+      if ('*' == *++s) {
+        ++c.numStars;
+        c.precision = -2;
+        ++s;
+      } else {
+        for (c.precision = 0; IsDigit(*s); ++s) c.precision = c.precision * 10 + (*s - '0');
+      }
+    }
+    char len0 = 0, len1 = 0;                       // Length modifier
+    if (*s && strchr("hljztL", *s)) {
+      len0 = *s++;
+      if (('h' == len0 || 'l' == len0) && len0 == *s) len1 = *s++;
+    }
+    switch (*s) {
+      case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+        if ('c' == *s && len0) return false;      // Wide characters
+        switch (len0) {
+          case 'l': c.type = len1 ? kArgLongLong : kArgLong; break;
+          case 'j': c.type = kArgIntMax;                    break;
+          case 'z': c.type = kArgSize;                      break;
+          case 't': c.type = kArgPtrDiff;                   break;
+          case 'L': return false;
+          default:  c.type = kArgInt;                       break;  // Including char and short
+        }
+        break;
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        c.type = ('L' == len0) ? kArgLongDouble : kArgDouble;
+        break;
+      case 's':
+        if (len0) return false;                   // Wide strings
+        c.type = kArgString;
+        break;
+      case 'p':
+        c.type = kArgPointer;
+        break;
+      default:                                    // %n, or something we do not recognize
+        return false;
+    }
+    c.end = s + 1 - fmt;
+    conv->push_back(c);
+  }
+  return true;
+}
+
+void BinaryLog::AppendFileHeader(std::string* buf) {
+  buf->append(kMagic, sizeof(kMagic));
+  Put<uint32_t>(buf, kVersion);
+  Put<uint32_t>(buf, kByteOrderMark);
+}
+
+void BinaryLog::AppendFormatRecord(std::string* buf, uint32_t id, const std::string& fmt) {
+  Put<uint32_t>(buf, (uint32_t)(kRecordHeaderSize + sizeof(id) + fmt.size()));
+  Put<uint8_t>(buf, kRecordFormat);
+  Put<uint32_t>(buf, id);
+  buf->append(fmt);
+}
+
+void BinaryLog::AppendEventRecord(std::string* buf, unsigned level, uint32_t formatId,
+                                  const std::vector<Conversion>& conv, va_list args) {
+  size_t start = buf->size();
+  Put<uint32_t>(buf, 0);  // The size is filled in below
+  Put<uint8_t>(buf, kRecordEvent);
+  Put<uint8_t>(buf, (uint8_t)level);
+  Put<uint32_t>(buf, ThreadId());
+  Put<uint64_t>(buf, Timestamp());
+  Put<uint32_t>(buf, formatId);
+  va_list ap;
+  va_copy(ap, args);
+  for (const Conversion& c : conv) {
+    int star = 0;
+    for (unsigned i = 0; i < c.numStars; ++i) Put<int32_t>(buf, star = va_arg(ap, int));
+    switch (c.type) {
+      case kArgInt:        Put<int32_t>(buf, va_arg(ap, int));                          break;
+      case kArgLong:       Put<int64_t>(buf, va_arg(ap, long));                         break;
+      case kArgLongLong:   Put<int64_t>(buf, va_arg(ap, long long));                    break;
+      case kArgIntMax:     Put<int64_t>(buf, va_arg(ap, intmax_t));                     break;
+      case kArgSize:       Put<int64_t>(buf, (int64_t)va_arg(ap, size_t));             break;
+      case kArgPtrDiff:    Put<int64_t>(buf, va_arg(ap, ptrdiff_t));                    break;
+      case kArgDouble:     Put<double>(buf, va_arg(ap, double));                        break;
+      case kArgLongDouble: Put<double>(buf, (double)va_arg(ap, long double));           break;
+      case kArgPointer:    Put<uint64_t>(buf, (uint64_t)(uintptr_t)va_arg(ap, void*));  break;
+      case kArgString: {
+        const char* str = va_arg(ap, const char*);
+        int precision = (-2 == c.precision) ? star : c.precision;  // A negative star precision means none
+        size_t n = 0;
+        if (!str) str = "(null)";
+        if (precision < 0) n = strlen(str);
+        else while (n < (size_t)precision && str[n]) ++n;           // Do not read past the precision
+        Put<uint32_t>(buf, (uint32_t)n);
+        buf->append(str, n);
+      } break;
+    }
+  }
+  va_end(ap);
+  uint32_t size = (uint32_t)(buf->size() - start);
+  memcpy(&(*buf)[start], &size, sizeof(size));
+}
+
+uint32_t BinaryLog::ThreadId() {
+  static std::atomic<uint32_t> numThreads(0);
+  static thread_local uint32_t id = ++numThreads;
+  return id;
+}
+
+uint64_t BinaryLog::Timestamp() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// A reader of binary log files.                                                                ///
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Format one conversion, with its width and precision arguments, if any.
+template <typename T>
+static int FormatConversion(char* dst, size_t size, const char* spec, const int* stars, unsigned numStars, T value) {
+  switch (numStars) {
+    case 0:
+      return snprintf(dst, size, spec, value);
+    case 1:
+      return snprintf(dst, size, spec, stars[0], value);
+    default:
+      return snprintf(dst, size, spec, stars[0], stars[1], value);
+  }
+}
+
+/// Append one conversion, with its width and precision arguments, if any.
+template <typename T>
+static void AppendConversion(std::string* text, const char* spec, const int* stars, unsigned numStars, T value) {
+  char buf[256];
+  int n = FormatConversion(buf, sizeof(buf), spec, stars, numStars, value);
+  if (n < 0) return;
+  if ((size_t)n < sizeof(buf)) {
+    text->append(buf, n);
+  } else {  // Too long for the stack buffer, so format it again directly into the string
+    size_t at = text->size();
+    text->resize(at + n + 1);
+    FormatConversion(&(*text)[at], (size_t)n + 1, spec, stars, numStars, value);
+    text->resize(at + n);  // Remove the NUL
+  }
+}
+
+/// Append literal text from a format string, replacing "%%" with "%".
+static void AppendLiteral(std::string* text, const char* s, const char* end) {
+  while (s != end) {
+    const char* pct = (const char*)memchr(s, '%', end - s);
+    if (!pct) pct = end;
+    text->append(s, pct - s);
+    if (pct == end) break;
+    text->push_back('%');
+    s = pct + 2;
+  }
+}
+
+bool BinaryLogReader::Render(const Format& fmt, const char* p, const char* end, std::string* text) {
+  const char* f = fmt.text.c_str();
+  size_t pos = 0;
+  std::string spec;
+  text->clear();
+  for (const BinaryLog::Conversion& c : fmt.conv) {
+    AppendLiteral(text, f + pos, f + c.begin);
+    pos = c.end;
+    int stars[2] = {0, 0};
+    if ((size_t)(end - p) < c.numStars * sizeof(int32_t)) return false;
+    for (unsigned i = 0; i < c.numStars; ++i) stars[i] = Get<int32_t>(p);
+
+    // Rewrite the length modifier for the recorded width of the argument
+    char conv = f[c.end - 1];
+    size_t specEnd = c.end - 1;
+    while (strchr("hljztL", f[specEnd - 1])) --specEnd;
+    spec.assign(f + c.begin, specEnd - c.begin);
+    switch (c.type) {
+      case BinaryLog::kArgInt:
+        if ((size_t)(end - p) < sizeof(int32_t)) return false;
+        spec.assign(f + c.begin, c.end - c.begin);  // Keep any hh or h, which truncate as they did originally
+        AppendConversion(text, spec.c_str(), stars, c.numStars, Get<int32_t>(p));
+        break;
+      case BinaryLog::kArgLong:
+      case BinaryLog::kArgLongLong:
+      case BinaryLog::kArgIntMax:
+      case BinaryLog::kArgSize:
+      case BinaryLog::kArgPtrDiff:
+        if ((size_t)(end - p) < sizeof(int64_t)) return false;
+        spec += "ll";
+        spec += conv;
+        if (strchr("di", conv))
+          AppendConversion(text, spec.c_str(), stars, c.numStars, (long long)Get<int64_t>(p));
+        else
+          AppendConversion(text, spec.c_str(), stars, c.numStars, (unsigned long long)Get<int64_t>(p));
+        break;
+      case BinaryLog::kArgDouble:
+      case BinaryLog::kArgLongDouble:
+        if ((size_t)(end - p) < sizeof(double)) return false;
+        spec += conv;
+        AppendConversion(text, spec.c_str(), stars, c.numStars, Get<double>(p));
+        break;
+      case BinaryLog::kArgPointer:
+        if ((size_t)(end - p) < sizeof(uint64_t)) return false;
+        spec += conv;
+        AppendConversion(text, spec.c_str(), stars, c.numStars, (void*)(uintptr_t)Get<uint64_t>(p));
+        break;
+      case BinaryLog::kArgString: {
+        if ((size_t)(end - p) < sizeof(uint32_t)) return false;
+        uint32_t n = Get<uint32_t>(p);
+        if ((size_t)(end - p) < n) return false;
+        std::string str(p, n);
+        p += n;
+        spec += conv;
+        AppendConversion(text, spec.c_str(), stars, c.numStars, str.c_str());
+      } break;
+    }
+  }
+  AppendLiteral(text, f + pos, f + fmt.text.size());
+  return p == end;
+}
+
+NvCV_Status BinaryLogReader::open(const char* file) {
+  char buf[1 << 16];
+  bool readErr;
+  m_data.clear();
+  m_pos = 0;
+  m_status = NVCV_SUCCESS;
+#ifdef _ENABLE_LOG_COMPRESSION
+  gzFile fd = gzopen(file, "rb");  // This reads uncompressed files as well as those compressed after rotation
+  if (!fd) return (m_status = NVCV_ERR_FILE);
+  int n;
+  while ((n = gzread(fd, buf, sizeof(buf))) > 0) m_data.insert(m_data.end(), buf, buf + n);
+  readErr = (n < 0);
+  if (readErr && !m_data.empty()) readErr = false;  // Decode what we can of a truncated compressed file
+  gzclose(fd);
+#else   // _ENABLE_LOG_COMPRESSION
+  FILE* fd = nullptr;
+#ifndef _MSC_VER
+  fd = fopen(file, "rb");
+#else   // _MSC_VER
+  fopen_s(&fd, file, "rb");
+#endif  // _MSC_VER
+  if (!fd) return (m_status = NVCV_ERR_FILE);
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), fd)) > 0) m_data.insert(m_data.end(), buf, buf + n);
+  readErr = ferror(fd) != 0;
+  fclose(fd);
+#endif  // _ENABLE_LOG_COMPRESSION
+  if (readErr) return (m_status = NVCV_ERR_FILE);
+
+  if (m_data.size() < BinaryLog::kHeaderSize || memcmp(m_data.data(), BinaryLog::kMagic, sizeof(BinaryLog::kMagic)))
+    return (m_status = NVCV_ERR_PARSE);  // Not a binary log
+  const char* p = m_data.data() + sizeof(BinaryLog::kMagic);
+  uint32_t version = Get<uint32_t>(p);
+  uint32_t byteOrder = Get<uint32_t>(p);
+  if (version != BinaryLog::kVersion || byteOrder != BinaryLog::kByteOrderMark)
+    return (m_status = NVCV_ERR_PARSE);  // Written by a newer version or on a machine with a different byte order
+  m_pos = BinaryLog::kHeaderSize;
+  return NVCV_SUCCESS;
+}
+
+bool BinaryLogReader::next(Event* ev) {
+  while (m_pos < m_data.size() && NVCV_SUCCESS == m_status) {
+    const char* p = m_data.data() + m_pos;
+    size_t avail = m_data.size() - m_pos;
+    uint32_t size = 0;
+    if (avail >= sizeof(size)) memcpy(&size, p, sizeof(size));
+    if (avail < BinaryLog::kRecordHeaderSize || size < BinaryLog::kRecordHeaderSize || size > avail) {
+      m_status = NVCV_ERR_PARSE;  // Most likely the last record was cut short
+      break;
+    }
+    const char* end = p + size;
+    p += sizeof(size);
+    uint8_t type = Get<uint8_t>(p);
+    m_pos += size;
+    switch (type) {
+      case BinaryLog::kRecordFormat: {
+        if (end - p < (ptrdiff_t)sizeof(uint32_t)) {
+          m_status = NVCV_ERR_PARSE;
+          return false;
+        }
+        Format& fmt = m_formats[Get<uint32_t>(p)];
+        fmt.text.assign(p, end);
+        if (!BinaryLog::ParseFormat(fmt.text.c_str(), &fmt.conv))  // The writer records such messages as "%s" ...
+          fmt.conv.clear();                                      // ... so this should not happen
+      } break;
+      case BinaryLog::kRecordEvent: {
+        if (end - p < (ptrdiff_t)(sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t))) {
+          m_status = NVCV_ERR_PARSE;
+          return false;
+        }
+        ev->level = Get<uint8_t>(p);
+        ev->threadId = Get<uint32_t>(p);
+        ev->timestamp = Get<uint64_t>(p);
+        ev->formatId = Get<uint32_t>(p);
+        auto it = m_formats.find(ev->formatId);
+        char note[64];
+        if (m_formats.end() == it) {
+          snprintf(note, sizeof(note), "<unknown format %u>", ev->formatId);
+          ev->text = note;
+        } else if (!Render(it->second, p, end, &ev->text)) {
+          snprintf(note, sizeof(note), "<arguments do not match format %u>", ev->formatId);
+          ev->text = note;
+        }
+        return true;
+      }
+      default:  // Skip records of types added after this was written
+        break;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __NVCV_BINARY_LOG__
+#define __NVCV_BINARY_LOG__
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "nvCVStatus.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// The binary log format.                                                                       ///
+/// Rather than formatting each message, the writer records the raw printf arguments, tagged     ///
+/// with the id of the format string, which is itself written only once per file:                ///
+///   file header:    char magic[8] = "NVCVBLOG", uint32 version, uint32 byte order mark         ///
+///   every record:   uint32 size (including these 5 bytes), uint8 type                          ///
+///   format record:  uint32 id, char text[]                                                     ///
+///   event record:   uint8 level, uint32 thread, uint64 time (ns since 1970), uint32 format id, ///
+///                   then the arguments: 4 bytes for int, 8 for other integers, doubles and     ///
+///                   pointers, and uint32 length + chars for strings.                           ///
+/// Values are in the byte order of the writer. Each file starts with all formats known when it ///
+/// was opened, so every file of a rotated log can be decoded on its own.                        ///
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class BinaryLog {
+ public:
+  static const char kMagic[8];                        ///< The first bytes of every binary log file.
+  static const uint32_t kVersion = 1;                 ///< The version of the format.
+  static const uint32_t kByteOrderMark = 0x01020304;  ///< Written natively, to detect the byte order.
+  static const size_t kHeaderSize = 16;               ///< The size of the file header.
+  static const size_t kRecordHeaderSize = 5;          ///< The size of the header common to all records.
+  static const unsigned kLevelNone = 255;             ///< The level of messages that came without one.
+
+  /// The types of records.
+  enum RecordType {
+    kRecordFormat = 1,  ///< Defines a format string.
+    kRecordEvent = 2,   ///< A logged message.
+  };
+
+  /// The types of arguments, as they need to be fetched from a va_list.
+  enum ArgType {
+    kArgInt,         ///< int, or anything promoted to it (4 bytes).
+    kArgLong,        ///< long (8 bytes).
+    kArgLongLong,    ///< long long (8 bytes).
+    kArgIntMax,      ///< intmax_t (8 bytes).
+    kArgSize,        ///< size_t (8 bytes).
+    kArgPtrDiff,     ///< ptrdiff_t (8 bytes).
+    kArgDouble,      ///< double, or float promoted to it (8 bytes).
+    kArgLongDouble,  ///< long double, recorded as a double (8 bytes).
+    kArgString,      ///< const char*, recorded as its characters (4 + length bytes).
+    kArgPointer,     ///< void* (8 bytes).
+  };
+
+  /// A conversion specification in a format string.
+  struct Conversion {
+    size_t begin, end;  ///< The span of the specification in the format string, from the '%'.
+    unsigned numStars;  ///< The number of '*' widths and precisions, each of which takes an int argument.
+    int precision;      ///< The precision, or -1 if there is none, or -2 if it is given by an argument.
+    ArgType type;       ///< The type of the converted argument.
+  };
+
+  /// Parse a printf format string.
+  /// @param[in]  fmt   the format string.
+  /// @param[out] conv  the conversion specifications, in order; "%%" is not included.
+  /// @return true  if all of the conversions can be recorded in binary;
+  ///         false if any cannot, such as %n, %ls, %lc or positional arguments.
+  static bool ParseFormat(const char* fmt, std::vector<Conversion>* conv);
+
+  /// Append the file header.
+  /// @param[in,out]  buf   the buffer to append to.
+  static void AppendFileHeader(std::string* buf);
+
+  /// Append a format record.
+  /// @param[in,out]  buf   the buffer to append to.
+  /// @param[in]      id    the id of the format string.
+  /// @param[in]      fmt   the format string.
+  static void AppendFormatRecord(std::string* buf, uint32_t id, const std::string& fmt);
+
+  /// Append an event record.
+  /// Strings are recorded up to their precision, if any, so they need not be NUL-terminated.
+  /// @param[in,out]  buf       the buffer to append to.
+  /// @param[in]      level     the log level.
+  /// @param[in]      formatId  the id of the format string.
+  /// @param[in]      conv      the conversions in the format string, as returned by ParseFormat().
+  /// @param[in]      args      the arguments to the conversions.
+  static void AppendEventRecord(std::string* buf, unsigned level, uint32_t formatId,
+                                const std::vector<Conversion>& conv, va_list args);
+
+  /// @return a small number identifying the calling thread, assigned in the order that threads first log.
+  static uint32_t ThreadId();
+
+  /// @return the current time, in nanoseconds since 1970.
+  static uint64_t Timestamp();
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// A reader of binary log files, rendering each message back into text.                         ///
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class BinaryLogReader {
+ public:
+  /// A decoded message.
+  struct Event {
+    unsigned level;      ///< The log level, or BinaryLog::kLevelNone.
+    uint32_t threadId;   ///< The id of the thread that logged it.
+    uint64_t timestamp;  ///< The time, in nanoseconds since 1970.
+    uint32_t formatId;   ///< The id of the format string.
+    std::string text;    ///< The formatted message.
+  };
+
+  /// Open a binary log file and read its header.
+  /// When compiled with _ENABLE_LOG_COMPRESSION, files compressed with gzip can be read as well.
+  /// @param[in]  file  the file to read.
+  /// @return NVCV_SUCCESS if successful,
+  ///         NVCV_ERR_FILE  if the file could not be read,
+  ///         NVCV_ERR_PARSE if it is not a binary log file of a supported version and byte order.
+  NvCV_Status open(const char* file);
+
+  /// Read the next message.
+  /// @param[out] ev  the message.
+  /// @return true if a message was read, false at the end of the file or if the file is corrupt; see status().
+  bool next(Event* ev);
+
+  /// @return NVCV_SUCCESS if the whole file has been read, or NVCV_ERR_PARSE if reading stopped at corrupt data,
+  ///         such as a truncated last record.
+  NvCV_Status status() const { return m_status; }
+
+  /// @return the offset into the file of the next record to be read.
+  size_t offset() const { return m_pos; }
+
+ private:
+  /// A format string, with its conversions.
+  struct Format {
+    std::string text;                         ///< The format string.
+    std::vector<BinaryLog::Conversion> conv;  ///< Its conversions.
+  };
+
+  /// Render the arguments of an event with its format.
+  /// @param[in]  fmt   the format.
+  /// @param[in]  p     the recorded arguments.
+  /// @param[in]  end   the end of the recorded arguments.
+  /// @param[out] text  the rendered message.
+  /// @return true if successful, false if the arguments do not match the format.
+  static bool Render(const Format& fmt, const char* p, const char* end, std::string* text);
+
+  std::vector<char> m_data;                        ///< The contents of the file.
+  size_t m_pos = 0;                                ///< The offset of the next record.
+  NvCV_Status m_status = NVCV_SUCCESS;             ///< Why reading stopped.
+  std::unordered_map<uint32_t, Format> m_formats;  ///< The format strings, by id.
+};
+
+#endif  // __NVCV_BINARY_LOG__
@@ -23,7 +23,20 @@
 
 #include "nvCVLoggerExamples.h"
 
+#include <stddef.h>
 #include <string.h>
+#include <sys/stat.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#else   // _MSC_VER
+#include <io.h>
+#endif  // _MSC_VER
+#ifdef _ENABLE_LOG_COMPRESSION
+#include <zlib.h>
+#endif  // _ENABLE_LOG_COMPRESSION
+
+#include <algorithm>
+#include <chrono>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 /// A logger class that records all log records in a C++ string.                                 ///
@@ -205,30 +218,197 @@ MultifileLogger::~MultifileLogger() {
   log(nullptr);  // A NULL log message is a signal to shut down
 }
 
-NvCV_Status MultifileLogger::openLogFile(unsigned index) {
+std::string MultifileLogger::logFileName(unsigned index) const {
   std::string file;
-  std::unique_lock<std::mutex> lock(m_mutex);
-  m_currIndex = index % m_numFiles;
   file.resize(1024);
-  int n = snprintf(&file[0], 1, m_fileProto.c_str(), m_currIndex) + 1;
+  int n = snprintf(&file[0], 1, m_fileProto.c_str(), index) + 1;
   file.resize(n);
-  n = snprintf(&file[0], n, m_fileProto.c_str(), m_currIndex);
+  n = snprintf(&file[0], n, m_fileProto.c_str(), index);
   file.resize(n);  // This should be 1 character smaller now
+  return file;
+}
+
+static size_t FileSize(const std::string& file) {
+#ifndef _MSC_VER
+  struct stat st;
+  return stat(file.c_str(), &st) ? 0 : (size_t)st.st_size;
+#else   // _MSC_VER
+  struct _stat64 st;
+  return _stat64(file.c_str(), &st) ? 0 : (size_t)st.st_size;
+#endif  // _MSC_VER
+}
+
+static void SyncFile(FILE* fd) {
+#ifndef _MSC_VER
+  (void)fsync(fileno(fd));
+#else   // _MSC_VER
+  (void)_commit(_fileno(fd));
+#endif  // _MSC_VER
+}
+
+NvCV_Status MultifileLogger::openLogFile(unsigned index) {
+  // The clients only need m_mutex to log, so it is held just long enough to read the settings that they may change,
+  // and never across the file system calls below
+  std::unique_lock<std::mutex> fileLock(m_fileMutex);
+  bool sync;
+  int compressLevel;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    sync = m_sync;
+    compressLevel = m_compressLevel;
+  }
+  unsigned prevIndex = m_currIndex;
+  m_currIndex = index % m_numFiles;
+  std::string file = logFileName(m_currIndex);
   if (m_fd) {      // If a file was already open, ...
     fflush(m_fd);  // ... flush any unwritten data
+    if (sync) SyncFile(m_fd);
     fclose(m_fd);
     m_fd = nullptr;
+    if (compressLevel && prevIndex != m_currIndex) {  // Hand the file that we just closed over, ...
+      std::unique_lock<std::mutex> qlock(m_compressMutex);
+      m_compressQueue.push_back(CompressJob{prevIndex, logFileName(prevIndex), compressLevel});
+      qlock.unlock();
+      m_compressCond.notify_one();  // ... to be compressed in the background
+    }
   }
+  cancelCompression(m_currIndex);        // We are about to overwrite this file (waiting if it is being compressed) ...
+  (void)remove((file + ".gz").c_str());  // ... so a compressed one from the previous time around is stale
 #ifndef _MSC_VER
   m_fd = fopen(file.c_str(), "wb");  // ... open it
 #else                                // _MSC_VER
-  n = fopen_s(&m_fd, file.c_str(), "wb");  // ... open it as binary to prevent Windows from adding CR
+  fopen_s(&m_fd, file.c_str(), "wb");  // ... open it as binary to prevent Windows from adding CR
 #endif                               // _MSC_VER
-  m_currSize = 0;
+  size_t headerSize = 0;
+  if (m_fd) {
+    std::string header;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      makeFileHeader(&header);
+    }
+    headerSize = fwrite(header.data(), 1, header.size(), m_fd);
+    // Flush, so that a full disk shows up here, not in the records; a file whose header is cut short is unreadable,
+    // so no records are written into it
+    if (headerSize != header.size() || (!header.empty() && 0 != fflush(m_fd))) {
+      fclose(m_fd);
+      m_fd = nullptr;
+      (void)remove(file.c_str());
+      headerSize = 0;
+    }
+  }
+  m_currSize = m_headerSize = headerSize;
+  if (m_diskBudget) enforceDiskBudget();
   // if (!m_fd) fprintf(stderr, "Failed to open logfile \"%s\"\n", file.c_str());
   return m_fd ? NVCV_SUCCESS : NVCV_ERR_FILE;
 }
 
+void MultifileLogger::enforceDiskBudget() {
+  std::vector<size_t> sizes(m_numFiles);
+  std::vector<bool> pending(m_numFiles, false);
+  size_t total = m_maxSize;  // Leave room for the current file to grow
+  {
+    std::unique_lock<std::mutex> lock(m_compressMutex);
+    for (const CompressJob& job : m_compressQueue) pending[job.index] = true;
+    if (m_compressing >= 0) pending[m_compressing] = true;
+  }
+  for (unsigned i = 1; i < m_numFiles; ++i) {  // Every file but the current one, starting with the oldest
+    unsigned index = (m_currIndex + i) % m_numFiles;
+    std::string file = logFileName(index);
+    total += (sizes[i] = FileSize(file) + FileSize(file + ".gz"));
+  }
+  // Files waiting to be compressed will soon shrink, so delete older compressed files first
+  for (int pass = 0; pass < 2; ++pass) {
+    for (unsigned i = 1; i < m_numFiles && total > m_diskBudget; ++i) {
+      unsigned index = (m_currIndex + i) % m_numFiles;
+      if (!sizes[i] || (!pass && pending[index])) continue;
+      std::string file = logFileName(index);
+      cancelCompression(index);
+      (void)remove(file.c_str());
+      (void)remove((file + ".gz").c_str());
+      total -= sizes[i];
+      sizes[i] = 0;
+    }
+  }
+}
+
+void MultifileLogger::cancelCompression(unsigned index) {
+  std::unique_lock<std::mutex> lock(m_compressMutex);
+  for (auto it = m_compressQueue.begin(); it != m_compressQueue.end();)
+    it = (it->index == index) ? m_compressQueue.erase(it) : it + 1;
+  m_compressCond.wait(lock, [&] { return m_compressing != (int)index; });
+}
+
+void MultifileLogger::compressor() {
+  std::unique_lock<std::mutex> lock(m_compressMutex);
+  while (1) {  // Keep looking for work until asked to stop, then finish what is left
+    m_compressCond.wait(lock, [this] { return !m_compressQueue.empty() || !m_compressRun; });
+    if (m_compressQueue.empty()) return;
+    CompressJob job = m_compressQueue.front();
+    m_compressQueue.pop_front();
+    m_compressing = (int)job.index;
+    lock.unlock();
+#ifdef _ENABLE_LOG_COMPRESSION
+    std::string gzName = job.file + ".gz";
+    char mode[4] = {'w', 'b', (char)('0' + job.level), 0};
+    FILE* in = nullptr;
+#ifndef _MSC_VER
+    in = fopen(job.file.c_str(), "rb");
+#else   // _MSC_VER
+    fopen_s(&in, job.file.c_str(), "rb");
+#endif  // _MSC_VER
+    gzFile out = in ? gzopen(gzName.c_str(), mode) : nullptr;
+    if (out) {
+      std::vector<char> buf(1 << 16);
+      bool ok = true;
+      size_t n;
+      while (ok && (n = fread(buf.data(), 1, buf.size(), in)) > 0)
+        ok = (gzwrite(out, buf.data(), (unsigned)n) == (int)n);
+      ok = !ferror(in) && (Z_OK == gzclose(out)) && ok;
+      (void)remove(ok ? job.file.c_str() : gzName.c_str());  // Keep the uncompressed file if anything went wrong
+    }
+    if (in) fclose(in);
+#endif  // _ENABLE_LOG_COMPRESSION
+    lock.lock();
+    m_compressing = -1;
+    m_compressCond.notify_all();  // Let anyone waiting for this file know that we are done with it
+  }
+}
+
+NvCV_Status MultifileLogger::setCompression(int level) {
+  if (level < 0 || level > 9) return NVCV_ERR_PARAMETER;
+#ifndef _ENABLE_LOG_COMPRESSION
+  if (level) return NVCV_ERR_UNIMPLEMENTED;
+#endif  // _ENABLE_LOG_COMPRESSION
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_compressLevel = level;
+  if (level && !m_compressThread.joinable()) {
+    m_compressRun = true;
+    m_compressThread = std::thread(&Compressor, this);
+  }
+  return NVCV_SUCCESS;
+}
+
+void MultifileLogger::setFlushInterval(unsigned milliseconds, bool sync) {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_flushInterval = std::chrono::milliseconds(milliseconds);
+    m_sync = sync;
+  }
+  m_cond.notify_one();  // Wake up the thread so it starts using the new interval
+}
+
+void MultifileLogger::setDiskBudget(size_t bytes) {
+  std::unique_lock<std::mutex> lock(m_fileMutex);
+  m_diskBudget = bytes;
+  if (m_diskBudget && m_fd) enforceDiskBudget();
+}
+
+void MultifileLogger::flushLogFile() {
+  if (!m_fd) return;
+  fflush(m_fd);
+  if (m_sync) SyncFile(m_fd);
+}
+
 NvCV_Status MultifileLogger::init(const char* proto, size_t max_size, unsigned num_files, unsigned first) {
   m_fileProto = proto;  // TODO: assure that this has one %d, %i or %u
   m_maxSize = max_size;
@@ -237,14 +417,18 @@ NvCV_Status MultifileLogger::init(const char* proto, size_t max_size, unsigned n
 }
 
 MultifileLogger::MultifileLogger()
-    : m_fd(nullptr), m_run(true), m_maxSize(0), m_numFiles(0), m_currIndex(0), m_currSize(0) {
+    : m_fd(nullptr), m_run(true), m_maxSize(0), m_numFiles(0), m_currIndex(0), m_currSize(0),
+      m_headerSize(0), m_flushInterval(0), m_sync(false), m_diskBudget(0), m_compressLevel(0), m_compressing(-1),
+      m_compressRun(false) {
   m_buf[0].reserve(2000);  // Pre-allocate buffer space so the threads don't need to
   m_buf[1].reserve(2000);
   m_thread = std::thread(&Worker, this);
 }
 
 MultifileLogger::MultifileLogger(const char* proto, size_t max_size, unsigned num_files, unsigned first)
-    : m_fd(nullptr), m_run(true), m_maxSize(0), m_numFiles(0), m_currIndex(0), m_currSize(0) {
+    : m_fd(nullptr), m_run(true), m_maxSize(0), m_numFiles(0), m_currIndex(0), m_currSize(0),
+      m_headerSize(0), m_flushInterval(0), m_sync(false), m_diskBudget(0), m_compressLevel(0), m_compressing(-1),
+      m_compressRun(false) {
   m_buf[0].reserve(2000);  // Pre-allocate buffer space so the threads don't need to
   m_buf[1].reserve(2000);
   NvCV_Status err =
@@ -253,32 +437,40 @@ MultifileLogger::MultifileLogger(const char* proto, size_t max_size, unsigned nu
   m_thread = std::thread(&Worker, this);
 }
 
+size_t MultifileLogger::fitRecords(const char* buf, size_t size, size_t room) const {
+  const char *s, *send;
+  if (room > size) room = size;
+  for (s = (send = buf - 1) + room; s != send; --s)
+    if ('\n' == *s) return s - send;  // Make sure to write complete lines
+  return 0;
+}
+
 void MultifileLogger::writeBuffer(const char* buf, size_t size) {
   NvCV_Status err;
+  if (!m_fd) {  // The last file could not be opened, or its header written, so try it again
+    err = openLogFile(m_currIndex);
+    if (NVCV_SUCCESS != err) return;
+  }
   if (m_currSize >= m_maxSize) {
     err = openLogFile(m_currIndex + 1);
     if (NVCV_SUCCESS != err) return;
   }
   while ((m_currSize + size) > m_maxSize) {
-    const char *s, *send;
-    for (s = (send = buf - 1) + m_maxSize - m_currSize; s != send; --s) {
-      if ('\n' == *s) {  // Make sure to write complete lines
-        size_t z = s - send;
-        (void)fwrite(buf, 1, z, m_fd);  // TODO: check the returned value -- but what can we do?
-        buf += z;
-        size -= z;
-        m_currSize += z;
-        err = openLogFile(m_currIndex + 1);  // TODO: check the returned value -- but what could we do?
-        if (NVCV_SUCCESS != err) return;
-        break;
-      }
+    size_t z = fitRecords(buf, size, m_maxSize - m_currSize);
+    if (z) {
+      (void)fwrite(buf, 1, z, m_fd);  // TODO: check the returned value -- but what can we do?
+      buf += z;
+      size -= z;
+      m_currSize += z;
+      err = openLogFile(m_currIndex + 1);  // TODO: check the returned value -- but what could we do?
+      if (NVCV_SUCCESS != err) return;
+      continue;                            // Continue splitting until less than m_maxSize to write.
     }
-    if (send != s) continue;               // Continue splitting until less than m_maxSize to write.
-    if (m_currSize) {                      // Can't find a line short enough to write, ...
+    if (m_currSize > m_headerSize) {       // Can't find a record short enough to write, ...
       err = openLogFile(m_currIndex + 1);  // ... so open up a new empty file ...
       if (NVCV_SUCCESS != err) return;
-      continue;  // ... and write at least one line the next time through
-    } else {     // Can't write even one line into an empty file without exceeding the file size (uncommon)
+      continue;  // ... and write at least one record the next time through
+    } else {     // Can't write even one record into an empty file without exceeding the file size (uncommon)
       (void)fwrite(buf, 1, size, m_fd);  // Write the whole buffer anyway
       m_currSize += size;
       // openLogFile(m_currIndex + 1);       // This is covered by the first statement in this function
@@ -292,16 +484,30 @@ void MultifileLogger::writeBuffer(const char* buf, size_t size) {
 }
 
 void MultifileLogger::worker() {
-  while (1) {  // Keep looking for work until asked to stop
+  std::chrono::steady_clock::time_point lastFlush = std::chrono::steady_clock::now();
+  std::chrono::milliseconds interval;
+  bool dirty = false;  // There is data that has not been flushed
+  while (1) {          // Keep looking for work until asked to stop
     {
       std::unique_lock<std::mutex> lock(m_mutex);
-      if (!m_run) return;             // Exit if no longer running
-      m_cond.wait(lock);              // Wait around until there is something to do
+      if (!m_run) return;  // Exit if no longer running
+      interval = m_flushInterval;
+      if (dirty && interval.count())
+        m_cond.wait_until(lock, lastFlush + interval);  // Wait until there is something to do or it is time to flush
+      else
+        m_cond.wait(lock);            // Wait around until there is something to do
       std::swap(m_buf[0], m_buf[1]);  // The worker gets exclusive access to m_buf[1]
+      interval = m_flushInterval;
     }
     if (m_buf[1].size()) {                            // This might be 0 when asked to stop
       writeBuffer(m_buf[1].data(), m_buf[1].size());  // TODO: check the returned value
       m_buf[1].clear();                               // Empty the buffer so the clients can use it
+      dirty = true;
+    }
+    if (dirty && interval.count() && std::chrono::steady_clock::now() - lastFlush >= interval) {
+      flushLogFile();
+      lastFlush = std::chrono::steady_clock::now();
+      dirty = false;
     }
   }
 }
@@ -314,18 +520,359 @@ void MultifileLogger::log(const char* msg) {
     }
     m_cond.notify_one();  // Wake up the thread to print it
   } else {                // NULL msg is a signal to finish
+    shutdown();
+  }
+}
+
+void MultifileLogger::shutdown() {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_run = 0;  // Tell the thread to quit
+  }
+  m_cond.notify_all();                       // Wake up the thread
+  if (m_thread.joinable()) m_thread.join();  // and wait until it exits
+  if (m_fd) {
+    if (m_buf[0].size())                              // If there is any residual unwritten data, ...
+      writeBuffer(m_buf[0].data(), m_buf[0].size());  // ... write it
+    m_buf[0].clear();
+    flushLogFile();                                   // Flush it
+    if (m_fd != stderr) fclose(m_fd);                 // Close the file as long as it is not stderr
+    m_fd = nullptr;
+  }
+  {
+    std::unique_lock<std::mutex> lock(m_compressMutex);
+    m_compressRun = false;  // Tell the compressor to quit once it has compressed all of the rotated files
+  }
+  m_compressCond.notify_all();
+  if (m_compressThread.joinable()) m_compressThread.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Binary Multifile Logger.                                                                     ///
+/// This can be instantiated once and supplied several times as a callback to several SDKs.      ///
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+BinaryMultifileLogger::~BinaryMultifileLogger() {
+  shutdown();  // While our overrides are still in place to write the residual data
+}
+
+BinaryMultifileLogger::BinaryMultifileLogger() : MultifileLogger(), m_textFormatId(0) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_textFormatId = internFormat("%s");
+}
+
+BinaryMultifileLogger::BinaryMultifileLogger(const char* proto, size_t max_size, unsigned num_files, unsigned first)
+    : BinaryMultifileLogger() {
+  (void)init(proto, max_size, num_files, first);  // Here rather than in the base, so our header gets written
+}
+
+uint32_t BinaryMultifileLogger::internFormat(const char* fmt) {
+  auto it = m_formatsByAddr.find(fmt);
+  if (m_formatsByAddr.end() != it && m_formats[it->second].text == fmt) return it->second;  // The usual case
+  auto tt = m_formatsByText.find(fmt);
+  if (m_formatsByText.end() != tt) {  // Same text at a new address, or new text at an old address
+    m_formatsByAddr[fmt] = tt->second;
+    return tt->second;
+  }
+  uint32_t id = (uint32_t)m_formats.size();
+  m_formats.push_back(Format());
+  Format& f = m_formats.back();
+  f.text = fmt;
+  f.binary = BinaryLog::ParseFormat(fmt, &f.conv);
+  m_formatsByAddr[fmt] = id;
+  m_formatsByText[f.text] = id;
+  if (f.binary) BinaryLog::AppendFormatRecord(&m_buf[0], id, f.text);  // Define it before its first use
+  return id;
+}
+
+void BinaryMultifileLogger::appendEvent(unsigned level, uint32_t formatId, ...) {
+  va_list args;
+  va_start(args, formatId);
+  BinaryLog::AppendEventRecord(&m_buf[0], level, formatId, m_formats[formatId].conv, args);
+  va_end(args);
+}
+
+void BinaryMultifileLogger::vlogf(unsigned level, const char* fmt, va_list args) {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);  // Assure exclusive access to the buffer and the formats
+    uint32_t id = internFormat(fmt);
+    if (m_formats[id].binary) {
+      BinaryLog::AppendEventRecord(&m_buf[0], level, id, m_formats[id].conv, args);
+    } else {  // Format it here, without holding the lock
+      lock.unlock();
+      va_list ap;
+      va_copy(ap, args);
+      int n = vsnprintf(nullptr, 0, fmt, ap);
+      va_end(ap);
+      std::string text(n > 0 ? n + 1 : 1, '\0');
+      if (n > 0) (void)vsnprintf(&text[0], text.size(), fmt, args);
+      text.resize(n > 0 ? n : 0);
+      lock.lock();
+      appendEvent(level, m_textFormatId, text.c_str());
+    }
+  }
+  m_cond.notify_one();  // Wake up the thread to write it
+}
+
+void BinaryMultifileLogger::logf(unsigned level, const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  vlogf(level, fmt, args);
+  va_end(args);
+}
+
+void BinaryMultifileLogger::log(const char* msg) {
+  if (msg) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);  // Assure exclusive access to the buffer
+      appendEvent(BinaryLog::kLevelNone, m_textFormatId, msg);
+    }
+    m_cond.notify_one();  // Wake up the thread to write it
+  } else {                // NULL msg is a signal to finish
+    shutdown();
+  }
+}
+
+size_t BinaryMultifileLogger::fitRecords(const char* buf, size_t size, size_t room) const {
+  size_t z = 0;
+  uint32_t n;
+  if (room > size) room = size;
+  while (z + sizeof(n) <= room) {  // Records are appended whole, so each one is complete in the buffer
+    memcpy(&n, buf + z, sizeof(n));
+    if (z + n > room) break;
+    z += n;
+  }
+  return z;
+}
+
+void BinaryMultifileLogger::makeFileHeader(std::string* header) {
+  BinaryLog::AppendFileHeader(header);
+  for (uint32_t id = 0; id < (uint32_t)m_formats.size(); ++id)  // So that each file can be decoded on its own
+    if (m_formats[id].binary) BinaryLog::AppendFormatRecord(header, id, m_formats[id].text);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Ring buffer logger.                                                                          ///
+/// This can be instantiated once and supplied several times as a callback to several SDKs.      ///
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const unsigned RingBufferLogger::kDefaultNumSlots;
+const unsigned RingBufferLogger::kDefaultSlotSize;
+
+static const size_t kRingBatchSize = 1 << 16;                   // Write to the file in chunks of about this size
+static const std::chrono::milliseconds kRingIdleTimeout(100);  // Backstop against a missed wake-up
+
+RingBufferLogger::~RingBufferLogger() {
+  log(nullptr);  // A NULL log message is a signal to shut down
+}
+
+RingBufferLogger::RingBufferLogger(OverflowPolicy policy, unsigned numSlots, unsigned slotSize)
+    : m_mask(0), m_slotSize(0), m_enqueuePos(0), m_dequeuePos(0), m_policy(policy), m_numDropped(0),
+      m_numBlocks(0), m_numDroppedReported(0), m_numWaiting(0), m_writerIdle(false), m_run(true), m_fd(stderr) {
+  start(numSlots, slotSize);
+}
+
+RingBufferLogger::RingBufferLogger(const char* file, const char* mode, OverflowPolicy policy, unsigned numSlots,
+                                   unsigned slotSize)
+    : m_mask(0), m_slotSize(0), m_enqueuePos(0), m_dequeuePos(0), m_policy(policy), m_numDropped(0),
+      m_numBlocks(0), m_numDroppedReported(0), m_numWaiting(0), m_writerIdle(false), m_run(true), m_fd(nullptr) {
+  (void)init(file, mode);  // init will have already squawked if the file could not be opened
+  start(numSlots, slotSize);
+}
+
+void RingBufferLogger::start(unsigned numSlots, unsigned slotSize) {
+  size_t n;
+  for (n = 2; n < numSlots; n <<= 1) {}  // Round up to a power of 2 so that positions can be masked
+  m_mask = n - 1;
+  m_slotSize = slotSize ? slotSize : kDefaultSlotSize;
+  m_slots.reset(new Slot[n]);
+  m_data.reset(new char[n * m_slotSize]);  // Pre-allocate all message space so that clients never need to
+  for (size_t i = 0; i < n; ++i) {
+    m_slots[i].seq.store(i, std::memory_order_relaxed);
+    m_slots[i].size = 0;
+  }
+  m_thread = std::thread(&Worker, this);
+}
+
+NvCV_Status RingBufferLogger::init(const char* file, const char* mode) {
+  NvCV_Status err = NVCV_SUCCESS;
+  std::unique_lock<std::mutex> lock(m_fileMutex);     // Keep the writer away while we reconfigure
+  if (m_fd) {                                         // If a file was already open, ...
+    fflush(m_fd);                                     // ... flush any unwritten data
+    if (m_fd != stderr) {                             // For normal file output (not stderr), ...
+      if (file && !strcmp(file, m_fileName.c_str()))  // ... if the currently open file is the same as the new one
+        return NVCV_SUCCESS;  // ... no need to close and reopen (so different loggers can share)
+      fclose(m_fd);           // Otherwise it is a different file so we close it ..
+    }
+    m_fd = nullptr;  // ... and forget it
+  }
+  m_fileName.clear();  // Forget any previously opened file
+  if (file) {          // If we want to start logging to a regular file, ...
+#ifndef _MSC_VER
+    m_fd = fopen(file, (mode ? mode : "w"));  // ... open it
+#else                                         // _MSC_VER
+    fopen_s(&m_fd, file, (mode ? mode : "w"));  // ... open it
+#endif                                        // _MSC_VER
+    if (m_fd) {                               // If we were successful opening the file, ...
+      m_fileName = file;                      // ... remember it
+    } else {                                  // Otherwise, we failed to open the file
+      err = NVCV_ERR_FILE;                    // We indicate an error
+      m_fd = stderr;                          // Use the stderr instead, so we can report somewhere
+    }
+  } else {          // Otherwise, we want to start logging to stderr
+    m_fd = stderr;  // So we make it happen!
+  }
+  return err;
+}
+
+bool RingBufferLogger::ready() const {
+  return m_slots[m_dequeuePos & m_mask].seq.load(std::memory_order_acquire) == m_dequeuePos + 1;
+}
+
+bool RingBufferLogger::drain(std::string& batch) {
+  bool any = false;
+  while (batch.size() < kRingBatchSize) {
+    Slot& slot = m_slots[m_dequeuePos & m_mask];
+    if (slot.seq.load(std::memory_order_acquire) != m_dequeuePos + 1)  // Not yet published
+      break;
+    batch.append(&m_data[(m_dequeuePos & m_mask) * m_slotSize], slot.size);
+    slot.seq.store(m_dequeuePos + m_mask + 1, std::memory_order_release);  // Free it for the next lap
+    ++m_dequeuePos;
+    any = true;
+  }
+  if (any) {  // Let any waiting clients know that there is room now
+    std::atomic_thread_fence(std::memory_order_seq_cst);  // Pairs with the fence in log()
+    if (m_numWaiting.load(std::memory_order_relaxed)) {
+      { std::unique_lock<std::mutex> lock(m_mutex); }
+      m_roomCond.notify_all();
+    }
+  }
+  return any;
+}
+
+void RingBufferLogger::writeBatch(std::string& batch) {
+  unsigned long long numDropped = m_numDropped.load(std::memory_order_relaxed);
+  std::unique_lock<std::mutex> lock(m_fileMutex);
+  if (m_fd) {
+    if (numDropped != m_numDroppedReported) {  // Note the gap where it happened
+      fprintf(m_fd, "RingBufferLogger: %llu messages dropped\n", numDropped - m_numDroppedReported);
+      m_numDroppedReported = numDropped;
+    }
+    size_t written = batch.size() ? fwrite(batch.data(), 1, batch.size(), m_fd) : 0;
+    if (written < batch.size()) {  // The messages that did not make it are counted as dropped, and reported later
+      size_t lost = std::count(batch.begin() + written, batch.end(), '\n') + ('\n' != batch.back());
+      m_numDropped.fetch_add(lost, std::memory_order_relaxed);
+    }
+  }
+  batch.clear();  // Empty the buffer so the worker can use it again
+}
+
+void RingBufferLogger::worker() {
+  std::string batch;
+  batch.reserve(kRingBatchSize + m_slotSize);  // Pre-allocate buffer space so the thread doesn't need to
+  while (1) {                                  // Keep looking for work until asked to stop
+    bool run = m_run.load(std::memory_order_acquire);  // Sample this before draining, so nothing is left behind
+    if (drain(batch)) {
+      writeBatch(batch);
+      continue;
+    }
+    if (!run) return;  // Exit if no longer running and there is nothing left to write
     {
+      std::unique_lock<std::mutex> lock(m_fileMutex);
+      if (m_fd) fflush(m_fd);  // Flush when the clients have gone quiet
+    }
+    m_writerIdle.store(true, std::memory_order_seq_cst);  // Announce that we are about to sleep, ...
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!ready()) {  // ... then make sure that no message slipped in beforehand
       std::unique_lock<std::mutex> lock(m_mutex);
-      m_run = 0;  // Tell the thread to quit
+      m_writerCond.wait_for(lock, kRingIdleTimeout, [this] {
+        return !m_writerIdle.load(std::memory_order_relaxed) || !m_run.load(std::memory_order_relaxed);
+      });
     }
-    m_cond.notify_all();                       // Wake up the thread
+    m_writerIdle.store(false, std::memory_order_relaxed);
+  }
+}
+
+void RingBufferLogger::log(const char* msg) {
+  if (!msg) {  // NULL msg is a signal to finish
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_run.store(false, std::memory_order_release);  // Tell the thread to quit
+    }
+    m_writerCond.notify_all();  // Wake up the thread, ...
+    m_roomCond.notify_all();    // ... and any clients waiting for it
     if (m_thread.joinable()) m_thread.join();  // and wait until it exits
+    std::string batch;
+    drain(batch);  // Pick up anything published while the thread was exiting
+    writeBatch(batch);
+    std::unique_lock<std::mutex> lock(m_fileMutex);
     if (m_fd) {
-      if (m_buf[0].size())                              // If there is any residual unwritten data, ...
-        writeBuffer(m_buf[0].data(), m_buf[0].size());  // ... write it
-      fflush(m_fd);                                     // Flush it
-      if (m_fd != stderr) fclose(m_fd);                 // Close the file as long as it is not stderr
+      fflush(m_fd);                      // Flush it
+      if (m_fd != stderr) fclose(m_fd);  // Close the file as long as it is not stderr
       m_fd = nullptr;
+      m_fileName.clear();
     }
+    return;
+  }
+
+  if (!m_run.load(std::memory_order_relaxed)) {  // Nobody is listening any more
+    m_numDropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  size_t size = strlen(msg);
+  if (!size) return;
+  size_t numSlots = (size + m_slotSize - 1) / m_slotSize;  // Long messages occupy consecutive slots
+  if (numSlots > m_mask + 1) {                             // Truncate anything larger than the whole ring
+    numSlots = m_mask + 1;
+    size = numSlots * m_slotSize;
+  }
+
+  // Claim numSlots consecutive slots. The writer frees slots in order, so if the last one is free, they all are.
+  size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+  while (1) {
+    size_t last = pos + numSlots - 1;
+    size_t seq = m_slots[last & m_mask].seq.load(std::memory_order_acquire);
+    ptrdiff_t dif = (ptrdiff_t)(seq - last);
+    if (dif == 0) {  // Free: try to claim it
+      if (m_enqueuePos.compare_exchange_weak(pos, pos + numSlots, std::memory_order_relaxed)) break;
+    } else if (dif > 0) {  // Another client got there first
+      pos = m_enqueuePos.load(std::memory_order_relaxed);
+    } else if (kOverflowDrop == m_policy.load(std::memory_order_relaxed)) {  // Full
+      m_numDropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {  // Full, so wait for the writer to make some room
+      m_numBlocks.fetch_add(1, std::memory_order_relaxed);
+      m_numWaiting.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);  // Pairs with the fence in drain()
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_roomCond.wait_for(lock, kRingIdleTimeout, [&] {
+          return (ptrdiff_t)(m_slots[last & m_mask].seq.load(std::memory_order_acquire) - last) >= 0 ||
+                 !m_run.load(std::memory_order_relaxed);
+        });
+      }
+      m_numWaiting.fetch_sub(1, std::memory_order_relaxed);
+      if (!m_run.load(std::memory_order_relaxed)) {
+        m_numDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      pos = m_enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Fill and publish the slots in order, so the writer can start on the first while we copy the rest.
+  for (size_t i = 0; i < numSlots; ++i, ++pos, msg += m_slotSize, size -= m_slotSize) {
+    Slot& slot = m_slots[pos & m_mask];
+    slot.size = (unsigned)(size < m_slotSize ? size : m_slotSize);
+    memcpy(&m_data[(pos & m_mask) * m_slotSize], msg, slot.size);
+    slot.seq.store(pos + 1, std::memory_order_release);
+    if (size < m_slotSize) break;
+  }
+
+  // Only wake the writer if it has gone to sleep; otherwise it will pick this up in its current batch.
+  std::atomic_thread_fence(std::memory_order_seq_cst);  // Pairs with the fence in worker()
+  if (m_writerIdle.load(std::memory_order_relaxed) && m_writerIdle.exchange(false, std::memory_order_relaxed)) {
+    { std::unique_lock<std::mutex> lock(m_mutex); }
+    m_writerCond.notify_one();
   }
 }
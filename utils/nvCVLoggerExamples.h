@@ -24,13 +24,21 @@
 #ifndef __NVCVLOGGER_EXAMPLES__
 #define __NVCVLOGGER_EXAMPLES__
 
+#include <stdarg.h>
 #include <stdio.h>
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
+#include "nvCVBinaryLog.h"
 #include "nvCVStatus.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -171,7 +179,7 @@ class FileThreadLogger {
 class MultifileLogger {
  public:
   /// Destructor
-  ~MultifileLogger();
+  virtual ~MultifileLogger();
 
   /// Default constructor
   MultifileLogger();
@@ -192,9 +200,28 @@ class MultifileLogger {
   /// @return NVCV_SUCCESS if successful, NVCV_ERR_FILE if not.
   NvCV_Status init(const char* proto, size_t max_size, unsigned num_files, unsigned first = 0);
 
+  /// Compress each file with gzip, in a background thread, once the log has rotated away from it.
+  /// The compressed file is named after the log file, with ".gz" appended, and replaces it.
+  /// This requires zlib, and the code to be compiled with _ENABLE_LOG_COMPRESSION defined.
+  /// @param[in]  level   the zlib compression level, from 1 (fastest) to 9 (smallest), or 0 to not compress.
+  /// @return NVCV_SUCCESS if successful,
+  ///         NVCV_ERR_PARAMETER      if the level is out of range,
+  ///         NVCV_ERR_UNIMPLEMENTED  if compression was not compiled in.
+  NvCV_Status setCompression(int level);
+
+  /// Flush the log to the file periodically, rather than whenever the stdio buffer fills.
+  /// @param[in]  milliseconds  the longest that a message may wait to be flushed, or 0 to rely on stdio buffering.
+  /// @param[in]  sync          also ask the OS to commit the file to disk (fsync) each time it is flushed.
+  void setFlushInterval(unsigned milliseconds, bool sync = false);
+
+  /// Limit the total size of all of the files of the log, raw and compressed, including room for the current one
+  /// to grow to its maximum size. The oldest files are deleted to stay within the budget, each time a file is opened.
+  /// @param[in]  bytes   the budget, or 0 for no limit other than the number of files.
+  void setDiskBudget(size_t bytes);
+
   /// Log method for this C++ class.
   /// @param[in]  msg   The message to be appended to the log.
-  void log(const char* msg);
+  virtual void log(const char* msg);
 
   /// C-style callback function, for the logger.
   /// @param[in,out]  userData  a pointer that will point to this instantiation.
@@ -204,15 +231,45 @@ class MultifileLogger {
     mfl->log(msg);
   }
 
- private:
+ protected:
   /// @param[in]  index  Open the log file with the specified index.
   NvCV_Status openLogFile(unsigned index);
 
-  /// Write buffer
+  /// Write buffer, splitting it between files at record boundaries so that no file exceeds the maximum size.
   /// @param[in]  buf   The buffer.
   /// @param[in]  size  The number of bytes in the buffer to write.
   void writeBuffer(const char* buf, size_t size);
 
+  /// Find how much of a buffer can be written to the current file.
+  /// @param[in]  buf   The buffer.
+  /// @param[in]  size  The number of bytes in the buffer.
+  /// @param[in]  room  The number of bytes that can still be written to the current file.
+  /// @return the number of bytes of the whole records (here, lines) at the start of the buffer that fit in the room.
+  virtual size_t fitRecords(const char* buf, size_t size, size_t room) const;
+
+  /// Make whatever a new file needs before any records. This is called with m_mutex locked; the header is written
+  /// after it is released.
+  /// @param[out] header  a place to append the header to.
+  virtual void makeFileHeader(std::string* header) { (void)header; }
+
+  /// Stop the worker thread, write any residual data and close the file.
+  /// Subclasses that override the virtual methods above should call this from their destructor.
+  void shutdown();
+
+  /// @param[in]  index  the index of a log file.
+  /// @return the name of the log file with the specified index.
+  std::string logFileName(unsigned index) const;
+
+  /// Flush the current file, and commit it to disk if requested by setFlushInterval().
+  void flushLogFile();
+
+  /// Delete the oldest files until the log fits within the disk budget. This is called with m_fileMutex locked.
+  void enforceDiskBudget();
+
+  /// Make sure that the compressor leaves a file alone: remove it from the queue, or wait until it is done.
+  /// @param[in]  index  the index of the log file.
+  void cancelCompression(unsigned index);
+
   /// Worker to be spawned off to another thread.
   void worker();
 
@@ -223,17 +280,252 @@ class MultifileLogger {
     mfl->worker();
   }
 
+  /// Compressor to be spawned off to another thread.
+  void compressor();
+
+  /// C-style compressor, to be employed by the thread.
+  /// @param[in,out]  userData  a pointer that will point to this instantiation.
+  static void Compressor(void* userData) {
+    MultifileLogger* mfl = (MultifileLogger*)userData;
+    mfl->compressor();
+  }
+
+  /// A file waiting to be compressed.
+  struct CompressJob {
+    unsigned index;    ///< The index of the log file.
+    std::string file;  ///< The name of the log file.
+    int level;         ///< The zlib compression level.
+  };
+
   FILE* m_fd;                      ///< The file descriptor.
   std::string m_fileProto;         ///< The prototype for the log files.
   std::string m_buf[2];            ///< Buffer 0 is used by the clients, buffer 1 is used by the worker thread.
   std::thread m_thread;            ///< The thread of the worker.
   std::mutex m_mutex;              ///< The mutex.
   std::condition_variable m_cond;  ///< The condition variable.
+  std::mutex m_fileMutex;          ///< Serializes opening files with setDiskBudget(), but not logging; before m_mutex.
   unsigned m_numFiles;             ///< The number of file to be used in the log.
   size_t m_maxSize;                ///< The maximum size of each file.
   size_t m_currSize;               ///< The current size of the current file.
+  size_t m_headerSize;             ///< The size of the header of the current file.
   unsigned m_currIndex;            ///< The index of the current file.
   bool m_run;                      ///< A signal to tell the worker thread when to stop.
+
+  std::chrono::milliseconds m_flushInterval;  ///< How often to flush the file, or 0 to leave it to stdio.
+  bool m_sync;                                ///< Commit the file to disk whenever it is flushed.
+  size_t m_diskBudget;                        ///< The limit on the size of the files, or 0 for none (m_fileMutex).
+  int m_compressLevel;                        ///< The zlib level to compress rotated files, or 0 for none.
+  std::thread m_compressThread;               ///< The thread of the compressor.
+  std::mutex m_compressMutex;                 ///< The mutex for the compression queue; taken after m_mutex.
+  std::condition_variable m_compressCond;     ///< Signals changes to the compression queue.
+  std::deque<CompressJob> m_compressQueue;    ///< The files waiting to be compressed.
+  int m_compressing;                          ///< The index of the file being compressed, or -1 if none.
+  bool m_compressRun;                         ///< A signal to tell the compressor thread when to stop.
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Binary multifile logger.                                                                     ///
+/// Rather than text, this records the format string id and the raw arguments of each message,   ///
+/// in the format described in nvCVBinaryLog.h, so that nothing is formatted while logging.      ///
+/// The files are rotated just as MultifileLogger does, and rendered back into text offline by   ///
+/// BinaryLogDecoderApp or BinaryLogReader.                                                      ///
+/// This can be instantiated once and supplied several times as a callback to several SDKs.      ///
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class BinaryMultifileLogger : public MultifileLogger {
+ public:
+  /// Destructor
+  ~BinaryMultifileLogger();
+
+  /// Default constructor
+  BinaryMultifileLogger();
+
+  /// File initialization constructor
+  /// @param[in]  proto     the prototype file to use for logging.
+  /// @param[in]  max_size  the maximum size per each file.
+  /// @param[in]  num_files the number of files to be used for the log.
+  /// @param[in]  first     the index of the first file to be written.
+  BinaryMultifileLogger(const char* proto, size_t max_size, unsigned num_files, unsigned first = 0);
+
+  /// Log a message. Only the id of the format and the arguments are recorded.
+  /// The format is remembered by its address, so it should usually be a string literal; formats that change
+  /// at the same address are detected, but cost a string comparison per message.
+  /// @param[in]  level   the log level: 0 (fatal), 1 (error), 2 (warning), or 3 (info).
+  /// @param[in]  fmt     the printf format string. Formats that cannot be recorded in binary, e.g. with %n or %ls,
+  ///                     are formatted and recorded as text.
+  void logf(unsigned level, const char* fmt, ...);
+
+  /// Log a message, as logf() does, with a va_list.
+  /// @param[in]  level   the log level.
+  /// @param[in]  fmt     the printf format string.
+  /// @param[in]  args    the arguments.
+  void vlogf(unsigned level, const char* fmt, va_list args);
+
+  /// Log a preformatted message, such as from an SDK, with no level.
+  /// @param[in]  msg   The message to be appended to the log; NULL shuts the logger down.
+  void log(const char* msg) override;
+
+  /// C-style callback function, for the logger.
+  /// @param[in,out]  userData  a pointer that will point to this instantiation.
+  /// @param[in]      msg       the message to be appended to the log.
+  static void Callback(void* userData, const char* msg) {
+    BinaryMultifileLogger* bml = (BinaryMultifileLogger*)userData;
+    bml->log(msg);
+  }
+
+ protected:
+  size_t fitRecords(const char* buf, size_t size, size_t room) const override;
+  void makeFileHeader(std::string* header) override;
+
+ private:
+  /// A format string that has been assigned an id.
+  struct Format {
+    std::string text;                         ///< The format string.
+    std::vector<BinaryLog::Conversion> conv;  ///< Its conversions.
+    bool binary;                              ///< The arguments can be recorded in binary.
+  };
+
+  /// Look up the format string, assigning it an id and queuing its definition the first time.
+  /// This is called with m_mutex locked.
+  /// @param[in]  fmt   the format string.
+  /// @return the id of the format string.
+  uint32_t internFormat(const char* fmt);
+
+  /// Append an event record, with the arguments given directly. This is called with m_mutex locked.
+  void appendEvent(unsigned level, uint32_t formatId, ...);
+
+  std::vector<Format> m_formats;                              ///< The format strings, by id.
+  std::unordered_map<const char*, uint32_t> m_formatsByAddr;  ///< The ids of format strings, by address.
+  std::unordered_map<std::string, uint32_t> m_formatsByText;  ///< The ids of format strings, by contents.
+  uint32_t m_textFormatId;                                    ///< The id of "%s", for messages logged as text.
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+/// A threaded file logger whose clients never take a lock in the common case.                   ///
+/// Messages are copied into a bounded ring of preallocated slots, which multiple threads claim  ///
+/// with a single compare-and-swap; a writer thread drains the ring in batches. When the ring is ///
+/// full, messages are either dropped (and counted) or the client waits, depending on the policy.///
+/// This can be instantiated once and supplied several times as a callback to several SDKs:      ///
+///   NvAR_ConfigureLogger(level, nullptr, RingBufferLogger::Callback, &logger);                 ///
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class RingBufferLogger {
+ public:
+  /// What to do with a message when there is no room for it in the ring.
+  enum OverflowPolicy {
+    kOverflowDrop,   ///< Discard the message and count it; logging never blocks.
+    kOverflowBlock,  ///< Wait until the writer thread has made room; no message is lost.
+  };
+
+  static const unsigned kDefaultNumSlots = 1024;  ///< The default number of slots in the ring.
+  static const unsigned kDefaultSlotSize = 256;   ///< The default number of bytes per slot.
+
+  /// Destructor
+  ~RingBufferLogger();
+
+  /// Constructor, logging to stderr.
+  /// @param[in]  policy    what to do when the ring is full.
+  /// @param[in]  numSlots  the number of slots in the ring, rounded up to a power of 2.
+  /// @param[in]  slotSize  the number of bytes in each slot; longer messages occupy consecutive slots.
+  RingBufferLogger(OverflowPolicy policy = kOverflowDrop, unsigned numSlots = kDefaultNumSlots,
+                   unsigned slotSize = kDefaultSlotSize);
+
+  /// File initialization constructor
+  /// @param[in]  file      the file to use for logging.
+  /// @param[in]  mode      "w" or "a" (NULL implies "w").
+  /// @param[in]  policy    what to do when the ring is full.
+  /// @param[in]  numSlots  the number of slots in the ring, rounded up to a power of 2.
+  /// @param[in]  slotSize  the number of bytes in each slot; longer messages occupy consecutive slots.
+  RingBufferLogger(const char* file, const char* mode = nullptr, OverflowPolicy policy = kOverflowDrop,
+                   unsigned numSlots = kDefaultNumSlots, unsigned slotSize = kDefaultSlotSize);
+
+  /// Initialization
+  /// This can be called more than once, in which case it should flush the old one then open the new one
+  /// @param[in]  file  the file to use for logging, or NULL for stderr.
+  /// @param[in]  mode  "w" or "a" (NULL implies "w").
+  /// @return NVCV_SUCCESS if successful, NVCV_ERR_FILE if not.
+  NvCV_Status init(const char* file, const char* mode = nullptr);
+
+  /// Change the overflow policy; this may be called while other threads are logging.
+  /// @param[in]  policy  what to do when the ring is full.
+  void setOverflowPolicy(OverflowPolicy policy) { m_policy.store(policy, std::memory_order_relaxed); }
+
+  /// Log method for this C++ class.
+  /// @param[in]  msg   The message to be appended to the log; NULL flushes the log and stops the writer thread.
+  void log(const char* msg);
+
+  /// @return the number of messages that have been dropped because the ring was full, or after shutdown.
+  unsigned long long numDropped() const { return m_numDropped.load(std::memory_order_relaxed); }
+
+  /// @return the number of times that a client had to wait for room in the ring.
+  unsigned long long numBlocked() const { return m_numBlocks.load(std::memory_order_relaxed); }
+
+  /// C-style callback function, for the logger.
+  /// @param[in,out]  userData  a pointer that will point to this instantiation.
+  /// @param[in]      msg       the message to be appended to the log.
+  static void Callback(void* userData, const char* msg) {
+    RingBufferLogger* rbl = (RingBufferLogger*)userData;
+    rbl->log(msg);
+  }
+
+ private:
+  RingBufferLogger(const RingBufferLogger&) = delete;
+  RingBufferLogger& operator=(const RingBufferLogger&) = delete;
+
+  /// A slot in the ring. Its sequence number is equal to its position when it is free, one more than its position
+  /// when it holds a message, and is advanced by the ring size when the writer thread has consumed it.
+  struct Slot {
+    std::atomic<size_t> seq;  ///< The sequence number.
+    unsigned size;            ///< The number of bytes of the message in this slot.
+  };
+
+  /// Allocate the ring and start the writer thread.
+  void start(unsigned numSlots, unsigned slotSize);
+
+  /// Move all published messages from the ring into the batch, freeing their slots.
+  /// @param[in,out]  batch  the batch to be appended to.
+  /// @return true if any message was moved.
+  bool drain(std::string& batch);
+
+  /// @return true if the writer thread has a message waiting for it.
+  bool ready() const;
+
+  /// Write the batch to the file, prefixed by a note of any messages that were dropped since the last one.
+  /// @param[in,out]  batch  the batch to be written; it will be cleared.
+  void writeBatch(std::string& batch);
+
+  /// Worker to be spawned off to another thread.
+  void worker();
+
+  /// C-style worker, to be employed by the thread.
+  /// @param[in,out]  userData  a pointer that will point to this instantiation.
+  static void Worker(void* userData) {
+    RingBufferLogger* rbl = (RingBufferLogger*)userData;
+    rbl->worker();
+  }
+
+  std::unique_ptr<Slot[]> m_slots;                ///< The ring of slots.
+  std::unique_ptr<char[]> m_data;                 ///< The message bytes, slotSize per slot.
+  size_t m_mask;                                  ///< The number of slots minus one.
+  unsigned m_slotSize;                            ///< The number of bytes per slot.
+  char m_pad0[64];                                ///< Keep the producers' position on its own cache line.
+  std::atomic<size_t> m_enqueuePos;               ///< The position of the next slot to be claimed by a client.
+  char m_pad1[64];                                ///< Keep the writer's position on its own cache line.
+  size_t m_dequeuePos;                            ///< The position of the next slot to be consumed by the writer.
+  std::atomic<OverflowPolicy> m_policy;           ///< What to do when the ring is full.
+  std::atomic<unsigned long long> m_numDropped;   ///< The number of messages dropped.
+  std::atomic<unsigned long long> m_numBlocks;    ///< The number of times a client waited for room.
+  unsigned long long m_numDroppedReported;        ///< The number of dropped messages already noted in the log.
+  std::atomic<unsigned> m_numWaiting;             ///< The number of clients currently waiting for room.
+  std::atomic<bool> m_writerIdle;                 ///< The writer thread is (about to be) waiting for messages.
+  std::atomic<bool> m_run;                        ///< A signal to tell the worker thread when to stop.
+  FILE* m_fd;                                     ///< The file descriptor.
+  std::string m_fileName;                         ///< The name of the currently file open for logging.
+  std::thread m_thread;                           ///< The thread of the worker.
+  std::mutex m_fileMutex;                         ///< Serializes writing with reconfiguration.
+  std::mutex m_mutex;                             ///< The mutex for the condition variables; not used to log.
+  std::condition_variable m_writerCond;           ///< Wakes the writer thread when it is idle.
+  std::condition_variable m_roomCond;             ///< Wakes clients waiting for room in the ring.
 };
 
 #endif  // __NVCVLOGGER_EXAMPLES__
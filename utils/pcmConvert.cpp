@@ -0,0 +1,570 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pcmConvert.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PCM_SSE2_SIMD
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PCM_NEON_SIMD
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+const size_t kChunkSamples = 2048;  // The number of interleaved samples converted at a time for (de)interleaving
+
+// Clamp to [-1, 1]; NaN goes to -1, as it does with SSE min and max.
+inline float ClampUnit(float x) {
+  x = x > -1.f ? x : -1.f;
+  return x < 1.f ? x : 1.f;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Scalar kernels. These also finish the samples left over by the vector kernels.
+////////////////////////////////////////////////////////////////////////////////
+
+void U8ToFloat_C(const uint8_t* src, size_t n, float* dst) {
+  for (size_t i = 0; i < n; i++) dst[i] = (int(src[i]) - 128) * (1.f / 128.f);
+}
+
+void S16ToFloat_C(const uint8_t* src, size_t n, float* dst) {
+  for (size_t i = 0; i < n; i++, src += 2) {
+    int16_t s;
+    memcpy(&s, src, sizeof(s));
+    dst[i] = s * (1.f / 32768.f);
+  }
+}
+
+void S24ToFloat_C(const uint8_t* src, size_t n, float* dst) {
+  for (size_t i = 0; i < n; i++, src += 3) {
+    int32_t s =
+        static_cast<int32_t>((uint32_t(src[2]) << 24) | (uint32_t(src[1]) << 16) | (uint32_t(src[0]) << 8)) >> 8;
+    dst[i] = s * (1.f / 8388608.f);
+  }
+}
+
+void S32ToFloat_C(const uint8_t* src, size_t n, float* dst) {
+  for (size_t i = 0; i < n; i++, src += 4) {
+    int32_t s;
+    memcpy(&s, src, sizeof(s));
+    dst[i] = s * (1.f / 2147483648.f);
+  }
+}
+
+void F32ToFloat(const uint8_t* src, size_t n, float* dst) { memcpy(dst, src, n * sizeof(float)); }
+
+void UnknownToFloat(const uint8_t*, size_t n, float* dst) { memset(dst, 0, n * sizeof(float)); }
+
+void FloatToU8_C(const float* src, size_t n, uint8_t* dst) {
+  for (size_t i = 0; i < n; i++) dst[i] = static_cast<uint8_t>(std::min(lrintf(ClampUnit(src[i]) * 128.f) + 128, 255L));
+}
+
+void FloatToS16_C(const float* src, size_t n, uint8_t* dst) {
+  for (size_t i = 0; i < n; i++, dst += 2) {
+    int16_t s = static_cast<int16_t>(std::min(lrintf(ClampUnit(src[i]) * 32768.f), 32767L));
+    memcpy(dst, &s, sizeof(s));
+  }
+}
+
+void FloatToS24_C(const float* src, size_t n, uint8_t* dst) {
+  for (size_t i = 0; i < n; i++, dst += 3) {
+    float x = ClampUnit(src[i]) * 8388608.f;
+    int32_t s = static_cast<int32_t>(lrintf(x < 8388607.f ? x : 8388607.f));
+    dst[0] = static_cast<uint8_t>(s);
+    dst[1] = static_cast<uint8_t>(s >> 8);
+    dst[2] = static_cast<uint8_t>(s >> 16);
+  }
+}
+
+void FloatToS32_C(const float* src, size_t n, uint8_t* dst) {
+  for (size_t i = 0; i < n; i++, dst += 4) {
+    float x = ClampUnit(src[i]) * 2147483648.f;
+    int32_t s = static_cast<int32_t>(lrintf(x < 2147483520.f ? x : 2147483520.f));  // the largest float below 2^31
+    memcpy(dst, &s, sizeof(s));
+  }
+}
+
+void FloatToF32(const float* src, size_t n, uint8_t* dst) { memcpy(dst, src, n * sizeof(float)); }
+
+void FloatToUnknown(const float*, size_t, uint8_t*) {}
+
+////////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef PCM_SSE2_SIMD
+
+void U8ToFloat_SSE2(const uint8_t* src, size_t n, float* dst) {
+  const __m128i zero = _mm_setzero_si128(), bias = _mm_set1_epi32(128);
+  const __m128 scale = _mm_set1_ps(1.f / 128.f);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+    _mm_storeu_ps(dst + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(_mm_unpacklo_epi16(lo, zero), bias)), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(_mm_unpackhi_epi16(lo, zero), bias)), scale));
+    _mm_storeu_ps(dst + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(_mm_unpacklo_epi16(hi, zero), bias)), scale));
+    _mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(_mm_unpackhi_epi16(hi, zero), bias)), scale));
+  }
+  U8ToFloat_C(src + i, n - i, dst + i);
+}
+
+void S16ToFloat_SSE2(const uint8_t* src, size_t n, float* dst) {
+  const __m128 scale = _mm_set1_ps(1.f / 32768.f);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);  // sign extend
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+    _mm_storeu_ps(dst + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+  }
+  S16ToFloat_C(src + 2 * i, n - i, dst + i);
+}
+
+void S24ToFloat_SSE2(const uint8_t* src, size_t n, float* dst) {
+  const __m128 scale = _mm_set1_ps(1.f / 8388608.f);
+  size_t i = 0;
+  for (; i + 6 <= n; i += 4) {  // 4 samples are 12 bytes, but 16 are loaded
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i));
+    __m128i s01 = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+    __m128i s23 = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+    __m128i s = _mm_srai_epi32(_mm_slli_epi32(_mm_unpacklo_epi64(s01, s23), 8), 8);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(s), scale));
+  }
+  S24ToFloat_C(src + 3 * i, n - i, dst + i);
+}
+
+void S32ToFloat_SSE2(const uint8_t* src, size_t n, float* dst) {
+  const __m128 scale = _mm_set1_ps(1.f / 2147483648.f);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+  }
+  S32ToFloat_C(src + 4 * i, n - i, dst + i);
+}
+
+// Load 4 floats, clamp them to [-1, 1] and scale them.
+inline __m128 LoadScaled_SSE2(const float* src, __m128 scale) {
+  __m128 x = _mm_max_ps(_mm_loadu_ps(src), _mm_set1_ps(-1.f));
+  return _mm_mul_ps(_mm_min_ps(x, _mm_set1_ps(1.f)), scale);
+}
+
+void FloatToU8_SSE2(const float* src, size_t n, uint8_t* dst) {
+  const __m128 scale = _mm_set1_ps(128.f);
+  const __m128i bias = _mm_set1_epi32(128);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i a = _mm_add_epi32(_mm_cvtps_epi32(LoadScaled_SSE2(src + i + 0, scale)), bias);
+    __m128i b = _mm_add_epi32(_mm_cvtps_epi32(LoadScaled_SSE2(src + i + 4, scale)), bias);
+    __m128i c = _mm_add_epi32(_mm_cvtps_epi32(LoadScaled_SSE2(src + i + 8, scale)), bias);
+    __m128i d = _mm_add_epi32(_mm_cvtps_epi32(LoadScaled_SSE2(src + i + 12, scale)), bias);
+    __m128i v = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+  }
+  FloatToU8_C(src + i, n - i, dst + i);
+}
+
+void FloatToS16_SSE2(const float* src, size_t n, uint8_t* dst) {
+  const __m128 scale = _mm_set1_ps(32768.f);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i a = _mm_cvtps_epi32(LoadScaled_SSE2(src + i + 0, scale));
+    __m128i b = _mm_cvtps_epi32(LoadScaled_SSE2(src + i + 4, scale));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), _mm_packs_epi32(a, b));
+  }
+  FloatToS16_C(src + i, n - i, dst + 2 * i);
+}
+
+void FloatToS24_SSE2(const float* src, size_t n, uint8_t* dst) {
+  const __m128 scale = _mm_set1_ps(8388608.f), top = _mm_set1_ps(8388607.f);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    int32_t s[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(s), _mm_cvtps_epi32(_mm_min_ps(LoadScaled_SSE2(src + i, scale), top)));
+    for (int k = 0; k < 4; k++) {
+      uint8_t* d = dst + 3 * (i + k);
+      d[0] = static_cast<uint8_t>(s[k]);
+      d[1] = static_cast<uint8_t>(s[k] >> 8);
+      d[2] = static_cast<uint8_t>(s[k] >> 16);
+    }
+  }
+  FloatToS24_C(src + i, n - i, dst + 3 * i);
+}
+
+void FloatToS32_SSE2(const float* src, size_t n, uint8_t* dst) {
+  const __m128 scale = _mm_set1_ps(2147483648.f), top = _mm_set1_ps(2147483520.f);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128i s = _mm_cvtps_epi32(_mm_min_ps(LoadScaled_SSE2(src + i, scale), top));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), s);
+  }
+  FloatToS32_C(src + i, n - i, dst + 4 * i);
+}
+
+#endif  // PCM_SSE2_SIMD
+
+////////////////////////////////////////////////////////////////////////////////
+// NEON kernels
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef PCM_NEON_SIMD
+
+void U8ToFloat_NEON(const uint8_t* src, size_t n, float* dst) {
+  const int32x4_t bias = vdupq_n_s32(128);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    uint8x16_t v = vld1q_u8(src + i);
+    uint16x8_t lo = vmovl_u8(vget_low_u8(v)), hi = vmovl_u8(vget_high_u8(v));
+    int32x4_t s0 = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lo))), bias);
+    int32x4_t s1 = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(lo))), bias);
+    int32x4_t s2 = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(hi))), bias);
+    int32x4_t s3 = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(hi))), bias);
+    vst1q_f32(dst + i + 0, vmulq_n_f32(vcvtq_f32_s32(s0), 1.f / 128.f));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(s1), 1.f / 128.f));
+    vst1q_f32(dst + i + 8, vmulq_n_f32(vcvtq_f32_s32(s2), 1.f / 128.f));
+    vst1q_f32(dst + i + 12, vmulq_n_f32(vcvtq_f32_s32(s3), 1.f / 128.f));
+  }
+  U8ToFloat_C(src + i, n - i, dst + i);
+}
+
+void S16ToFloat_NEON(const uint8_t* src, size_t n, float* dst) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    int16x8_t v = vreinterpretq_s16_u8(vld1q_u8(src + 2 * i));
+    vst1q_f32(dst + i + 0, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), 1.f / 32768.f));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), 1.f / 32768.f));
+  }
+  S16ToFloat_C(src + 2 * i, n - i, dst + i);
+}
+
+void S24ToFloat_NEON(const uint8_t* src, size_t n, float* dst) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    uint8x16x3_t b = vld3q_u8(src + 3 * i);  // deinterleaves the low, middle and high bytes of 16 samples
+    uint16x8_t low16[2] = {vorrq_u16(vshll_n_u8(vget_low_u8(b.val[1]), 8), vmovl_u8(vget_low_u8(b.val[0]))),
+                           vorrq_u16(vshll_n_u8(vget_high_u8(b.val[1]), 8), vmovl_u8(vget_high_u8(b.val[0])))};
+    int16x8_t high8[2] = {vmovl_s8(vreinterpret_s8_u8(vget_low_u8(b.val[2]))),
+                          vmovl_s8(vreinterpret_s8_u8(vget_high_u8(b.val[2])))};
+    for (int k = 0; k < 2; k++) {
+      int32x4_t s0 = vorrq_s32(vshll_n_s16(vget_low_s16(high8[k]), 16),
+                               vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low16[k]))));
+      int32x4_t s1 = vorrq_s32(vshll_n_s16(vget_high_s16(high8[k]), 16),
+                               vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low16[k]))));
+      vst1q_f32(dst + i + 8 * k + 0, vmulq_n_f32(vcvtq_f32_s32(s0), 1.f / 8388608.f));
+      vst1q_f32(dst + i + 8 * k + 4, vmulq_n_f32(vcvtq_f32_s32(s1), 1.f / 8388608.f));
+    }
+  }
+  S24ToFloat_C(src + 3 * i, n - i, dst + i);
+}
+
+void S32ToFloat_NEON(const uint8_t* src, size_t n, float* dst) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    int32x4_t v = vreinterpretq_s32_u8(vld1q_u8(src + 4 * i));
+    vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(v), 1.f / 2147483648.f));
+  }
+  S32ToFloat_C(src + 4 * i, n - i, dst + i);
+}
+
+// Load 4 floats, clamp them to [-1, 1] as ClampUnit() does, and scale them.
+inline float32x4_t LoadScaled_NEON(const float* src, float scale) {
+  const float32x4_t lo = vdupq_n_f32(-1.f), hi = vdupq_n_f32(1.f);
+  float32x4_t x = vld1q_f32(src);
+  x = vbslq_f32(vcgtq_f32(x, lo), x, lo);
+  x = vbslq_f32(vcltq_f32(x, hi), x, hi);
+  return vmulq_n_f32(x, scale);
+}
+
+void FloatToU8_NEON(const float* src, size_t n, uint8_t* dst) {
+  const int32x4_t bias = vdupq_n_s32(128);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    int32x4_t a = vaddq_s32(vcvtnq_s32_f32(LoadScaled_NEON(src + i + 0, 128.f)), bias);
+    int32x4_t b = vaddq_s32(vcvtnq_s32_f32(LoadScaled_NEON(src + i + 4, 128.f)), bias);
+    vst1_u8(dst + i, vqmovun_s16(vcombine_s16(vqmovn_s32(a), vqmovn_s32(b))));
+  }
+  FloatToU8_C(src + i, n - i, dst + i);
+}
+
+void FloatToS16_NEON(const float* src, size_t n, uint8_t* dst) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    int32x4_t a = vcvtnq_s32_f32(LoadScaled_NEON(src + i + 0, 32768.f));
+    int32x4_t b = vcvtnq_s32_f32(LoadScaled_NEON(src + i + 4, 32768.f));
+    vst1q_u8(dst + 2 * i, vreinterpretq_u8_s16(vcombine_s16(vqmovn_s32(a), vqmovn_s32(b))));
+  }
+  FloatToS16_C(src + i, n - i, dst + 2 * i);
+}
+
+void FloatToS24_NEON(const float* src, size_t n, uint8_t* dst) {
+  const float32x4_t top = vdupq_n_f32(8388607.f);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    int32_t s[4];
+    vst1q_s32(s, vcvtnq_s32_f32(vminq_f32(LoadScaled_NEON(src + i, 8388608.f), top)));
+    for (int k = 0; k < 4; k++) {
+      uint8_t* d = dst + 3 * (i + k);
+      d[0] = static_cast<uint8_t>(s[k]);
+      d[1] = static_cast<uint8_t>(s[k] >> 8);
+      d[2] = static_cast<uint8_t>(s[k] >> 16);
+    }
+  }
+  FloatToS24_C(src + i, n - i, dst + 3 * i);
+}
+
+void FloatToS32_NEON(const float* src, size_t n, uint8_t* dst) {
+  const float32x4_t top = vdupq_n_f32(2147483520.f);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    int32x4_t s = vcvtnq_s32_f32(vminq_f32(LoadScaled_NEON(src + i, 2147483648.f), top));
+    vst1q_u8(dst + 4 * i, vreinterpretq_u8_s32(s));
+  }
+  FloatToS32_C(src + i, n - i, dst + 4 * i);
+}
+
+#endif  // PCM_NEON_SIMD
+
+////////////////////////////////////////////////////////////////////////////////
+// Deinterleaving and downmixing
+////////////////////////////////////////////////////////////////////////////////
+
+void DeinterleaveStereo(const float* src, size_t numFrames, float* left, float* right) {
+  size_t i = 0;
+#if defined(PCM_SSE2_SIMD)
+  for (; i + 4 <= numFrames; i += 4) {
+    __m128 a = _mm_loadu_ps(src + 2 * i), b = _mm_loadu_ps(src + 2 * i + 4);
+    _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+#elif defined(PCM_NEON_SIMD)
+  for (; i + 4 <= numFrames; i += 4) {
+    float32x4x2_t v = vld2q_f32(src + 2 * i);
+    vst1q_f32(left + i, v.val[0]);
+    vst1q_f32(right + i, v.val[1]);
+  }
+#endif
+  for (; i < numFrames; i++) {
+    left[i] = src[2 * i + 0];
+    right[i] = src[2 * i + 1];
+  }
+}
+
+void DownmixStereo(const float* src, size_t numFrames, float* dst) {
+  size_t i = 0;
+#if defined(PCM_SSE2_SIMD)
+  const __m128 half = _mm_set1_ps(0.5f);
+  for (; i + 4 <= numFrames; i += 4) {
+    __m128 a = _mm_loadu_ps(src + 2 * i), b = _mm_loadu_ps(src + 2 * i + 4);
+    __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    __m128 sum = _mm_add_ps(left, right);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(sum, half));
+  }
+#elif defined(PCM_NEON_SIMD)
+  for (; i + 4 <= numFrames; i += 4) {
+    float32x4x2_t v = vld2q_f32(src + 2 * i);
+    vst1q_f32(dst + i, vmulq_n_f32(vaddq_f32(v.val[0], v.val[1]), 0.5f));
+  }
+#endif
+  for (; i < numFrames; i++) dst[i] = (src[2 * i + 0] + src[2 * i + 1]) * 0.5f;
+}
+
+void DownmixChannels(const float* src, size_t numFrames, uint32_t numChannels, float* dst) {
+  const float scale = 1.f / numChannels;
+  for (size_t i = 0; i < numFrames; i++, src += numChannels) {
+    float sum = src[0];
+    for (uint32_t c = 1; c < numChannels; c++) sum += src[c];
+    dst[i] = sum * scale;
+  }
+}
+
+}  // namespace
+
+PCMSampleFormat PCMConverter::GetSampleFormat(const waveFormat_ext& wfx) {
+  if (!wfx.nChannels || wfx.wBitsPerSample != 8 * (wfx.nBlockAlign / wfx.nChannels)) return kPCMFormatUnknown;
+  if (wfx.wFormatTag == WAVE_FORMAT_IEEE_FLOAT) return wfx.wBitsPerSample == 32 ? kPCMFormatF32 : kPCMFormatUnknown;
+  if (wfx.wFormatTag != WAVE_FORMAT_PCM) return kPCMFormatUnknown;
+  switch (wfx.wBitsPerSample) {
+    case 8:
+      return kPCMFormatU8;
+    case 16:
+      return kPCMFormatS16;
+    case 24:
+      return kPCMFormatS24;
+    case 32:
+      return kPCMFormatS32;
+    default:
+      return kPCMFormatUnknown;
+  }
+}
+
+uint32_t PCMConverter::GetBytesPerSample(PCMSampleFormat format) {
+  switch (format) {
+    case kPCMFormatU8:
+      return 1;
+    case kPCMFormatS16:
+      return 2;
+    case kPCMFormatS24:
+      return 3;
+    case kPCMFormatS32:
+    case kPCMFormatF32:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+PCMConverter::PCMConverter(const waveFormat_ext& wfx) : PCMConverter(GetSampleFormat(wfx), wfx.nChannels) {}
+
+PCMConverter::PCMConverter(PCMSampleFormat format, uint32_t numChannels)
+    : m_format(format),
+      m_numChannels(numChannels ? numChannels : 1),
+      m_bytesPerSample(GetBytesPerSample(format)),
+      m_toFloat(UnknownToFloat),
+      m_fromFloat(FloatToUnknown) {
+  switch (format) {
+#if defined(PCM_SSE2_SIMD)
+    case kPCMFormatU8:
+      m_toFloat = U8ToFloat_SSE2;
+      m_fromFloat = FloatToU8_SSE2;
+      break;
+    case kPCMFormatS16:
+      m_toFloat = S16ToFloat_SSE2;
+      m_fromFloat = FloatToS16_SSE2;
+      break;
+    case kPCMFormatS24:
+      m_toFloat = S24ToFloat_SSE2;
+      m_fromFloat = FloatToS24_SSE2;
+      break;
+    case kPCMFormatS32:
+      m_toFloat = S32ToFloat_SSE2;
+      m_fromFloat = FloatToS32_SSE2;
+      break;
+#elif defined(PCM_NEON_SIMD)
+    case kPCMFormatU8:
+      m_toFloat = U8ToFloat_NEON;
+      m_fromFloat = FloatToU8_NEON;
+      break;
+    case kPCMFormatS16:
+      m_toFloat = S16ToFloat_NEON;
+      m_fromFloat = FloatToS16_NEON;
+      break;
+    case kPCMFormatS24:
+      m_toFloat = S24ToFloat_NEON;
+      m_fromFloat = FloatToS24_NEON;
+      break;
+    case kPCMFormatS32:
+      m_toFloat = S32ToFloat_NEON;
+      m_fromFloat = FloatToS32_NEON;
+      break;
+#else
+    case kPCMFormatU8:
+      m_toFloat = U8ToFloat_C;
+      m_fromFloat = FloatToU8_C;
+      break;
+    case kPCMFormatS16:
+      m_toFloat = S16ToFloat_C;
+      m_fromFloat = FloatToS16_C;
+      break;
+    case kPCMFormatS24:
+      m_toFloat = S24ToFloat_C;
+      m_fromFloat = FloatToS24_C;
+      break;
+    case kPCMFormatS32:
+      m_toFloat = S32ToFloat_C;
+      m_fromFloat = FloatToS32_C;
+      break;
+#endif
+    case kPCMFormatF32:
+      m_toFloat = F32ToFloat;
+      m_fromFloat = FloatToF32;
+      break;
+    default:
+      m_format = kPCMFormatUnknown;
+      break;
+  }
+}
+
+void PCMConverter::ToFloatPlanar(const uint8_t* src, size_t numFrames, float* const* planes) const {
+  const uint32_t nc = m_numChannels;
+  if (nc == 1) {
+    m_toFloat(src, numFrames, planes[0]);
+    return;
+  }
+
+  // Convert a chunk at a time into a buffer that stays in L1, then scatter it to the planes
+  float stackBuf[kChunkSamples];
+  std::vector<float> heapBuf;
+  float* buf = stackBuf;
+  if (nc > kChunkSamples) {
+    heapBuf.resize(nc);
+    buf = heapBuf.data();
+  }
+  const size_t chunkFrames = std::max<size_t>(kChunkSamples / nc, 1);
+  for (size_t f = 0; f < numFrames; f += chunkFrames) {
+    const size_t n = std::min(chunkFrames, numFrames - f);
+    m_toFloat(src + f * nc * m_bytesPerSample, n * nc, buf);
+    if (nc == 2) {
+      DeinterleaveStereo(buf, n, planes[0] + f, planes[1] + f);
+    } else {
+      for (uint32_t c = 0; c < nc; c++) {
+        float* dst = planes[c] + f;
+        for (size_t i = 0; i < n; i++) dst[i] = buf[i * nc + c];
+      }
+    }
+  }
+}
+
+void PCMConverter::ToFloatMono(const uint8_t* src, size_t numFrames, float* dst) const {
+  const uint32_t nc = m_numChannels;
+  if (nc == 1) {
+    m_toFloat(src, numFrames, dst);
+    return;
+  }
+
+  float stackBuf[kChunkSamples];
+  std::vector<float> heapBuf;
+  float* buf = stackBuf;
+  if (nc > kChunkSamples) {
+    heapBuf.resize(nc);
+    buf = heapBuf.data();
+  }
+  const size_t chunkFrames = std::max<size_t>(kChunkSamples / nc, 1);
+  for (size_t f = 0; f < numFrames; f += chunkFrames) {
+    const size_t n = std::min(chunkFrames, numFrames - f);
+    m_toFloat(src + f * nc * m_bytesPerSample, n * nc, buf);
+    if (nc == 2)
+      DownmixStereo(buf, n, dst + f);
+    else
+      DownmixChannels(buf, n, nc, dst + f);
+  }
+}
@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "wave.h"
+
+// The sample formats that PCMConverter has kernels for.
+enum PCMSampleFormat {
+  kPCMFormatUnknown = 0,
+  kPCMFormatU8,   // 8-bit unsigned integer, centered on 128
+  kPCMFormatS16,  // 16-bit signed integer
+  kPCMFormatS24,  // 24-bit signed integer, packed into 3 bytes
+  kPCMFormatS32,  // 32-bit signed integer
+  kPCMFormatF32,  // 32-bit IEEE float
+};
+
+// Converts samples between a WAV file's PCM format and float in [-1, 1].
+// The kernels for the format are selected once, when the converter is made, rather than per sample; they are
+// vectorized with SSE2 or NEON where available. Integer samples are scaled by 2^-(bits-1) to float, and float
+// samples are clamped to [-1, 1], scaled by 2^(bits-1), rounded to nearest and saturated on the way back.
+// Unknown formats convert to silence.
+class PCMConverter {
+ public:
+  typedef void (*ToFloatProc)(const uint8_t* src, size_t n, float* dst);
+  typedef void (*FromFloatProc)(const float* src, size_t n, uint8_t* dst);
+
+  PCMConverter() : PCMConverter(kPCMFormatUnknown, 1) {}
+  PCMConverter(PCMSampleFormat format, uint32_t numChannels);
+  explicit PCMConverter(const waveFormat_ext& wfx);
+
+  // The format of the samples described by a WAV format header, or kPCMFormatUnknown.
+  static PCMSampleFormat GetSampleFormat(const waveFormat_ext& wfx);
+  static uint32_t GetBytesPerSample(PCMSampleFormat format);
+
+  PCMSampleFormat GetFormat() const { return m_format; }
+  uint32_t GetNumChannels() const { return m_numChannels; }
+  uint32_t GetBytesPerSample() const { return m_bytesPerSample; }
+  bool isValid() const { return m_format != kPCMFormatUnknown; }
+
+  // Convert n samples, counted over all channels and left interleaved, to float.
+  void ToFloat(const uint8_t* src, size_t n, float* dst) const { m_toFloat(src, n, dst); }
+
+  // Convert n frames of interleaved samples to float, one plane per channel.
+  void ToFloatPlanar(const uint8_t* src, size_t numFrames, float* const* planes) const;
+
+  // Convert n frames of interleaved samples to float, averaging the channels of each frame into one mono sample.
+  void ToFloatMono(const uint8_t* src, size_t numFrames, float* dst) const;
+
+  // Convert n float samples, counted over all channels, to PCM.
+  void FromFloat(const float* src, size_t n, uint8_t* dst) const { m_fromFloat(src, n, dst); }
+
+ private:
+  PCMSampleFormat m_format;
+  uint32_t m_numChannels;
+  uint32_t m_bytesPerSample;
+  ToFloatProc m_toFloat;
+  FromFloatProc m_fromFloat;
+};
@@ -25,66 +25,47 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
-#include <map>
 #include <memory>
 #include <sstream>
 
 #include "wave.h"
 
 #ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
 #include <Shlwapi.h>
 #include <io.h>
 #pragma comment(lib, "Shlwapi.lib")
 #else
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
 #include "waveReadWrite.h"
 // #include <misc.hpp>
 
-const float* CWaveFileRead::GetFloatPCMData() {
-  int8_t* audioDataPtr = reinterpret_cast<int8_t*>(m_WaveData.get());
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WAVE_SSE2_SIMD
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define WAVE_NEON_SIMD
+#include <arm_neon.h>
+#endif
 
+const float* CWaveFileRead::GetFloatPCMData() {
   if (m_floatWaveData.size()) return m_floatWaveData.data();
 
   m_floatWaveData.resize(m_nNumSamples);
-  float* outputWaveData = m_floatWaveData.data();
-
-  if (m_WaveFormatEx.wFormatTag == WAVE_FORMAT_IEEE_FLOAT) {
-    memcpy(outputWaveData, audioDataPtr, m_nNumSamples * sizeof(float));
-    return outputWaveData;
-  }
-
-  for (uint32_t i = 0; i < m_nNumSamples; i++) {
-    switch (m_WaveFormatEx.wBitsPerSample) {
-      case 8: {
-        uint8_t audioSample = *(reinterpret_cast<uint8_t*>(audioDataPtr));
-        outputWaveData[i] = (audioSample - 128) / 128.0f;
-      } break;
-      case 16: {
-        int16_t audioSample = *(reinterpret_cast<int16_t*>(audioDataPtr));
-        outputWaveData[i] = audioSample / 32768.0f;
-      } break;
-      case 24: {
-        int32_t audioSample = *(reinterpret_cast<int32_t*>(audioDataPtr));
-        uint8_t data0 = audioSample & 0x000000ff;
-        uint8_t data1 = static_cast<uint8_t>((audioSample & 0x0000ff00) >> 8);
-        uint8_t data2 = static_cast<uint8_t>((audioSample & 0x00ff0000) >> 16);
-        int32_t Value = ((data2 << 24) | (data1 << 16) | (data0 << 8)) >> 8;
-        outputWaveData[i] = Value / 8388608.0f;
-      } break;
-      case 32: {
-        int32_t audioSample = *(reinterpret_cast<int32_t*>(audioDataPtr));
-        outputWaveData[i] = audioSample / 2147483648.0f;
-      } break;
-    }
-    audioDataPtr += m_WaveFormatEx.nBlockAlign;
-  }
-
-  return outputWaveData;
+  m_converter.ToFloat(m_WaveData.get(), m_nNumSamples, m_floatWaveData.data());
+  return m_floatWaveData.data();
 }
 
 const float* CWaveFileRead::GetFloatPCMDataAligned(int alignSamples) {
@@ -167,18 +148,13 @@ inline std::string loadFile(const std::string& infilename) {
   return result;
 }
 
-int CWaveFileRead::readPCM(const char* szFileName) {
-  std::string fileData;
-  if (loadFile(std::string(szFileName), &fileData) != true) {
-    return -1;
-  }
-
-  const uint8_t* waveData = reinterpret_cast<const uint8_t*>(fileData.data());
-  size_t waveDataSize = fileData.length();
+// Locate the format and the samples of a WAV file that is in memory.
+static int ParseWave(const uint8_t* waveData, size_t waveDataSize, waveFormat_ext* wfx, const uint8_t** pcm,
+                     uint32_t* pcmSize) {
   const uint8_t* waveEnd = waveData + waveDataSize;
 
   // Locate RIFF 'WAVE'
-  const RiffChunk* riffChunk = FindChunk(waveData, waveDataSize, MAKEFOURCC('R', 'I', 'F', 'F'));
+  const RiffChunk* riffChunk = CWaveFileRead::FindChunk(waveData, waveDataSize, MAKEFOURCC('R', 'I', 'F', 'F'));
   if (!riffChunk || riffChunk->chunkSize < 4) {
     return -1;
   }
@@ -193,8 +169,10 @@ int CWaveFileRead::readPCM(const char* szFileName) {
   if ((ptr + sizeof(RiffChunk)) > waveEnd) {
     return -1;
   }
+  // Never search beyond the end of the file, whatever the RIFF header claims
+  size_t riffSize = std::min<size_t>(riffHeader->chunkSize, waveEnd - ptr);
 
-  const RiffChunk* fmtChunk = FindChunk(ptr, riffHeader->chunkSize, MAKEFOURCC('f', 'm', 't', ' '));
+  const RiffChunk* fmtChunk = CWaveFileRead::FindChunk(ptr, riffSize, MAKEFOURCC('f', 'm', 't', ' '));
   if (!fmtChunk || fmtChunk->chunkSize < sizeof(waveFormat_basic)) {
     return -1;
   }
@@ -219,7 +197,7 @@ int CWaveFileRead::readPCM(const char* szFileName) {
     return -1;
   }
 
-  const RiffChunk* dataChunk = FindChunk(ptr, riffChunk->chunkSize, MAKEFOURCC('d', 'a', 't', 'a'));
+  const RiffChunk* dataChunk = CWaveFileRead::FindChunk(ptr, riffSize, MAKEFOURCC('d', 'a', 't', 'a'));
   if (!dataChunk || !dataChunk->chunkSize) {
     return -1;
   }
@@ -229,21 +207,468 @@ int CWaveFileRead::readPCM(const char* szFileName) {
     return -1;
   }
 
-  m_WaveData = std::unique_ptr<uint8_t[]>(new uint8_t[dataChunk->chunkSize]);
-  m_WaveDataSize = dataChunk->chunkSize;
-  memcpy(m_WaveData.get(), ptr, dataChunk->chunkSize);
-  if (wf->formatTag == WAVE_FORMAT_PCM) {
-    memcpy(&m_WaveFormatEx, reinterpret_cast<const waveFormat_basic*>(wf), sizeof(waveFormat_basic));
-    m_WaveFormatEx.cbSize = 0;
+  memset(wfx, 0, sizeof(*wfx));
+  if (wf->formatTag == WAVE_FORMAT_PCM || fmtChunk->chunkSize < sizeof(waveFormat_ext)) {
+    memcpy(wfx, reinterpret_cast<const waveFormat_basic*>(wf), sizeof(waveFormat_basic));
+    wfx->cbSize = 0;
   } else {
-    memcpy(&m_WaveFormatEx, reinterpret_cast<const waveFormat_ext*>(wf), sizeof(waveFormat_ext));
+    memcpy(wfx, reinterpret_cast<const waveFormat_ext*>(wf), sizeof(waveFormat_ext));
+  }
+  if (!wfx->nChannels || wfx->nBlockAlign < wfx->nChannels) {
+    return -1;
+  }
+
+  *pcm = ptr;
+  *pcmSize = dataChunk->chunkSize;
+  return 0;
+}
+
+int CWaveFileRead::readPCM(const char* szFileName) {
+  std::string fileData;
+  if (loadFile(std::string(szFileName), &fileData) != true) {
+    return -1;
   }
 
+  const uint8_t* pcm;
+  uint32_t pcmSize;
+  if (ParseWave(reinterpret_cast<const uint8_t*>(fileData.data()), fileData.length(), &m_WaveFormatEx, &pcm,
+                &pcmSize) != 0) {
+    return -1;
+  }
+
+  m_WaveData = std::unique_ptr<uint8_t[]>(new uint8_t[pcmSize]);
+  m_WaveDataSize = pcmSize;
+  memcpy(m_WaveData.get(), pcm, pcmSize);
+
   m_nNumSamples = m_WaveDataSize / (m_WaveFormatEx.nBlockAlign / m_WaveFormatEx.nChannels);
+  m_converter = PCMConverter(m_WaveFormatEx);
 
   return 0;
 }
 
+CWaveFileStream::CWaveFileStream(std::string wavFile) : m_wavFile(wavFile) {
+  memset(&m_WaveFormatEx, 0, sizeof(m_WaveFormatEx));
+  if (!mapFile(m_wavFile.c_str())) return;
+
+  const uint8_t* pcm;
+  uint32_t pcmSize;
+  if (ParseWave(m_fileData, m_fileSize, &m_WaveFormatEx, &pcm, &pcmSize) != 0) {
+    unmapFile();
+    return;
+  }
+  m_WaveData = pcm;
+  m_WaveDataSize = pcmSize;
+  m_nNumSamples = m_WaveDataSize / (m_WaveFormatEx.nBlockAlign / m_WaveFormatEx.nChannels);
+  m_converter = PCMConverter(m_WaveFormatEx);
+}
+
+CWaveFileStream::~CWaveFileStream() { unmapFile(); }
+
+#ifdef _WIN32
+
+bool CWaveFileStream::mapFile(const char* szFileName) {
+  LARGE_INTEGER size;
+  HANDLE file = CreateFileA(szFileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return false;
+  m_fileHandle = file;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+    unmapFile();
+    return false;
+  }
+  m_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (m_mappingHandle) m_fileData = static_cast<const uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+  if (!m_fileData) {
+    unmapFile();
+    return false;
+  }
+  m_fileSize = static_cast<size_t>(size.QuadPart);
+  return true;
+}
+
+void CWaveFileStream::unmapFile() {
+  if (m_fileData) UnmapViewOfFile(m_fileData);
+  if (m_mappingHandle) CloseHandle(m_mappingHandle);
+  if (m_fileHandle) CloseHandle(m_fileHandle);
+  m_fileData = nullptr;
+  m_fileSize = 0;
+  m_mappingHandle = nullptr;
+  m_fileHandle = nullptr;
+  m_WaveData = nullptr;
+}
+
+#else  // !_WIN32
+
+bool CWaveFileStream::mapFile(const char* szFileName) {
+  struct stat st;
+  int fd = open(szFileName, O_RDONLY);
+  if (fd < 0) return false;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+  void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);  // The mapping persists after the descriptor is closed
+  if (data == MAP_FAILED) return false;
+  (void)madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);  // Read ahead, and drop pages behind
+  m_fileData = static_cast<const uint8_t*>(data);
+  m_fileSize = static_cast<size_t>(st.st_size);
+  return true;
+}
+
+void CWaveFileStream::unmapFile() {
+  if (m_fileData) munmap(const_cast<uint8_t*>(m_fileData), m_fileSize);
+  m_fileData = nullptr;
+  m_fileSize = 0;
+  m_WaveData = nullptr;
+}
+
+#endif  // !_WIN32
+
+// Grow a scratch buffer, never shrinking it, so that it is allocated only until it reaches its working size.
+static float* GrowScratch(std::vector<float>& buf, size_t size) {
+  if (buf.size() < size) buf.resize(size);
+  return buf.data();
+}
+
+uint32_t CWaveFileStream::ReadFloat(uint64_t start, uint32_t count, float* dst) const {
+  if (m_outChannels) {
+    uint32_t numValid = 0;
+    if (start < m_nNumOutSamples) numValid = static_cast<uint32_t>(std::min<uint64_t>(count, m_nNumOutSamples - start));
+    if (numValid) {
+      const uint64_t firstFrame = start / m_outChannels;
+      const uint64_t endFrame = (start + numValid + m_outChannels - 1) / m_outChannels;
+      const uint32_t numFrames = static_cast<uint32_t>(endFrame - firstFrame);
+      if (m_outChannels == 1) {
+        readConvertedFrames(firstFrame, numFrames, dst);
+      } else {
+        float* frames = GrowScratch(m_frameBuf, size_t(numFrames) * m_outChannels);
+        readConvertedFrames(firstFrame, numFrames, frames);
+        memcpy(dst, frames + (start - firstFrame * m_outChannels), numValid * sizeof(float));
+      }
+    }
+    if (numValid < count) memset(dst + numValid, 0, (count - numValid) * sizeof(float));
+    return numValid;
+  }
+
+  uint32_t numValid = 0;
+  if (start < m_nNumSamples) numValid = static_cast<uint32_t>(std::min<uint64_t>(count, m_nNumSamples - start));
+  if (numValid) m_converter.ToFloat(m_WaveData + start * m_converter.GetBytesPerSample(), numValid, dst);
+  if (numValid < count) memset(dst + numValid, 0, (count - numValid) * sizeof(float));
+  return numValid;
+}
+
+void CWaveFileStream::Reserve(uint32_t maxCount) const {
+  if (!m_outChannels) return;  // Samples in the format of the file are converted straight into the destination
+  const uint32_t numPlanes = numConvertedPlanes();
+  const uint32_t maxFrames = maxCount / m_outChannels + 2;  // A read can start and end partway through a frame
+  if (m_outChannels != 1) {
+    GrowScratch(m_frameBuf, size_t(maxFrames) * m_outChannels);
+    GrowScratch(m_outBuf, size_t(numPlanes) * maxFrames);
+  }
+  if (m_resampler) {
+    int64_t inStart;
+    uint32_t inCount;
+    m_resampler->GetInputRange(0, maxFrames, &inStart, &inCount);
+    GrowScratch(m_inBuf, size_t(numPlanes) * (inCount + 1));  // The range can be 1 longer elsewhere
+  }
+}
+
+const float* CWaveFileStream::GetFloatWindow(uint64_t start, uint32_t count, uint32_t* numValid) {
+  if (m_window.size() < count) m_window.resize(count);
+  uint32_t n = ReadFloat(start, count, m_window.data());
+  if (numValid) *numValid = n;
+  return m_window.data();
+}
+
+uint32_t CWaveFileStream::ReadFloatPlanar(uint64_t start, uint32_t count, float* const* planes) const {
+  const uint32_t numChannels = m_converter.GetNumChannels();
+  const uint64_t numFrames = m_nNumSamples / numChannels;
+  uint32_t numValid = 0;
+  if (start < numFrames) numValid = static_cast<uint32_t>(std::min<uint64_t>(count, numFrames - start));
+  if (numValid) {
+    m_converter.ToFloatPlanar(m_WaveData + start * m_WaveFormatEx.nBlockAlign, numValid, planes);
+  }
+  if (numValid < count) {
+    for (uint32_t c = 0; c < numChannels; c++) memset(planes[c] + numValid, 0, (count - numValid) * sizeof(float));
+  }
+  return numValid;
+}
+
+uint32_t CWaveFileStream::ReadFloatMono(uint64_t start, uint32_t count, float* dst) const {
+  const uint64_t numFrames = m_nNumSamples / m_converter.GetNumChannels();
+  uint32_t numValid = 0;
+  if (start < numFrames) numValid = static_cast<uint32_t>(std::min<uint64_t>(count, numFrames - start));
+  if (numValid) m_converter.ToFloatMono(m_WaveData + start * m_WaveFormatEx.nBlockAlign, numValid, dst);
+  if (numValid < count) memset(dst + numValid, 0, (count - numValid) * sizeof(float));
+  return numValid;
+}
+
+bool CWaveFileStream::SetOutputFormat(uint32_t sampleRate, uint32_t numChannels) {
+  const uint32_t fileChannels = m_WaveFormatEx.nChannels;
+  if (!isValid() || !numChannels || !(numChannels == fileChannels || numChannels == 1 || fileChannels == 1))
+    return false;
+
+  std::unique_ptr<CWaveResampler> resampler;
+  if (sampleRate != m_WaveFormatEx.nSamplesPerSec) {
+    resampler.reset(new CWaveResampler(m_WaveFormatEx.nSamplesPerSec, sampleRate));
+    if (!resampler->isValid()) return false;
+  }
+
+  const uint64_t numInFrames = m_nNumSamples / fileChannels;
+  const uint64_t numOutFrames = resampler ? resampler->GetNumOutputFrames(numInFrames) : numInFrames;
+  m_nNumOutSamples = static_cast<uint32_t>(std::min<uint64_t>(numOutFrames * numChannels, UINT32_MAX));
+  m_outChannels = numChannels;
+  m_resampler = std::move(resampler);
+  m_planePtrs.resize(3 * size_t(numConvertedPlanes()));
+  return true;
+}
+
+// Convert the frames [start, start + count) to the output format, interleaved.
+void CWaveFileStream::readConvertedFrames(uint64_t start, uint32_t count, float* dst) const {
+  const uint32_t inChannels = m_WaveFormatEx.nChannels, outChannels = m_outChannels;
+  const uint32_t numPlanes = numConvertedPlanes();  // Channels are mixed down before resampling
+  float** shifted = m_planePtrs.data();
+  float** outPlanes = shifted + numPlanes;
+  float** inPlanes = outPlanes + numPlanes;
+
+  // Read input frames [first, first + n), which may start before the beginning of the file, into planes
+  auto readInput = [&](int64_t first, uint32_t n, float* const* planes) {
+    const uint32_t skip = first < 0 ? static_cast<uint32_t>(std::min<int64_t>(-first, n)) : 0;
+    for (uint32_t c = 0; c < numPlanes; c++) {
+      memset(planes[c], 0, skip * sizeof(float));
+      shifted[c] = planes[c] + skip;
+    }
+    if (skip == n) return;
+    if (numPlanes == 1)
+      ReadFloatMono(first + skip, n - skip, shifted[0]);
+    else
+      ReadFloatPlanar(first + skip, n - skip, shifted);
+  };
+
+  if (outChannels == 1) {
+    outPlanes[0] = dst;
+  } else {
+    float* outBuf = GrowScratch(m_outBuf, size_t(numPlanes) * count);
+    for (uint32_t c = 0; c < numPlanes; c++) outPlanes[c] = outBuf + size_t(c) * count;
+  }
+
+  if (!m_resampler) {
+    readInput(static_cast<int64_t>(start), count, outPlanes);
+  } else {
+    int64_t inStart;
+    uint32_t inCount;
+    m_resampler->GetInputRange(start, count, &inStart, &inCount);
+    float* inBuf = GrowScratch(m_inBuf, size_t(numPlanes) * inCount);
+    for (uint32_t c = 0; c < numPlanes; c++) inPlanes[c] = inBuf + size_t(c) * inCount;
+    readInput(inStart, inCount, inPlanes);
+    for (uint32_t c = 0; c < numPlanes; c++) m_resampler->Resample(inPlanes[c], start, count, outPlanes[c]);
+  }
+
+  if (outChannels != 1) {
+    for (uint32_t i = 0; i < count; i++) {
+      for (uint32_t c = 0; c < outChannels; c++)
+        dst[size_t(i) * outChannels + c] = outPlanes[numPlanes == 1 ? 0 : c][i];
+    }
+  }
+}
+
+namespace {
+
+const double kResampleZeroCrossings = 16;  // On each side of the sinc
+const double kResampleRolloff = 0.945;     // The cutoff, as a fraction of the lower Nyquist frequency
+const double kResampleKaiserBeta = 8.0;
+
+uint64_t Gcd(uint64_t a, uint64_t b) {
+  while (b) {
+    uint64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+// The zeroth order modified Bessel function of the first kind, for the Kaiser window.
+double BesselI0(double x) {
+  double sum = 1, term = 1;
+  for (int k = 1; k < 100; k++) {
+    term *= (x / (2 * k)) * (x / (2 * k));
+    sum += term;
+    if (term < sum * 1e-12) break;
+  }
+  return sum;
+}
+
+// The dot product of two vectors whose length is a multiple of 4.
+float DotProduct(const float* a, const float* b, uint32_t n) {
+#if defined(WAVE_SSE2_SIMD)
+  __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  if (i < n) acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  acc0 = _mm_add_ps(acc0, acc1);
+  acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+  acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+  return _mm_cvtss_f32(acc0);
+#elif defined(WAVE_NEON_SIMD)
+  float32x4_t acc0 = vdupq_n_f32(0.f), acc1 = vdupq_n_f32(0.f);
+  uint32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  if (i < n) acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+  return vaddvq_f32(vaddq_f32(acc0, acc1));
+#else
+  float sum[4] = {0.f, 0.f, 0.f, 0.f};
+  for (uint32_t i = 0; i < n; i += 4)
+    for (int k = 0; k < 4; k++) sum[k] += a[i + k] * b[i + k];
+  return (sum[0] + sum[2]) + (sum[1] + sum[3]);
+#endif
+}
+
+}  // namespace
+
+CWaveResampler::CWaveResampler(uint32_t inRate, uint32_t outRate) : m_inRate(inRate), m_outRate(outRate) {
+  if (!inRate || !outRate) return;
+
+  const uint64_t gcd = Gcd(inRate, outRate);
+  m_L = outRate / gcd;
+  m_M = inRate / gcd;
+  m_numPhases = static_cast<uint32_t>(std::min<uint64_t>(m_L, kMaxPhases));
+
+  // The cutoff is in cycles per input frame, and the filter spans kResampleZeroCrossings of its sinc on each side
+  const double kPi = 3.14159265358979323846;
+  const double cutoff = 0.5 * std::min(1.0, double(m_L) / double(m_M)) * kResampleRolloff;
+  const double halfWidth = kResampleZeroCrossings / (2 * cutoff);
+  m_numTaps = (2 * static_cast<uint32_t>(std::ceil(halfWidth)) + 3) & ~3u;
+  const int halfTaps = static_cast<int>(m_numTaps / 2);
+  const double windowScale = 1.0 / BesselI0(kResampleKaiserBeta);
+
+  // One row per phase, plus one for a whole frame, which is where phases round to when they are quantized
+  m_coeffs.resize(size_t(m_numPhases + 1) * m_numTaps);
+  for (uint32_t p = 0; p <= m_numPhases; p++) {
+    float* row = m_coeffs.data() + size_t(p) * m_numTaps;
+    const double frac = double(p) / m_numPhases;
+    double sum = 0;
+    std::vector<double> h(m_numTaps);
+    for (uint32_t j = 0; j < m_numTaps; j++) {
+      const double d = (int(j) - halfTaps + 1) - frac;  // From the output frame to the input frame, in input frames
+      const double r = d / halfWidth;
+      if (r <= -1 || r >= 1) continue;
+      const double x = 2 * cutoff * d;
+      const double sinc = (x == 0) ? 1.0 : std::sin(kPi * x) / (kPi * x);
+      h[j] = 2 * cutoff * sinc * BesselI0(kResampleKaiserBeta * std::sqrt(1 - r * r)) * windowScale;
+      sum += h[j];
+    }
+    for (uint32_t j = 0; j < m_numTaps; j++) row[j] = static_cast<float>(h[j] / sum);  // Unity gain at DC
+  }
+  Reset();
+}
+
+void CWaveResampler::GetInputRange(uint64_t outStart, uint32_t outCount, int64_t* inStart, uint32_t* inCount) const {
+  const int64_t halfTaps = m_numTaps / 2;
+  *inStart = static_cast<int64_t>(outStart * m_M / m_L) - halfTaps + 1;
+  if (!outCount) {
+    *inCount = 0;
+    return;
+  }
+  const int64_t last = static_cast<int64_t>((outStart + outCount - 1) * m_M / m_L) + halfTaps;
+  *inCount = static_cast<uint32_t>(last - *inStart + 1);
+}
+
+void CWaveResampler::Resample(const float* in, uint64_t outStart, uint32_t outCount, float* out) const {
+  // Step through the output, keeping the position of each output frame in the input as n0 + rem / L
+  uint64_t pos = outStart * m_M;
+  uint64_t n0 = pos / m_L, rem = pos % m_L;
+  const uint64_t firstN0 = n0;
+  const uint64_t stepFrames = m_M / m_L, stepRem = m_M % m_L;
+  for (uint32_t k = 0; k < outCount; k++) {
+    uint64_t phase = rem;
+    if (m_numPhases != m_L) phase = (rem * m_numPhases + m_L / 2) / m_L;
+    out[k] = DotProduct(in + (n0 - firstN0), m_coeffs.data() + phase * m_numTaps, m_numTaps);
+    n0 += stepFrames;
+    rem += stepRem;
+    if (rem >= m_L) {
+      rem -= m_L;
+      n0++;
+    }
+  }
+}
+
+void CWaveResampler::Resample(const float* in, uint64_t numInFrames, uint64_t outStart, uint32_t outCount,
+                              float* out) const {
+  int64_t inStart;
+  uint32_t inCount;
+  GetInputRange(outStart, outCount, &inStart, &inCount);
+  if (inStart >= 0 && uint64_t(inStart) + inCount <= numInFrames) {
+    Resample(in + inStart, outStart, outCount, out);
+    return;
+  }
+
+  // Pad with silence beyond the ends of the signal
+  std::vector<float> padded(inCount, 0.f);
+  const int64_t first = std::max<int64_t>(inStart, 0);
+  const int64_t last = std::min<int64_t>(inStart + inCount, static_cast<int64_t>(numInFrames));
+  if (first < last) memcpy(padded.data() + (first - inStart), in + first, size_t(last - first) * sizeof(float));
+  Resample(padded.data(), outStart, outCount, out);
+}
+
+void CWaveResampler::Reset() {
+  // The history starts with the silence before the signal that the first output frame reaches back to
+  m_historyStart = -static_cast<int64_t>(m_numTaps / 2) + 1;
+  m_history.assign(static_cast<size_t>(-m_historyStart), 0.f);
+  m_numInFrames = 0;
+  m_numOutFrames = 0;
+}
+
+void CWaveResampler::Process(const float* in, size_t numFrames, std::vector<float>* out) {
+  if (!isValid()) return;
+  m_history.insert(m_history.end(), in, in + numFrames);
+  m_numInFrames += numFrames;
+
+  // Output frame k is ready once the input reaches frame floor(k * M / L) + numTaps / 2
+  const uint64_t halfTaps = m_numTaps / 2;
+  const uint64_t numReady = m_numInFrames > halfTaps ? ((m_numInFrames - halfTaps) * m_L + m_M - 1) / m_M : 0;
+  if (numReady <= m_numOutFrames) return;
+
+  const uint32_t count = static_cast<uint32_t>(numReady - m_numOutFrames);
+  int64_t inStart;
+  uint32_t inCount;
+  GetInputRange(m_numOutFrames, count, &inStart, &inCount);
+  const size_t outOffset = out->size();
+  out->resize(outOffset + count);
+  Resample(m_history.data() + (inStart - m_historyStart), m_numOutFrames, count, out->data() + outOffset);
+  m_numOutFrames = numReady;
+
+  // Drop the input that no later output frame reaches back to
+  GetInputRange(m_numOutFrames, 1, &inStart, &inCount);
+  if (inStart > m_historyStart) {
+    m_history.erase(m_history.begin(), m_history.begin() + (inStart - m_historyStart));
+    m_historyStart = inStart;
+  }
+}
+
+void CWaveResampler::Flush(std::vector<float>* out) {
+  if (!isValid()) return;
+  const uint64_t numOut = GetNumOutputFrames(m_numInFrames);
+  if (numOut > m_numOutFrames) {
+    // Follow the signal with enough silence for the filter to reach the end of it
+    m_history.resize(m_history.size() + m_numTaps / 2, 0.f);
+    const uint32_t count = static_cast<uint32_t>(numOut - m_numOutFrames);
+    int64_t inStart;
+    uint32_t inCount;
+    GetInputRange(m_numOutFrames, count, &inStart, &inCount);
+    const size_t outOffset = out->size();
+    out->resize(outOffset + count);
+    Resample(m_history.data() + (inStart - m_historyStart), m_numOutFrames, count, out->data() + outOffset);
+  }
+  Reset();
+}
+
 CWaveFileWrite::CWaveFileWrite(std::string wavFile, uint32_t samplesPerSec, uint32_t numChannels,
                                uint16_t bitsPerSample, bool isFloat)
     : m_wavFile(wavFile) {
@@ -254,6 +679,7 @@ CWaveFileWrite::CWaveFileWrite(std::string wavFile, uint32_t samplesPerSec, uint
   wfx.nAvgBytesPerSec = samplesPerSec * wfx.nBlockAlign;
   wfx.wBitsPerSample = bitsPerSample;
   wfx.cbSize = 0;
+  m_converter = PCMConverter(wfx);
 
   m_validState = true;
 }
@@ -300,6 +726,21 @@ bool CWaveFileWrite::writeChunk(const void* data, uint32_t len) {
   return true;
 }
 
+bool CWaveFileWrite::writeFloat(const float* data, uint32_t numSamples) {
+  if (m_converter.GetFormat() == kPCMFormatF32) return writeChunk(data, numSamples * sizeof(float));
+  if (!m_converter.isValid()) return false;
+
+  // Convert a chunk at a time, so that the buffer stays small
+  const uint32_t kChunkSamples = 4096;
+  m_convertBuffer.resize(kChunkSamples * m_converter.GetBytesPerSample());
+  for (uint32_t i = 0; i < numSamples; i += kChunkSamples) {
+    uint32_t n = std::min(kChunkSamples, numSamples - i);
+    m_converter.FromFloat(data + i, n, m_convertBuffer.data());
+    if (!writeChunk(m_convertBuffer.data(), n * m_converter.GetBytesPerSample())) return false;
+  }
+  return true;
+}
+
 bool CWaveFileWrite::commitFile() {
   if (!m_validState) return false;
 
@@ -344,10 +785,142 @@ std::vector<float>* CWaveFileRead::GetFloatVector() {
   return &m_floatWaveData;
 }
 
-std::map<std::string, std::unique_ptr<CWaveFileRead>> read_file_cache;
+CWaveFileCache::CWaveFileCache(size_t capacityBytes) : m_capacityBytes(capacityBytes) {}
+
+CWaveFileCache& CWaveFileCache::Global() {
+  static CWaveFileCache cache;
+  return cache;
+}
+
+std::shared_ptr<const CWaveFileData> CWaveFileCache::Get(const std::string& filename) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(filename);
+    if (it != m_entries.end()) {
+      m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+      ++m_hits;
+      return it->second.data;
+    }
+    ++m_misses;
+  }
+
+  // Convert the samples straight from the mapped file, without holding a copy of the PCM data
+  CWaveFileStream wave_file(filename);
+  if (!wave_file.isValid()) return nullptr;
+  std::shared_ptr<CWaveFileData> data = std::make_shared<CWaveFileData>();
+  data->format = wave_file.GetWaveFormat();
+  data->rawPCMSizeInBytes = wave_file.GetRawPCMDataSizeInBytes();
+  data->samples.resize(wave_file.GetNumSamples());
+  wave_file.ReadFloat(0, wave_file.GetNumSamples(), data->samples.data());
+
+  const size_t sizeBytes = SizeOf(*data);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_entries.find(filename);
+  if (it != m_entries.end()) return it->second.data;  // Another thread read it at the same time
+  if (sizeBytes > m_capacityBytes) return data;
+  m_lru.push_front(filename);
+  m_entries.emplace(filename, Entry{data, sizeBytes, m_lru.begin()});
+  m_sizeBytes += sizeBytes;
+  evict();
+  return data;
+}
+
+void CWaveFileCache::evict() {
+  while (m_sizeBytes > m_capacityBytes && !m_lru.empty()) {
+    auto it = m_entries.find(m_lru.back());
+    m_sizeBytes -= it->second.sizeBytes;
+    m_entries.erase(it);
+    m_lru.pop_back();
+    ++m_evictions;
+  }
+}
+
+void CWaveFileCache::Invalidate(const std::string& filename) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_entries.find(filename);
+  if (it == m_entries.end()) return;
+  m_sizeBytes -= it->second.sizeBytes;
+  m_lru.erase(it->second.lru);
+  m_entries.erase(it);
+}
+
+void CWaveFileCache::Clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_lru.clear();
+  m_sizeBytes = 0;
+}
+
+void CWaveFileCache::SetCapacity(size_t capacityBytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_capacityBytes = capacityBytes;
+  evict();
+}
+
+WaveFileCacheStats CWaveFileCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  WaveFileCacheStats stats;
+  stats.hits = m_hits;
+  stats.misses = m_misses;
+  stats.evictions = m_evictions;
+  stats.numFiles = m_entries.size();
+  stats.sizeBytes = m_sizeBytes;
+  stats.capacityBytes = m_capacityBytes;
+  return stats;
+}
+
+// Convert decoded samples to another sample rate and/or number of channels, as CWaveFileStream::SetOutputFormat() does.
+static bool ConvertWaveData(const CWaveFileData& wave, uint32_t sampleRate, uint32_t numChannels,
+                            std::vector<float>* out) {
+  const uint32_t inChannels = wave.format.nChannels;
+  if (!inChannels || !numChannels || !(numChannels == inChannels || numChannels == 1 || inChannels == 1)) return false;
+  const uint64_t numInFrames = wave.samples.size() / inChannels;
+  const float* in = wave.samples.data();
+
+  // Mix down to mono, or split the channels into planes
+  const uint32_t numPlanes = (numChannels == 1) ? 1 : inChannels;
+  std::vector<float> planes;
+  if (inChannels > 1) {
+    planes.resize(numPlanes * numInFrames);
+    for (uint64_t i = 0; i < numInFrames; i++) {
+      const float* frame = in + i * inChannels;
+      if (numPlanes == 1) {
+        float sum = frame[0];
+        for (uint32_t c = 1; c < inChannels; c++) sum += frame[c];
+        planes[i] = sum * (1.f / inChannels);
+      } else {
+        for (uint32_t c = 0; c < inChannels; c++) planes[c * numInFrames + i] = frame[c];
+      }
+    }
+    in = planes.data();
+  }
+
+  std::vector<float> resampled;
+  uint64_t numOutFrames = numInFrames;
+  if (sampleRate != wave.format.nSamplesPerSec) {
+    CWaveResampler resampler(wave.format.nSamplesPerSec, sampleRate);
+    if (!resampler.isValid()) return false;
+    numOutFrames = resampler.GetNumOutputFrames(numInFrames);
+    if (numOutFrames * numChannels > UINT32_MAX) return false;
+    resampled.resize(numPlanes * numOutFrames);
+    for (uint32_t c = 0; c < numPlanes; c++) {
+      resampler.Resample(in + c * numInFrames, numInFrames, 0, static_cast<uint32_t>(numOutFrames),
+                         resampled.data() + c * numOutFrames);
+    }
+    in = resampled.data();
+  }
+
+  out->resize(numOutFrames * numChannels);
+  for (uint64_t i = 0; i < numOutFrames; i++) {
+    for (uint32_t c = 0; c < numChannels; c++)
+      (*out)[i * numChannels + c] = in[(numPlanes == 1 ? 0 : c) * numOutFrames + i];
+  }
+  return true;
+}
+
 bool ReadWavFile(const std::string& filename, uint32_t expected_sample_rate, int expected_num_channels,
-                 std::vector<float>** data, unsigned* original_num_samples, std::vector<int>* file_end_offset,
-                 int align_samples, bool enable_debug) {
+                 std::shared_ptr<const std::vector<float>>* data, unsigned* original_num_samples,
+                 std::vector<int>* file_end_offset, int align_samples, bool enable_debug) {
   std::vector<std::string> files;
 
   const std::string kDelimiter = ";";
@@ -365,58 +938,57 @@ bool ReadWavFile(const std::string& filename, uint32_t expected_sample_rate, int
   }
 
   *original_num_samples = 0;
+  data->reset();
 
   int offset = 0;
-  std::vector<float>* ret = nullptr;
+  std::shared_ptr<std::vector<float>> ret;  // A copy, when the samples have to be concatenated or padded
   for (auto& file : files) {
-    CWaveFileRead* wave_file = nullptr;
-    auto cached_file = read_file_cache.find(file);
-    if (cached_file == read_file_cache.end()) {
-      wave_file = new CWaveFileRead(file);
-      read_file_cache.emplace(file, std::unique_ptr<CWaveFileRead>(wave_file));
-    } else {
-      wave_file = cached_file->second.get();
-    }
+    std::shared_ptr<const CWaveFileData> wave_file = CWaveFileCache::Global().Get(file);
 
-    if (wave_file->isValid() == false) {
+    if (!wave_file) {
       std::cerr << "Invalid wave file" << std::endl;
-      delete ret;
-      *data = nullptr;
+      data->reset();
       return false;
     }
 
     if (enable_debug) {
-      std::cout << "Total number of samples: " << wave_file->GetNumSamples() << std::endl;
-      std::cout << "Size in bytes: " << wave_file->GetRawPCMDataSizeInBytes() << std::endl;
-      std::cout << "Sample rate: " << wave_file->GetSampleRate() << std::endl;
-      std::cout << "Number of Channels : " << wave_file->GetWaveFormat().nChannels << std::endl;
-
-      auto bits_per_sample = wave_file->GetBitsPerSample();
-      std::cout << "Bits/sample: " << bits_per_sample << std::endl;
+      std::cout << "Total number of samples: " << wave_file->samples.size() << std::endl;
+      std::cout << "Size in bytes: " << wave_file->rawPCMSizeInBytes << std::endl;
+      std::cout << "Sample rate: " << wave_file->format.nSamplesPerSec << std::endl;
+      std::cout << "Number of Channels : " << wave_file->format.nChannels << std::endl;
+      std::cout << "Bits/sample: " << wave_file->format.wBitsPerSample << std::endl;
     }
 
-    if (wave_file->GetSampleRate() != expected_sample_rate) {
-      std::cerr << "Sample rate mismatch. Sample rate of file " << filename << ": " << wave_file->GetSampleRate()
-                << "v/s expected value: " << expected_sample_rate << std::endl;
-      delete ret;
-      *data = nullptr;
-      return false;
-    }
-    if (wave_file->GetWaveFormat().nChannels != expected_num_channels) {
-      std::cerr << "Channel count needs to be " << expected_num_channels << std::endl;
-      delete ret;
-      *data = nullptr;
-      return false;
+    // Convert the file to the expected format, if it is not already in it
+    std::shared_ptr<const std::vector<float>> samples(wave_file, &wave_file->samples);
+    if (wave_file->format.nSamplesPerSec != expected_sample_rate ||
+        wave_file->format.nChannels != expected_num_channels) {
+      std::shared_ptr<std::vector<float>> converted = std::make_shared<std::vector<float>>();
+      if (expected_num_channels <= 0 ||
+          !ConvertWaveData(*wave_file, expected_sample_rate, static_cast<uint32_t>(expected_num_channels),
+                           converted.get())) {
+        std::cerr << "Unable to convert " << file << " from " << wave_file->format.nSamplesPerSec << " Hz, "
+                  << wave_file->format.nChannels << " channels to " << expected_sample_rate << " Hz, "
+                  << expected_num_channels << " channels" << std::endl;
+        data->reset();
+        return false;
+      }
+      if (enable_debug) {
+        std::cout << "Converting to " << expected_sample_rate << " Hz, " << expected_num_channels
+                  << " channels: " << converted->size() << " samples" << std::endl;
+      }
+      samples = converted;
     }
+    const uint32_t file_num_samples = static_cast<uint32_t>(samples->size());
 
-    *original_num_samples += wave_file->GetNumSamples();
+    *original_num_samples += file_num_samples;
 
     int num_samples;
     if (align_samples != -1) {
-      uint32_t pad = align_samples - (wave_file->GetNumSamples() % align_samples);
-      num_samples = wave_file->GetNumSamples() + pad;
+      uint32_t pad = align_samples - (file_num_samples % align_samples);
+      num_samples = file_num_samples + pad;
     } else {
-      num_samples = wave_file->GetNumSamples();
+      num_samples = file_num_samples;
     }
 
     if (file_end_offset) {
@@ -425,18 +997,18 @@ bool ReadWavFile(const std::string& filename, uint32_t expected_sample_rate, int
     }
 
     if (files.size() > 1) {
-      // If using reset, ignore cache
       // Vector is not resized here, will be resized at end
-      auto local = wave_file->GetFloatVector();
-      if (!ret) {
-        ret = new std::vector<float>();
-        *data = ret;
-      }
-      ret->insert(ret->end(), local->begin(), local->end());
+      if (!ret) ret = std::make_shared<std::vector<float>>();
+      ret->insert(ret->end(), samples->begin(), samples->end());
+    } else if (static_cast<size_t>(num_samples) == samples->size()) {
+      // Share the cached or converted samples
+      *data = samples;
     } else {
-      *data = wave_file->GetFloatVector();
-      // Align if using multiple inputs
-      (*data)->resize(num_samples, 0.f);
+      // Align
+      ret = std::make_shared<std::vector<float>>();
+      ret->reserve(num_samples);
+      ret->assign(samples->begin(), samples->end());
+      ret->resize(num_samples, 0.f);
     }
   }
 
@@ -445,5 +1017,42 @@ bool ReadWavFile(const std::string& filename, uint32_t expected_sample_rate, int
     uint32_t pad = ret->size() % align_samples;
     if (pad) ret->resize(ret->size() + pad, 0.f);
   }
+  if (ret) *data = ret;
+  return true;
+}
+
+bool OpenWavFileStream(const std::string& filename, uint32_t expected_sample_rate, int expected_num_channels,
+                       std::unique_ptr<CWaveFileStream>* stream, bool enable_debug) {
+  std::unique_ptr<CWaveFileStream> wave_file(new CWaveFileStream(filename));
+
+  if (wave_file->isValid() == false) {
+    std::cerr << "Invalid wave file" << std::endl;
+    return false;
+  }
+
+  if (enable_debug) {
+    std::cout << "Total number of samples: " << wave_file->GetNumSamples() << std::endl;
+    std::cout << "Size in bytes: " << wave_file->GetRawPCMDataSizeInBytes() << std::endl;
+    std::cout << "Sample rate: " << wave_file->GetSampleRate() << std::endl;
+    std::cout << "Number of Channels : " << wave_file->GetNumChannels() << std::endl;
+    std::cout << "Bits/sample: " << wave_file->GetWaveFormat().wBitsPerSample << std::endl;
+  }
+
+  if (wave_file->GetSampleRate() != expected_sample_rate ||
+      wave_file->GetNumChannels() != static_cast<uint32_t>(expected_num_channels)) {
+    if (expected_num_channels <= 0 ||
+        !wave_file->SetOutputFormat(expected_sample_rate, static_cast<uint32_t>(expected_num_channels))) {
+      std::cerr << "Unable to convert " << filename << " from " << wave_file->GetSampleRate() << " Hz, "
+                << wave_file->GetNumChannels() << " channels to " << expected_sample_rate << " Hz, "
+                << expected_num_channels << " channels" << std::endl;
+      return false;
+    }
+    if (enable_debug) {
+      std::cout << "Converting to " << expected_sample_rate << " Hz, " << expected_num_channels
+                << " channels: " << wave_file->GetNumSamples() << " samples" << std::endl;
+    }
+  }
+
+  *stream = std::move(wave_file);
   return true;
 }
@@ -27,10 +27,14 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "pcmConvert.h"
 #include "wave.h"
 
 #define MAKEFOURCC(a, b, c, d) ((uint32_t)(((d) << 24) | ((c) << 16) | ((b) << 8) | (a)))
@@ -69,8 +73,10 @@ class CWaveFileRead {
   bool isValid() const { return validFile; }
   std::vector<float>* GetFloatVector();
 
+ public:
+  static const RiffChunk* FindChunk(const uint8_t* data, size_t sizeBytes, uint32_t fourcc);
+
  private:
-  const RiffChunk* FindChunk(const uint8_t* data, size_t sizeBytes, uint32_t fourcc);
   int readPCM(const char* szFileName);
 
  private:
@@ -83,6 +89,123 @@ class CWaveFileRead {
   std::unique_ptr<float[]> m_floatWaveDataAligned;
   waveFormat_ext m_WaveFormatEx;
   uint32_t m_NumAlignedSamples;
+  PCMConverter m_converter;
+};
+
+// A polyphase windowed-sinc sample rate converter for one channel of float samples.
+// The ratio of the rates is reduced to L/M, and output frame k is computed from the input frames around k*M/L with
+// the Kaiser-windowed sinc filter for the phase (k*M mod L) / L; the filter is band-limited to the lower of the two
+// Nyquist frequencies. Since every output frame depends only on its position, any range of the output can be
+// computed on its own, from the range of the input that GetInputRange() gives, which allows random access into a
+// file as well as streaming. Input frames beyond either end of the signal count as 0.
+class CWaveResampler {
+ public:
+  CWaveResampler(uint32_t inRate, uint32_t outRate);
+
+  uint32_t GetInputRate() const { return m_inRate; }
+  uint32_t GetOutputRate() const { return m_outRate; }
+  bool isValid() const { return m_L != 0; }
+
+  // The number of output frames made from a signal of numInFrames, i.e. ceil(numInFrames * L / M).
+  uint64_t GetNumOutputFrames(uint64_t numInFrames) const { return (numInFrames * m_L + m_M - 1) / m_M; }
+
+  // The input frames [*inStart, *inStart + *inCount) that the output frames [outStart, outStart + outCount) are
+  // made from. *inStart is negative at the start of the signal.
+  void GetInputRange(uint64_t outStart, uint32_t outCount, int64_t* inStart, uint32_t* inCount) const;
+
+  // Compute the output frames [outStart, outStart + outCount) from the input frames given by GetInputRange().
+  void Resample(const float* in, uint64_t outStart, uint32_t outCount, float* out) const;
+
+  // Compute the output frames [outStart, outStart + outCount) of a signal that is all in memory.
+  void Resample(const float* in, uint64_t numInFrames, uint64_t outStart, uint32_t outCount, float* out) const;
+
+  // Resample a signal that arrives in chunks, appending to out all the output frames that the input so far allows.
+  // Call Flush() at the end of the signal, to get the rest; this also readies the resampler for a new signal, as
+  // Reset() does.
+  void Process(const float* in, size_t numFrames, std::vector<float>* out);
+  void Flush(std::vector<float>* out);
+  void Reset();
+
+ private:
+  static const uint32_t kMaxPhases = 1024;  // Beyond this, phases are rounded to the nearest of kMaxPhases
+
+  uint32_t m_inRate, m_outRate;
+  uint64_t m_L = 0, m_M = 0;   // The output and input rates, divided by their GCD
+  uint32_t m_numPhases = 0;
+  uint32_t m_numTaps = 0;      // Per phase, a multiple of 4
+  std::vector<float> m_coeffs;  // (m_numPhases + 1) * m_numTaps
+  // Streaming state
+  std::vector<float> m_history;  // Input frames, starting at m_historyStart
+  int64_t m_historyStart = 0;
+  uint64_t m_numInFrames = 0;
+  uint64_t m_numOutFrames = 0;
+};
+
+// Streams the samples of a WAV file that is mapped into memory, converting only the windows that are asked for to
+// float, so that long inputs never have to be held in memory, either as PCM or as float.
+// As in CWaveFileRead, samples are counted over all channels, and multi-channel data is interleaved.
+class CWaveFileStream {
+ public:
+  explicit CWaveFileStream(std::string wavFile);
+  ~CWaveFileStream();
+  // The sample rate, channel count and number of samples are those of the output format, once it has been set.
+  uint32_t GetSampleRate() const { return m_resampler ? m_resampler->GetOutputRate() : m_WaveFormatEx.nSamplesPerSec; }
+  uint32_t GetNumChannels() const { return m_outChannels ? m_outChannels : m_WaveFormatEx.nChannels; }
+  uint32_t GetRawPCMDataSizeInBytes() const { return m_WaveDataSize; }
+  uint32_t GetNumSamples() const { return m_outChannels ? m_nNumOutSamples : m_nNumSamples; }
+  const waveFormat_ext& GetWaveFormat() const { return m_WaveFormatEx; }
+  bool isValid() const { return m_WaveData != nullptr; }
+
+  // Convert the samples to a different sample rate and/or number of channels as they are read. Channels can be
+  // averaged into mono, mono can be copied to every channel, or the number of channels can stay the same.
+  // Returns false if the channels cannot be converted.
+  bool SetOutputFormat(uint32_t sampleRate, uint32_t numChannels);
+
+  // Convert the samples [start, start + count) to float, in the output format; those beyond the end of the file are
+  // set to 0 (silence). Returns the number of samples that came from the file.
+  uint32_t ReadFloat(uint64_t start, uint32_t count, float* dst) const;
+
+  // Allocate the scratch space that ReadFloat() needs to convert up to maxCount samples at a time to the output
+  // format, so that reads of that size allocate no memory. Larger reads grow it. As this space is shared, reads of
+  // one stream must not overlap in time.
+  void Reserve(uint32_t maxCount) const;
+
+  // Convert the samples [start, start + count) to float into an internal window, which is reused by the next call.
+  const float* GetFloatWindow(uint64_t start, uint32_t count, uint32_t* numValid = nullptr);
+
+  // Convert the frames [start, start + count), each holding one sample per channel, to float, either deinterleaved
+  // into one plane per channel, or averaged over the channels into mono. Frames beyond the end of the file are set
+  // to 0. Returns the number of frames that came from the file. These read the file as it is, ignoring the output
+  // format.
+  uint32_t ReadFloatPlanar(uint64_t start, uint32_t count, float* const* planes) const;
+  uint32_t ReadFloatMono(uint64_t start, uint32_t count, float* dst) const;
+
+ private:
+  CWaveFileStream(const CWaveFileStream&) = delete;
+  CWaveFileStream& operator=(const CWaveFileStream&) = delete;
+  bool mapFile(const char* szFileName);
+  void unmapFile();
+  void readConvertedFrames(uint64_t start, uint32_t count, float* dst) const;
+  uint32_t numConvertedPlanes() const { return (m_outChannels == 1) ? 1 : m_WaveFormatEx.nChannels; }
+
+ private:
+  std::string m_wavFile;
+  const uint8_t* m_fileData = nullptr;  // The whole file, as mapped
+  size_t m_fileSize = 0;
+  void* m_fileHandle = nullptr;         // Windows file and mapping handles
+  void* m_mappingHandle = nullptr;
+  const uint8_t* m_WaveData = nullptr;  // The contents of the data chunk, within the mapping
+  uint32_t m_WaveDataSize = 0;
+  uint32_t m_nNumSamples = 0;
+  waveFormat_ext m_WaveFormatEx;
+  PCMConverter m_converter;
+  std::vector<float> m_window;
+  uint32_t m_outChannels = 0;  // 0 until the output format is set
+  uint32_t m_nNumOutSamples = 0;
+  std::unique_ptr<CWaveResampler> m_resampler;  // null if the sample rate stays the same
+  // Scratch space for the output format conversion, reused by every read
+  mutable std::vector<float> m_frameBuf, m_outBuf, m_inBuf;
+  mutable std::vector<float*> m_planePtrs;  // The shifted input, output and input planes, in that order
 };
 
 class CWaveFileWrite {
@@ -93,6 +216,9 @@ class CWaveFileWrite {
   bool initFile();
   // can be called 'n' times.
   bool writeChunk(const void* data, uint32_t len);
+  // Convert float samples, interleaved over all channels, to the format of the file and write them.
+  // Can be called 'n' times, and mixed with writeChunk().
+  bool writeFloat(const float* data, uint32_t numSamples);
   bool commitFile();
   uint32_t getWrittenCount() { return m_cumulativeCount; }
   std::string getFileName() { return m_wavFile; }
@@ -104,8 +230,80 @@ class CWaveFileWrite {
   uint32_t m_cumulativeCount = 0;
   waveFormat_ext wfx;
   bool m_commitDone = false;
+  PCMConverter m_converter;
+  std::vector<uint8_t> m_convertBuffer;
+};
+
+// The samples of a WAV file, converted to float, as they are kept by CWaveFileCache.
+struct CWaveFileData {
+  waveFormat_ext format;
+  uint32_t rawPCMSizeInBytes;
+  std::vector<float> samples;
+};
+
+struct WaveFileCacheStats {
+  uint64_t hits;       // Files that were found in the cache
+  uint64_t misses;     // Files that had to be read
+  uint64_t evictions;  // Files that were dropped to stay within the capacity
+  size_t numFiles;     // Files in the cache now
+  size_t sizeBytes;    // Bytes held by the cache now
+  size_t capacityBytes;
 };
 
+// A cache of decoded WAV files, bounded in bytes, that evicts the least recently used files first.
+// It may be shared by several threads. Files are read outside of the lock, so a slow read never holds up hits on
+// other files. The data is handed out through shared pointers, so that it stays valid for as long as it is used,
+// even after it has been evicted or invalidated.
+class CWaveFileCache {
+ public:
+  static const size_t kDefaultCapacityBytes = size_t(256) << 20;
+
+  explicit CWaveFileCache(size_t capacityBytes = kDefaultCapacityBytes);
+
+  // The cache used by ReadWavFile.
+  static CWaveFileCache& Global();
+
+  // Get a file from the cache, or read it into the cache. Returns nullptr if the file could not be read.
+  // A file larger than the capacity is read, but not kept.
+  std::shared_ptr<const CWaveFileData> Get(const std::string& filename);
+
+  // Drop a file, e.g. because it has changed on disk, so that it is read again the next time it is asked for.
+  void Invalidate(const std::string& filename);
+  void Clear();
+
+  // Change the capacity, evicting files as necessary.
+  void SetCapacity(size_t capacityBytes);
+
+  WaveFileCacheStats GetStats() const;
+
+ private:
+  struct Entry {
+    std::shared_ptr<const CWaveFileData> data;
+    size_t sizeBytes;
+    std::list<std::string>::iterator lru;
+  };
+
+  static size_t SizeOf(const CWaveFileData& data) { return sizeof(data) + data.samples.size() * sizeof(float); }
+  void evict();  // Call with m_mutex locked
+
+  mutable std::mutex m_mutex;
+  std::unordered_map<std::string, Entry> m_entries;
+  std::list<std::string> m_lru;  // Most recently used first
+  size_t m_capacityBytes;
+  size_t m_sizeBytes = 0;
+  uint64_t m_hits = 0;
+  uint64_t m_misses = 0;
+  uint64_t m_evictions = 0;
+};
+
+// Read one WAV file, or several separated by ';' and concatenated, through CWaveFileCache::Global().
+// Files are converted to the expected sample rate and number of channels, as CWaveFileStream::SetOutputFormat() does.
+// The samples are shared with the cache when no copy is needed to convert, concatenate or pad them, so they are
+// read-only.
 bool ReadWavFile(const std::string& filename, uint32_t expected_sample_rate, int expected_num_channels,
-                 std::vector<float>** data, unsigned* original_num_samples, std::vector<int>* file_end_offset,
-                 int align_samples = -1, bool enable_debug = false);
+                 std::shared_ptr<const std::vector<float>>* data, unsigned* original_num_samples,
+                 std::vector<int>* file_end_offset, int align_samples = -1, bool enable_debug = false);
+
+// Open a WAV file for streaming, converted to the expected sample rate and number of channels.
+bool OpenWavFileStream(const std::string& filename, uint32_t expected_sample_rate, int expected_num_channels,
+                       std::unique_ptr<CWaveFileStream>* stream, bool enable_debug = false);